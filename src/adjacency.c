@@ -0,0 +1,305 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "graph_library.h"
+
+// Construção do CSR a partir da edgelist em qualquer ordem: uma passada paralela conta
+// o grau de saída de cada vértice, a soma de prefixos (também paralela, em faixas de
+// vértices) dá os offsets e uma segunda passada sobre as arestas as espalha nas suas
+// posições. Com uma thread a ordem dos vizinhos é a da edgelist; com mais threads ela
+// depende do escalonamento, a não ser que sort_neighbors esteja ativo.
+
+#define ADJACENCY_SORT_CHUNK 256
+
+typedef enum
+{
+    ADJACENCY_COUNT,   // cursor[from]++ para cada aresta
+    ADJACENCY_SUM,     // soma dos graus de cada faixa de vértices
+    ADJACENCY_SCAN,    // offsets e cursores a partir da soma das faixas anteriores
+    ADJACENCY_SCATTER, // cada aresta na posição cursor[from]++
+    ADJACENCY_SORT,    // ordena os vizinhos de cada vértice
+} AdjacencyPhase;
+
+typedef struct
+{
+    uint32_t vertex_id;
+    double weight;
+} Neighbor;
+
+typedef struct
+{
+    Edge const *edges;
+    size_t V;
+    size_t E;
+    size_t num_threads;
+    AdjacencyPhase phase;
+    _Atomic uint64_t *cursor;
+    uint64_t *block_sums; // uma entrada por thread
+    AdjList adjlist;
+    atomic_size_t next_vertex; // ADJACENCY_SORT: próximo bloco de vértices
+    atomic_int invalid_edge;
+    atomic_int failed;
+} AdjacencyJob;
+
+void AdjList_init(AdjList *adjlist)
+{
+    adjlist->offsets = NULL;
+    adjlist->neighbors = NULL;
+    adjlist->weights = NULL;
+}
+
+void AdjList_free(AdjList *adjlist)
+{
+    free(adjlist->offsets);
+    free(adjlist->neighbors);
+    free(adjlist->weights);
+    AdjList_init(adjlist);
+}
+
+void AdjacencyOptions_init(AdjacencyOptions *options)
+{
+    options->sort_neighbors = 0;
+    options->free_edge_list = 0;
+    ThreadConfig_init(&options->threads);
+}
+
+static int __compare_neighbor(void const *a, void const *b)
+{
+    Neighbor const *x = a;
+    Neighbor const *y = b;
+    if (x->vertex_id != y->vertex_id)
+    {
+        return (x->vertex_id > y->vertex_id) - (x->vertex_id < y->vertex_id);
+    }
+    return (x->weight > y->weight) - (x->weight < y->weight);
+}
+
+static void __sort_neighbors(AdjacencyJob *job)
+{
+    AdjList const *adj = &job->adjlist;
+    Neighbor *buffer = NULL;
+    size_t buffer_size = 0;
+    for (;;)
+    {
+        size_t const begin = atomic_fetch_add(&job->next_vertex, ADJACENCY_SORT_CHUNK);
+        if (begin >= job->V)
+        {
+            break;
+        }
+        size_t const end = begin + ADJACENCY_SORT_CHUNK < job->V ? begin + ADJACENCY_SORT_CHUNK : job->V;
+        for (size_t v = begin; v < end; v++)
+        {
+            size_t const first = adj->offsets[v];
+            size_t const degree = adj->offsets[v + 1] - first;
+            if (degree < 2)
+            {
+                continue;
+            }
+            if (degree > buffer_size)
+            {
+                Neighbor *new_buffer = realloc(buffer, degree * sizeof(Neighbor));
+                if (new_buffer == NULL)
+                {
+                    atomic_store(&job->failed, 1);
+                    free(buffer);
+                    return;
+                }
+                buffer = new_buffer;
+                buffer_size = degree;
+            }
+            for (size_t n = 0; n < degree; n++)
+            {
+                buffer[n].vertex_id = adj->neighbors[first + n];
+                buffer[n].weight = adj->weights[first + n];
+            }
+            qsort(buffer, degree, sizeof(Neighbor), __compare_neighbor);
+            for (size_t n = 0; n < degree; n++)
+            {
+                adj->neighbors[first + n] = buffer[n].vertex_id;
+                adj->weights[first + n] = buffer[n].weight;
+            }
+        }
+    }
+    free(buffer);
+}
+
+static int __adjacency_worker(void *arg, size_t thread_id)
+{
+    AdjacencyJob *job = arg;
+    size_t const T = job->num_threads;
+    size_t const first_edge = thread_id * job->E / T;
+    size_t const last_edge = (thread_id + 1) * job->E / T;
+    size_t const first_vertex = thread_id * job->V / T;
+    size_t const last_vertex = (thread_id + 1) * job->V / T;
+    switch (job->phase)
+    {
+    case ADJACENCY_COUNT:
+        for (size_t i = first_edge; i < last_edge; i++)
+        {
+            Edge const *edge = &job->edges[i];
+            if (edge->from >= job->V || edge->to >= job->V)
+            {
+                atomic_store_explicit(&job->invalid_edge, 1, memory_order_relaxed);
+                continue;
+            }
+            atomic_fetch_add_explicit(&job->cursor[edge->from], 1, memory_order_relaxed);
+        }
+        break;
+    case ADJACENCY_SUM:
+    {
+        uint64_t sum = 0;
+        for (size_t v = first_vertex; v < last_vertex; v++)
+        {
+            sum += atomic_load_explicit(&job->cursor[v], memory_order_relaxed);
+        }
+        job->block_sums[thread_id] = sum;
+        break;
+    }
+    case ADJACENCY_SCAN:
+    {
+        uint64_t offset = job->block_sums[thread_id];
+        for (size_t v = first_vertex; v < last_vertex; v++)
+        {
+            uint64_t const degree = atomic_load_explicit(&job->cursor[v], memory_order_relaxed);
+            job->adjlist.offsets[v] = offset;
+            atomic_store_explicit(&job->cursor[v], offset, memory_order_relaxed);
+            offset += degree;
+        }
+        break;
+    }
+    case ADJACENCY_SCATTER:
+        for (size_t i = first_edge; i < last_edge; i++)
+        {
+            Edge const *edge = &job->edges[i];
+            uint64_t const position = atomic_fetch_add_explicit(&job->cursor[edge->from], 1, memory_order_relaxed);
+            job->adjlist.neighbors[position] = (uint32_t)edge->to;
+            job->adjlist.weights[position] = edge->weight;
+        }
+        break;
+    case ADJACENCY_SORT:
+        __sort_neighbors(job);
+        break;
+    }
+    return 0;
+}
+
+static void __run_adjacency_phase(AdjacencyJob *job, AdjacencyPhase phase, ThreadConfig const *threads)
+{
+    job->phase = phase;
+    run_threads(threads, job->num_threads, __adjacency_worker, job);
+}
+
+int Graph_create_adjacency_list_with_options(Graph *graph, AdjacencyOptions const *options)
+{
+    size_t const V = graph->V;
+    size_t const E = graph->E;
+    if (graph->edge_list.data == NULL && E > 0)
+    {
+        fprintf(stderr, "A edgelist está vazia, não é possível criar a lista de adjacência\n");
+        return 1;
+    }
+    if (V >= UINT32_MAX)
+    {
+        fprintf(stderr, "A lista de adjacência suporta no máximo %u vértices\n", UINT32_MAX - 1);
+        return 1;
+    }
+
+    int result = 1;
+    AdjacencyJob job = {.edges = graph->edge_list.data, .V = V, .E = E};
+    job.num_threads = options->threads.num_threads > 0 ? options->threads.num_threads : 1;
+    atomic_init(&job.next_vertex, 0);
+    atomic_init(&job.invalid_edge, 0);
+    atomic_init(&job.failed, 0);
+    AdjList_init(&job.adjlist);
+    job.cursor = calloc(V > 0 ? V : 1, sizeof(*job.cursor));
+    job.block_sums = malloc(job.num_threads * sizeof(uint64_t));
+    job.adjlist.offsets = malloc((V + 1) * sizeof(uint64_t));
+    job.adjlist.neighbors = malloc((E > 0 ? E : 1) * sizeof(uint32_t));
+    job.adjlist.weights = malloc((E > 0 ? E : 1) * sizeof(double));
+    if (job.cursor == NULL || job.block_sums == NULL || job.adjlist.offsets == NULL ||
+        job.adjlist.neighbors == NULL || job.adjlist.weights == NULL)
+    {
+        fprintf(stderr, "Falha na alocação da lista de adjacência\n");
+        goto clean_up;
+    }
+
+    __run_adjacency_phase(&job, ADJACENCY_COUNT, &options->threads);
+    if (atomic_load(&job.invalid_edge))
+    {
+        fprintf(stderr, "Erro: Vértice com índice inválido na edgelist.\n");
+        goto clean_up;
+    }
+    __run_adjacency_phase(&job, ADJACENCY_SUM, &options->threads);
+    uint64_t offset = 0;
+    for (size_t t = 0; t < job.num_threads; t++)
+    {
+        uint64_t const block_sum = job.block_sums[t];
+        job.block_sums[t] = offset;
+        offset += block_sum;
+    }
+    __run_adjacency_phase(&job, ADJACENCY_SCAN, &options->threads);
+    job.adjlist.offsets[V] = E;
+    __run_adjacency_phase(&job, ADJACENCY_SCATTER, &options->threads);
+    if (options->sort_neighbors)
+    {
+        __run_adjacency_phase(&job, ADJACENCY_SORT, &options->threads);
+        if (atomic_load(&job.failed))
+        {
+            fprintf(stderr, "Falha na alocação da lista de adjacência\n");
+            goto clean_up;
+        }
+    }
+
+    AdjList_free(&graph->adjacency_list);
+    graph->adjacency_list = job.adjlist;
+    AdjList_init(&job.adjlist);
+    if (options->free_edge_list)
+    {
+        VecEdge_free(&graph->edge_list);
+    }
+    result = 0;
+
+clean_up:
+    AdjList_free(&job.adjlist);
+    free(job.block_sums);
+    free(job.cursor);
+    return result;
+}
+
+int Graph_create_adjacency_list(Graph *graph)
+{
+    AdjacencyOptions options;
+    AdjacencyOptions_init(&options);
+    return Graph_create_adjacency_list_with_options(graph, &options);
+}
+
+int Graph_create_edgelist_from_adjacency(Graph *graph)
+{
+    VecEdge edge_list;
+    VecEdge_init(&edge_list);
+    if (VecEdge_reserve(&edge_list, graph->E) != 0)
+    {
+        fprintf(stderr, "Alocação da edgelist não foi bem sucessida");
+        return 1;
+    }
+    AdjList const *adj = &graph->adjacency_list;
+    for (size_t v = 0; adj->offsets != NULL && v < graph->V; v++)
+    {
+        for (uint64_t n = adj->offsets[v]; n < adj->offsets[v + 1]; n++)
+        {
+            Edge const edge = {.from = v, .to = adj->neighbors[n], .weight = adj->weights[n]};
+            VecEdge_push_back(&edge_list, edge);
+        }
+    }
+    if (edge_list.size != graph->E)
+    {
+        fprintf(stderr, "Número de edges incompatível com a lista de adjacência\n");
+        VecEdge_free(&edge_list);
+        return 1;
+    }
+    VecEdge_free(&graph->edge_list);
+    graph->edge_list = edge_list;
+    return 0;
+}
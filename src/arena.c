@@ -0,0 +1,146 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+struct ArenaBlock
+{
+    ArenaBlock *next;
+    size_t size; // bytes utilizáveis depois do cabeçalho
+    size_t used;
+};
+
+// o cabeçalho ocupa uma linha de cache inteira para que os dados fiquem alinhados
+#define ARENA_HEADER_SIZE ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT)
+
+static size_t __round_up(size_t bytes)
+{
+    return (bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+}
+
+static char *__block_data(ArenaBlock *block)
+{
+    return (char *)block + ARENA_HEADER_SIZE;
+}
+
+static ArenaBlock *__new_block(size_t size)
+{
+    ArenaBlock *block = aligned_alloc(ARENA_ALIGNMENT, ARENA_HEADER_SIZE + size);
+    if (block == NULL)
+    {
+        fprintf(stderr, "Falha na alocação de um bloco de %zu bytes da arena\n", size);
+        return NULL;
+    }
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+void Arena_init(Arena *arena, size_t block_size)
+{
+    arena->head = NULL;
+    arena->block_size = block_size > 0 ? __round_up(block_size) : ARENA_DEFAULT_BLOCK_SIZE;
+    arena->last = NULL;
+}
+
+void *Arena_alloc(Arena *arena, size_t bytes)
+{
+    size_t const rounded = __round_up(bytes > 0 ? bytes : 1);
+    if (rounded < bytes)
+    {
+        fprintf(stderr, "Alocação de %zu bytes grande demais para a arena\n", bytes);
+        return NULL;
+    }
+    ArenaBlock *block = arena->head;
+    if (block == NULL || block->size - block->used < rounded)
+    {
+        block = __new_block(rounded > arena->block_size ? rounded : arena->block_size);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        block->next = arena->head;
+        arena->head = block;
+    }
+    void *ptr = __block_data(block) + block->used;
+    block->used += rounded;
+    arena->last = ptr;
+    return ptr;
+}
+
+void *Arena_calloc(Arena *arena, size_t bytes)
+{
+    void *ptr = Arena_alloc(arena, bytes);
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, bytes);
+    }
+    return ptr;
+}
+
+void *Arena_realloc(Arena *arena, void *ptr, size_t old_bytes, size_t new_bytes)
+{
+    if (ptr == NULL)
+    {
+        return Arena_alloc(arena, new_bytes);
+    }
+    if (new_bytes <= old_bytes)
+    {
+        return ptr;
+    }
+    if (ptr == arena->last)
+    {
+        ArenaBlock *block = arena->head;
+        size_t const offset = (size_t)((char *)ptr - __block_data(block));
+        size_t const rounded = __round_up(new_bytes);
+        if (rounded >= new_bytes && rounded <= block->size - offset)
+        {
+            block->used = offset + rounded;
+            return ptr;
+        }
+    }
+    void *new_ptr = Arena_alloc(arena, new_bytes);
+    if (new_ptr != NULL)
+    {
+        memcpy(new_ptr, ptr, old_bytes);
+    }
+    return new_ptr;
+}
+
+void Arena_reset(Arena *arena)
+{
+    arena->last = NULL;
+    if (arena->head == NULL)
+    {
+        return;
+    }
+    if (arena->head->next == NULL)
+    {
+        arena->head->used = 0;
+        return;
+    }
+    // a rodada não coube em um bloco: a próxima terá um só, com a soma dos tamanhos
+    size_t total = 0;
+    for (ArenaBlock *block = arena->head; block != NULL; block = block->next)
+    {
+        total += block->size;
+    }
+    Arena_free(arena);
+    arena->head = __new_block(total);
+}
+
+void Arena_free(Arena *arena)
+{
+    ArenaBlock *block = arena->head;
+    while (block != NULL)
+    {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->last = NULL;
+}
@@ -0,0 +1,290 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "benchmark.h"
+
+static char const *const PHASE_NAMES[PHASE_COUNT] = {"load", "csr", "distribute", "compute", "wait", "gather",
+                                                     "reduce"};
+
+void PhaseTimes_init(PhaseTimes *times)
+{
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        times->seconds[phase] = 0.0;
+    }
+}
+
+char const *BenchmarkPhase_name(BenchmarkPhase phase)
+{
+    return phase < PHASE_COUNT ? PHASE_NAMES[phase] : "?";
+}
+
+static double __total(double const *seconds)
+{
+    double total = 0.0;
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        if (phase != PHASE_WAIT)
+        {
+            total += seconds[phase];
+        }
+    }
+    return total;
+}
+
+double PhaseTimes_total(PhaseTimes const *times)
+{
+    return __total(times->seconds);
+}
+
+void BenchmarkOptions_init(BenchmarkOptions *options)
+{
+    options->warmup = 1;
+    options->repetitions = 5;
+    options->output = NULL;
+    options->format = BENCHMARK_JSON;
+}
+
+int BenchmarkReport_init(BenchmarkReport *report, size_t repetitions, MPI_Comm comm)
+{
+    MPI_Comm_rank(comm, &report->rank);
+    MPI_Comm_size(comm, &report->nprocs);
+    report->repetitions = repetitions;
+    report->recorded = 0;
+    report->times = NULL;
+    report->efficiencies = NULL;
+    if (report->rank != 0)
+    {
+        return 0;
+    }
+    report->times = malloc(repetitions * (size_t)report->nprocs * PHASE_COUNT * sizeof(double));
+    report->efficiencies = malloc(repetitions * sizeof(double));
+    if ((report->times == NULL || report->efficiencies == NULL) && repetitions > 0)
+    {
+        fprintf(stderr, "Falha na alocação do relatório do benchmark\n");
+        BenchmarkReport_free(report);
+        return 1;
+    }
+    return 0;
+}
+
+void BenchmarkReport_record(BenchmarkReport *report, PhaseTimes const *times, double efficiency, MPI_Comm comm)
+{
+    if (report->recorded >= report->repetitions)
+    {
+        return;
+    }
+    double *destination = report->rank == 0
+                              ? report->times + report->recorded * (size_t)report->nprocs * PHASE_COUNT
+                              : NULL;
+    MPI_Gather(times->seconds, PHASE_COUNT, MPI_DOUBLE, destination, PHASE_COUNT, MPI_DOUBLE, 0, comm);
+    if (report->rank == 0)
+    {
+        report->efficiencies[report->recorded] = efficiency;
+    }
+    report->recorded++;
+}
+
+void BenchmarkReport_free(BenchmarkReport *report)
+{
+    free(report->times);
+    free(report->efficiencies);
+    report->times = NULL;
+    report->efficiencies = NULL;
+}
+
+static double const *__rank_times(BenchmarkReport const *report, size_t repetition, int rank)
+{
+    return report->times + (repetition * (size_t)report->nprocs + (size_t)rank) * PHASE_COUNT;
+}
+
+// tempo da fase na repetição: o do processo mais lento; phase == PHASE_COUNT é o total
+static double __slowest(BenchmarkReport const *report, size_t repetition, int phase)
+{
+    double slowest = 0.0;
+    for (int p = 0; p < report->nprocs; p++)
+    {
+        double const *seconds = __rank_times(report, repetition, p);
+        double const value = phase == PHASE_COUNT ? __total(seconds) : seconds[phase];
+        slowest = value > slowest ? value : slowest;
+    }
+    return slowest;
+}
+
+static int __compare_doubles(void const *a, void const *b)
+{
+    double const x = *(double const *)a;
+    double const y = *(double const *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct
+{
+    double min;
+    double median;
+    double mean;
+    double max;
+} PhaseSummary;
+
+static void __summarize(BenchmarkReport const *report, int phase, double *scratch, PhaseSummary *summary)
+{
+    size_t const n = report->recorded;
+    double sum = 0.0;
+    for (size_t r = 0; r < n; r++)
+    {
+        scratch[r] = __slowest(report, r, phase);
+        sum += scratch[r];
+    }
+    qsort(scratch, n, sizeof(double), __compare_doubles);
+    summary->min = n > 0 ? scratch[0] : 0.0;
+    summary->max = n > 0 ? scratch[n - 1] : 0.0;
+    summary->median = n == 0 ? 0.0 : n % 2 == 1 ? scratch[n / 2] : 0.5 * (scratch[n / 2 - 1] + scratch[n / 2]);
+    summary->mean = n > 0 ? sum / (double)n : 0.0;
+}
+
+// aspas, barras invertidas e caracteres de controle precisam de escape em JSON
+static void __write_json_string(FILE *file, char const *text)
+{
+    fputc('"', file);
+    for (char const *c = text; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fprintf(file, "\\%c", *c);
+        }
+        else if ((unsigned char)*c < 0x20)
+        {
+            fprintf(file, "\\u%04x", (unsigned)(unsigned char)*c);
+        }
+        else
+        {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+static void __write_json(FILE *file, BenchmarkReport const *report, BenchmarkInfo const *info,
+                         BenchmarkOptions const *options, double *scratch)
+{
+    fprintf(file, "{\n  \"graph\": ");
+    __write_json_string(file, info->graph);
+    fprintf(file, ",\n  \"V\": %zu,\n  \"E\": %zu,\n  \"seed\": %llu,\n  \"engine\": ", info->V, info->E,
+            (unsigned long long)info->seed);
+    __write_json_string(file, info->engine);
+    fprintf(file, ",\n  \"backend\": ");
+    __write_json_string(file, info->backend);
+    fprintf(file, ",\n  \"threads\": %zu,\n  \"processes\": %d,\n  \"warmup\": %zu,\n  \"repetitions\": %zu,\n",
+            info->num_threads, info->nprocs, options->warmup, report->recorded);
+
+    fprintf(file, "  \"summary\": {\n");
+    for (int phase = 0; phase <= PHASE_COUNT; phase++)
+    {
+        PhaseSummary summary;
+        __summarize(report, phase, scratch, &summary);
+        fprintf(file, "    \"%s\": {\"min\": %.9f, \"median\": %.9f, \"mean\": %.9f, \"max\": %.9f}%s\n",
+                phase == PHASE_COUNT ? "total" : PHASE_NAMES[phase], summary.min, summary.median, summary.mean,
+                summary.max, phase < PHASE_COUNT ? "," : "");
+    }
+    fprintf(file, "  },\n  \"runs\": [\n");
+    for (size_t r = 0; r < report->recorded; r++)
+    {
+        fprintf(file, "    {\"repetition\": %zu, \"efficiency\": %.10f, \"ranks\": [\n", r, report->efficiencies[r]);
+        for (int p = 0; p < report->nprocs; p++)
+        {
+            double const *seconds = __rank_times(report, r, p);
+            fprintf(file, "      {\"rank\": %d", p);
+            for (int phase = 0; phase < PHASE_COUNT; phase++)
+            {
+                fprintf(file, ", \"%s\": %.9f", PHASE_NAMES[phase], seconds[phase]);
+            }
+            fprintf(file, ", \"total\": %.9f}%s\n", __total(seconds), p + 1 < report->nprocs ? "," : "");
+        }
+        fprintf(file, "    ]}%s\n", r + 1 < report->recorded ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+// campo CSV entre aspas, com as aspas internas duplicadas (RFC 4180)
+static void __write_csv_field(FILE *file, char const *text)
+{
+    fputc('"', file);
+    for (char const *c = text; *c != '\0'; c++)
+    {
+        if (*c == '"')
+        {
+            fputc('"', file);
+        }
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+static void __write_csv(FILE *file, BenchmarkReport const *report, BenchmarkInfo const *info)
+{
+    fprintf(file, "graph,V,E,seed,engine,backend,threads,processes,repetition,rank");
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        fprintf(file, ",%s", PHASE_NAMES[phase]);
+    }
+    fprintf(file, ",total,efficiency\n");
+    for (size_t r = 0; r < report->recorded; r++)
+    {
+        for (int p = 0; p < report->nprocs; p++)
+        {
+            double const *seconds = __rank_times(report, r, p);
+            __write_csv_field(file, info->graph);
+            fprintf(file, ",%zu,%zu,%llu,%s,%s,%zu,%d,%zu,%d", info->V, info->E,
+                    (unsigned long long)info->seed, info->engine, info->backend, info->num_threads, info->nprocs,
+                    r, p);
+            for (int phase = 0; phase < PHASE_COUNT; phase++)
+            {
+                fprintf(file, ",%.9f", seconds[phase]);
+            }
+            fprintf(file, ",%.9f,%.10f\n", __total(seconds), report->efficiencies[r]);
+        }
+    }
+}
+
+int BenchmarkReport_write(BenchmarkReport const *report, BenchmarkInfo const *info, BenchmarkOptions const *options)
+{
+    double *scratch = malloc((report->recorded > 0 ? report->recorded : 1) * sizeof(double));
+    if (scratch == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do resumo do benchmark\n");
+        return 1;
+    }
+    FILE *file = options->output != NULL ? fopen(options->output, "w") : stdout;
+    if (file == NULL)
+    {
+        fprintf(stderr, "Não foi possível abrir '%s' para escrita\n", options->output);
+        free(scratch);
+        return 1;
+    }
+    if (options->format == BENCHMARK_CSV)
+    {
+        __write_csv(file, report, info);
+    }
+    else
+    {
+        __write_json(file, report, info, options, scratch);
+    }
+    int status = 0;
+    if (file != stdout)
+    {
+        status = fclose(file) != 0;
+        // com o relatório em arquivo, a saída padrão fica com um resumo legível
+        for (int phase = 0; phase <= PHASE_COUNT; phase++)
+        {
+            PhaseSummary summary;
+            __summarize(report, phase, scratch, &summary);
+            printf("%-10s median %.6f s  min %.6f s  max %.6f s \n",
+                   phase == PHASE_COUNT ? "total" : PHASE_NAMES[phase], summary.median, summary.min, summary.max);
+        }
+    }
+    free(scratch);
+    return status;
+}
@@ -0,0 +1,334 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "graph_library.h"
+
+// Layout do arquivo: cabeçalho em [0, CHECKPOINT_DATA_OFFSET) e duas áreas de V×V doubles,
+// cada uma com as linhas na ordem global. Uma gravação vai sempre para a área que o
+// cabeçalho não aponta; só depois que todos os processos concluíram a escrita (e do
+// MPI_File_sync) o processo 0 reescreve o cabeçalho. Uma falha no meio de uma gravação
+// deixa o checkpoint anterior intacto.
+//
+// A decisão de gravar é tomada pelo processo 0 a cada CHECKPOINT_POLL iterações e
+// transmitida com um MPI_Bcast de um inteiro, para que o intervalo em segundos não dependa
+// do relógio de cada processo. A faixa é copiada para snapshot e escrita com
+// MPI_File_iwrite_at enquanto o cálculo continua; a confirmação acontece em uma consulta
+// seguinte, quando a escrita do processo 0 terminou (ou antes da próxima gravação).
+
+#define CHECKPOINT_MAGIC "MYGRCKP"
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_DATA_OFFSET 4096
+#define CHECKPOINT_POLL 16
+
+enum
+{
+    CHECKPOINT_COMMIT = 1, // confirma a gravação pendente no cabeçalho
+    CHECKPOINT_WRITE = 2,  // inicia uma nova gravação
+};
+
+typedef struct
+{
+    char magic[8];
+    uint64_t version;
+    uint64_t V;
+    uint64_t k;    // próxima iteração: as iterações 0..k-1 estão aplicadas
+    uint64_t area; // área com as distâncias
+} CheckpointHeader;
+
+void CheckpointOptions_init(CheckpointOptions *options)
+{
+    options->path = NULL;
+    options->interval_iterations = 0;
+    options->interval_seconds = 600.0;
+    options->resume = 0;
+}
+
+static MPI_Offset __row_offset(Checkpoint const *checkpoint, int area, size_t row)
+{
+    MPI_Offset const V = (MPI_Offset)checkpoint->V;
+    return CHECKPOINT_DATA_OFFSET + ((MPI_Offset)area * V + (MPI_Offset)row) * V * (MPI_Offset)sizeof(double);
+}
+
+static void __free_checkpoint(Checkpoint *checkpoint)
+{
+    free(checkpoint->run_first);
+    free(checkpoint->run_row);
+    free(checkpoint->run_rows);
+    free(checkpoint->snapshot);
+    free(checkpoint->requests);
+    checkpoint->run_first = NULL;
+    checkpoint->run_row = NULL;
+    checkpoint->run_rows = NULL;
+    checkpoint->snapshot = NULL;
+    checkpoint->requests = NULL;
+    if (checkpoint->row_type != MPI_DATATYPE_NULL)
+    {
+        MPI_Type_free(&checkpoint->row_type);
+    }
+    if (checkpoint->file != MPI_FILE_NULL)
+    {
+        MPI_File_close(&checkpoint->file);
+    }
+}
+
+// lê o cabeçalho no processo 0 e o transmite; area = -1 se não houver checkpoint válido
+static int __read_header(Checkpoint *checkpoint, size_t *first_k, int *area)
+{
+    uint64_t values[3] = {0, 0, 0}; // status (0 válido, 1 ausente, 2 inválido), k, área
+    if (checkpoint->rank == 0)
+    {
+        MPI_Offset file_size = 0;
+        CheckpointHeader header;
+        MPI_File_get_size(checkpoint->file, &file_size);
+        values[0] = 1;
+        if ((size_t)file_size >= sizeof(header) &&
+            MPI_File_read_at(checkpoint->file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE) ==
+                MPI_SUCCESS)
+        {
+            if (memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+                header.version != CHECKPOINT_VERSION)
+            {
+                fprintf(stderr, "'%s' não é um checkpoint válido\n", checkpoint->options.path);
+                values[0] = 2;
+            }
+            else if (header.V != checkpoint->V || header.k > header.V || header.area > 1 ||
+                     (MPI_Offset)file_size < __row_offset(checkpoint, (int)header.area, checkpoint->V))
+            {
+                fprintf(stderr, "O checkpoint '%s' é de outro grafo (V = %llu) ou está incompleto\n",
+                        checkpoint->options.path, (unsigned long long)header.V);
+                values[0] = 2;
+            }
+            else
+            {
+                values[0] = 0;
+                values[1] = header.k;
+                values[2] = header.area;
+            }
+        }
+    }
+    MPI_Bcast(values, 3, MPI_UINT64_T, 0, checkpoint->comm);
+    if (values[0] == 2)
+    {
+        return 1;
+    }
+    if (values[0] == 1 && checkpoint->rank == 0)
+    {
+        fprintf(stderr, "Nenhum checkpoint em '%s', começando da iteração 0\n", checkpoint->options.path);
+    }
+    *first_k = values[0] == 0 ? values[1] : 0;
+    *area = values[0] == 0 ? (int)values[2] : -1;
+    return 0;
+}
+
+int Checkpoint_open(Checkpoint *checkpoint, CheckpointOptions const *options, MatrixDouble *strip,
+                    RowPartition const *partition, int rank, MPI_Comm comm, size_t *first_k)
+{
+    memset(checkpoint, 0, sizeof(*checkpoint));
+    checkpoint->options = *options;
+    checkpoint->comm = comm;
+    checkpoint->rank = rank;
+    checkpoint->file = MPI_FILE_NULL;
+    checkpoint->row_type = MPI_DATATYPE_NULL;
+    checkpoint->V = strip->ncols;
+    checkpoint->nrows = strip->nrows;
+    checkpoint->committed_area = -1;
+    *first_k = 0;
+
+    size_t const nrows = strip->nrows;
+    size_t const V = strip->ncols;
+    int local_ok = 1;
+    checkpoint->run_first = malloc((nrows > 0 ? nrows : 1) * sizeof(size_t));
+    checkpoint->run_row = malloc((nrows > 0 ? nrows : 1) * sizeof(size_t));
+    checkpoint->run_rows = malloc((nrows > 0 ? nrows : 1) * sizeof(size_t));
+    checkpoint->requests = malloc((nrows > 0 ? nrows : 1) * sizeof(MPI_Request));
+    checkpoint->snapshot = malloc((nrows * V > 0 ? nrows * V : 1) * sizeof(double));
+    if (checkpoint->run_first == NULL || checkpoint->run_row == NULL || checkpoint->run_rows == NULL ||
+        checkpoint->requests == NULL || checkpoint->snapshot == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do buffer de checkpoint no processo %d\n", rank);
+        local_ok = 0;
+    }
+    else
+    {
+        // linhas locais consecutivas também no arquivo são escritas com uma única chamada
+        for (size_t i = 0; i < nrows; i++)
+        {
+            size_t const row = RowPartition_global_index(partition, rank, i);
+            size_t const runs = checkpoint->num_runs;
+            if (runs > 0 && checkpoint->run_row[runs - 1] + checkpoint->run_rows[runs - 1] == row &&
+                checkpoint->run_rows[runs - 1] < INT32_MAX)
+            {
+                checkpoint->run_rows[runs - 1]++;
+            }
+            else
+            {
+                checkpoint->run_first[runs] = i;
+                checkpoint->run_row[runs] = row;
+                checkpoint->run_rows[runs] = 1;
+                checkpoint->num_runs++;
+            }
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &local_ok, 1, MPI_INT, MPI_MIN, comm);
+    if (!local_ok)
+    {
+        __free_checkpoint(checkpoint);
+        return 1;
+    }
+
+    MPI_Type_contiguous((int)V, MPI_DOUBLE, &checkpoint->row_type);
+    MPI_Type_commit(&checkpoint->row_type);
+    if (MPI_File_open(comm, options->path, MPI_MODE_CREATE | MPI_MODE_RDWR, MPI_INFO_NULL, &checkpoint->file) !=
+        MPI_SUCCESS)
+    {
+        fprintf(stderr, "O arquivo de checkpoint '%s' não conseguiu ser aberto\n", options->path);
+        checkpoint->file = MPI_FILE_NULL;
+        __free_checkpoint(checkpoint);
+        return 1;
+    }
+
+    if (!options->resume)
+    {
+        // um checkpoint antigo no mesmo arquivo não pode ser confundido com o desta execução
+        MPI_File_set_size(checkpoint->file, 0);
+    }
+    else
+    {
+        int area;
+        if (__read_header(checkpoint, first_k, &area) != 0)
+        {
+            __free_checkpoint(checkpoint);
+            return 1;
+        }
+        if (area >= 0)
+        {
+            for (size_t run = 0; run < checkpoint->num_runs && local_ok; run++)
+            {
+                local_ok = MPI_File_read_at(checkpoint->file, __row_offset(checkpoint, area, checkpoint->run_row[run]),
+                                            strip->data + checkpoint->run_first[run] * V,
+                                            (int)checkpoint->run_rows[run], checkpoint->row_type,
+                                            MPI_STATUS_IGNORE) == MPI_SUCCESS;
+            }
+            MPI_Allreduce(MPI_IN_PLACE, &local_ok, 1, MPI_INT, MPI_MIN, comm);
+            if (!local_ok)
+            {
+                fprintf(stderr, "Falha ao ler o checkpoint '%s' no processo %d\n", options->path, rank);
+                __free_checkpoint(checkpoint);
+                return 1;
+            }
+            checkpoint->committed_area = area;
+            if (rank == 0)
+            {
+                fprintf(stderr, "Retomando de '%s' na iteração %zu de %zu\n", options->path, *first_k, V);
+            }
+        }
+    }
+    checkpoint->last_k = *first_k;
+    checkpoint->last_time = MPI_Wtime();
+    return 0;
+}
+
+static void __commit(Checkpoint *checkpoint)
+{
+    int failed = MPI_Waitall((int)checkpoint->num_runs, checkpoint->requests, MPI_STATUSES_IGNORE) != MPI_SUCCESS;
+    MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, checkpoint->comm);
+    failed |= MPI_File_sync(checkpoint->file) != MPI_SUCCESS;
+    if (checkpoint->rank == 0 && !failed)
+    {
+        CheckpointHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+        header.version = CHECKPOINT_VERSION;
+        header.V = checkpoint->V;
+        header.k = checkpoint->pending_k;
+        header.area = (uint64_t)checkpoint->pending_area;
+        failed = MPI_File_write_at(checkpoint->file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE) !=
+                 MPI_SUCCESS;
+    }
+    failed |= MPI_File_sync(checkpoint->file) != MPI_SUCCESS;
+    if (failed)
+    {
+        fprintf(stderr, "Falha na gravação do checkpoint '%s' no processo %d\n", checkpoint->options.path,
+                checkpoint->rank);
+        MPI_Abort(checkpoint->comm, 1);
+    }
+    checkpoint->committed_area = checkpoint->pending_area;
+    checkpoint->pending = 0;
+}
+
+static void __start_write(Checkpoint *checkpoint, MatrixDouble const *strip, size_t k)
+{
+    size_t const V = checkpoint->V;
+    int const area = checkpoint->committed_area == 0 ? 1 : 0;
+    memcpy(checkpoint->snapshot, strip->data, checkpoint->nrows * V * sizeof(double));
+    for (size_t run = 0; run < checkpoint->num_runs; run++)
+    {
+        if (MPI_File_iwrite_at(checkpoint->file, __row_offset(checkpoint, area, checkpoint->run_row[run]),
+                               checkpoint->snapshot + checkpoint->run_first[run] * V, (int)checkpoint->run_rows[run],
+                               checkpoint->row_type, &checkpoint->requests[run]) != MPI_SUCCESS)
+        {
+            fprintf(stderr, "Falha na gravação do checkpoint '%s' no processo %d\n", checkpoint->options.path,
+                    checkpoint->rank);
+            MPI_Abort(checkpoint->comm, 1);
+        }
+    }
+    checkpoint->pending = 1;
+    checkpoint->pending_k = k;
+    checkpoint->pending_area = area;
+    checkpoint->last_k = k;
+    checkpoint->last_time = MPI_Wtime();
+    checkpoint->num_written++;
+}
+
+void Checkpoint_step(Checkpoint *checkpoint, MatrixDouble const *strip, size_t k)
+{
+    CheckpointOptions const *options = &checkpoint->options;
+    size_t const poll = options->interval_iterations > 0 && options->interval_iterations < CHECKPOINT_POLL
+                            ? options->interval_iterations
+                            : CHECKPOINT_POLL;
+    if (k % poll != 0)
+    {
+        return;
+    }
+    double const start = MPI_Wtime();
+    int action = 0;
+    if (checkpoint->rank == 0)
+    {
+        int done = 0;
+        if (checkpoint->pending &&
+            MPI_Testall((int)checkpoint->num_runs, checkpoint->requests, &done, MPI_STATUSES_IGNORE) == MPI_SUCCESS &&
+            done)
+        {
+            action |= CHECKPOINT_COMMIT;
+        }
+        if (k > checkpoint->last_k &&
+            ((options->interval_iterations > 0 && k - checkpoint->last_k >= options->interval_iterations) ||
+             (options->interval_seconds > 0.0 && start - checkpoint->last_time >= options->interval_seconds)))
+        {
+            action |= CHECKPOINT_WRITE;
+        }
+    }
+    MPI_Bcast(&action, 1, MPI_INT, 0, checkpoint->comm);
+    if (action != 0 && checkpoint->pending)
+    {
+        __commit(checkpoint);
+    }
+    if (action & CHECKPOINT_WRITE)
+    {
+        __start_write(checkpoint, strip, k);
+    }
+    checkpoint->write_time += MPI_Wtime() - start;
+}
+
+int Checkpoint_close(Checkpoint *checkpoint)
+{
+    if (checkpoint->pending)
+    {
+        __commit(checkpoint);
+    }
+    __free_checkpoint(checkpoint);
+    return 0;
+}
@@ -1,9 +1,38 @@
 #include "data_structures.h"
 #include <graph_library.h>
 #include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
 
 IMPLEMENT_VECTOR_INTERFACE(VertexWithPriority, VecVertexWithPriority)
 IMPLEMENT_VECTOR_INTERFACE(size_t, VecSizeT)
+IMPLEMENT_ARENA_VECTOR_INTERFACE(size_t, ArenaVecSizeT)
+
+void *matrix_alloc(size_t bytes, MatrixAllocation allocation)
+{
+    if (allocation == MATRIX_ALLOC_DEFAULT)
+    {
+        return malloc(bytes);
+    }
+    // aligned_alloc exige um tamanho múltiplo do alinhamento
+    size_t const alignment = allocation == MATRIX_ALLOC_HUGE_PAGES && bytes >= MATRIX_HUGE_PAGE_SIZE
+                                 ? MATRIX_HUGE_PAGE_SIZE
+                                 : 64;
+    size_t const rounded = (bytes + alignment - 1) / alignment * alignment;
+    if (rounded < bytes)
+    {
+        return NULL;
+    }
+    void *data = aligned_alloc(alignment, rounded);
+#ifdef MADV_HUGEPAGE
+    if (data != NULL && alignment == MATRIX_HUGE_PAGE_SIZE)
+    {
+        // apenas um pedido: sem páginas enormes transparentes a matriz fica em páginas comuns
+        madvise(data, rounded, MADV_HUGEPAGE);
+    }
+#endif
+    return data;
+}
 
 size_t __left(size_t index)
 {
@@ -65,6 +94,15 @@ void MinHeap_free(MinHeap *heap)
     VecVertexWithPriority_free(&heap->data);
     VecSizeT_free(&heap->index_map);
 }
+// esvazia o heap mantendo a memória alocada para reutilização
+void MinHeap_clear(MinHeap *heap)
+{
+    for (size_t i = 0; i < VecVertexWithPriority_size(&heap->data); i++)
+    {
+        VecSizeT_set(&heap->index_map, VecVertexWithPriority_get(&heap->data, i).vertex_id, SIZE_MAX);
+    }
+    VecVertexWithPriority_resize(&heap->data, 0);
+}
 int MinHeap_is_empty(MinHeap const *heap)
 {
     return VecVertexWithPriority_is_empty(&heap->data);
@@ -77,9 +115,16 @@ void MinHeap_add(MinHeap *heap, size_t vertex_id, double distance)
     size_t index = VecVertexWithPriority_size(&heap->data) - 1;
     
     // o map de índices deve ser atualizado para incluir o novo vértice
-    // ele expande conforme necessário com elementos nulos (SIZE_MAX)
-    while (VecSizeT_size(&heap->index_map) <= vertex_id) {
-        VecSizeT_push_back(&heap->index_map, SIZE_MAX); 
+    // ele expande de uma vez, com folga, preenchendo com elementos nulos (SIZE_MAX)
+    size_t const old_size = VecSizeT_size(&heap->index_map);
+    if (old_size <= vertex_id)
+    {
+        size_t const new_size = vertex_id + 1 > 2 * old_size ? vertex_id + 1 : 2 * old_size;
+        VecSizeT_resize(&heap->index_map, new_size);
+        for (size_t i = old_size; i < new_size; i++)
+        {
+            VecSizeT_set(&heap->index_map, i, SIZE_MAX);
+        }
     }
     VecSizeT_set(&heap->index_map, vertex_id, index);
     
@@ -128,4 +173,398 @@ void MinHeap_decrease_key(MinHeap *heap, size_t vertex_id, double new_distance)
         __exchange(index, __parent(index), heap);
         index = __parent(index);
     }
-}
\ No newline at end of file
+}
+
+void DaryHeap_init(DaryHeap *heap, size_t arity, int indexed)
+{
+    heap->arity = arity >= 2 ? arity : 2;
+    heap->size = 0;
+    heap->capacity = 0;
+    heap->keys = NULL;
+    heap->ids = NULL;
+    heap->buffer = NULL;
+    heap->position = NULL;
+    heap->num_vertices = indexed ? 0 : SIZE_MAX; // SIZE_MAX: sem mapa de posições
+}
+
+static int __dary_grow(DaryHeap *heap, size_t capacity)
+{
+    // keys começa arity - 1 posições depois do início da alocação alinhada, de forma
+    // que o primeiro filho de cada nó (arity * i + 1) caia em um múltiplo de arity
+    size_t const offset = heap->arity - 1;
+    size_t const bytes = ((capacity + offset) * sizeof(double) + 63) / 64 * 64;
+    void *buffer = aligned_alloc(64, bytes);
+    uint32_t *ids = realloc(heap->ids, capacity * sizeof(uint32_t));
+    if (buffer == NULL || ids == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do heap\n");
+        free(buffer);
+        if (ids != NULL)
+        {
+            heap->ids = ids;
+        }
+        return 1;
+    }
+    double *keys = (double *)buffer + offset;
+    if (heap->size > 0)
+    {
+        memcpy(keys, heap->keys, heap->size * sizeof(double));
+    }
+    free(heap->buffer);
+    heap->buffer = buffer;
+    heap->keys = keys;
+    heap->ids = ids;
+    heap->capacity = capacity;
+    return 0;
+}
+
+int DaryHeap_reserve(DaryHeap *heap, size_t num_vertices)
+{
+    if (num_vertices >= UINT32_MAX)
+    {
+        fprintf(stderr, "O heap suporta no máximo %u vértices\n", UINT32_MAX - 1);
+        return 1;
+    }
+    if (num_vertices > heap->capacity && __dary_grow(heap, num_vertices) != 0)
+    {
+        return 1;
+    }
+    if (heap->num_vertices != SIZE_MAX && num_vertices > heap->num_vertices)
+    {
+        uint32_t *position = realloc(heap->position, num_vertices * sizeof(uint32_t));
+        if (position == NULL)
+        {
+            fprintf(stderr, "Falha na alocação do mapa de posições do heap\n");
+            return 1;
+        }
+        for (size_t v = heap->num_vertices; v < num_vertices; v++)
+        {
+            position[v] = UINT32_MAX;
+        }
+        heap->position = position;
+        heap->num_vertices = num_vertices;
+    }
+    return 0;
+}
+
+void DaryHeap_clear(DaryHeap *heap)
+{
+    if (heap->position != NULL)
+    {
+        for (size_t i = 0; i < heap->size; i++)
+        {
+            heap->position[heap->ids[i]] = UINT32_MAX;
+        }
+    }
+    heap->size = 0;
+}
+
+int DaryHeap_is_empty(DaryHeap const *heap)
+{
+    return heap->size == 0;
+}
+
+// sobe a entrada (vertex_id, key) a partir do buraco em index
+static void __dary_sift_up(DaryHeap *heap, size_t index, uint32_t vertex_id, double key)
+{
+    double *keys = heap->keys;
+    uint32_t *ids = heap->ids;
+    while (index > 0)
+    {
+        size_t const parent = (index - 1) / heap->arity;
+        if (keys[parent] <= key)
+        {
+            break;
+        }
+        keys[index] = keys[parent];
+        ids[index] = ids[parent];
+        if (heap->position != NULL)
+        {
+            heap->position[ids[index]] = (uint32_t)index;
+        }
+        index = parent;
+    }
+    keys[index] = key;
+    ids[index] = vertex_id;
+    if (heap->position != NULL)
+    {
+        heap->position[vertex_id] = (uint32_t)index;
+    }
+}
+
+// desce a entrada (vertex_id, key) a partir do buraco em index
+static void __dary_sift_down(DaryHeap *heap, size_t index, uint32_t vertex_id, double key)
+{
+    double *keys = heap->keys;
+    uint32_t *ids = heap->ids;
+    size_t const size = heap->size;
+    for (;;)
+    {
+        size_t const first = heap->arity * index + 1;
+        if (first >= size)
+        {
+            break;
+        }
+        size_t const last = first + heap->arity < size ? first + heap->arity : size;
+        size_t smallest = first;
+        double smallest_key = keys[first];
+        for (size_t child = first + 1; child < last; child++)
+        {
+            if (keys[child] < smallest_key)
+            {
+                smallest = child;
+                smallest_key = keys[child];
+            }
+        }
+        if (smallest_key >= key)
+        {
+            break;
+        }
+        keys[index] = smallest_key;
+        ids[index] = ids[smallest];
+        if (heap->position != NULL)
+        {
+            heap->position[ids[index]] = (uint32_t)index;
+        }
+        index = smallest;
+    }
+    keys[index] = key;
+    ids[index] = vertex_id;
+    if (heap->position != NULL)
+    {
+        heap->position[vertex_id] = (uint32_t)index;
+    }
+}
+
+int DaryHeap_push(DaryHeap *heap, uint32_t vertex_id, double key)
+{
+    if (heap->position != NULL)
+    {
+        uint32_t const index = heap->position[vertex_id];
+        if (index != UINT32_MAX)
+        {
+            if (key < heap->keys[index])
+            {
+                __dary_sift_up(heap, index, vertex_id, key);
+            }
+            return 0;
+        }
+    }
+    if (heap->size == heap->capacity &&
+        __dary_grow(heap, heap->capacity > 0 ? 2 * heap->capacity : 16) != 0)
+    {
+        return 1;
+    }
+    __dary_sift_up(heap, heap->size++, vertex_id, key);
+    return 0;
+}
+
+double DaryHeap_pop(DaryHeap *heap, uint32_t *vertex_id)
+{
+    double const key = heap->keys[0];
+    *vertex_id = heap->ids[0];
+    if (heap->position != NULL)
+    {
+        heap->position[*vertex_id] = UINT32_MAX;
+    }
+    size_t const last = --heap->size;
+    if (last > 0)
+    {
+        __dary_sift_down(heap, 0, heap->ids[last], heap->keys[last]);
+    }
+    return key;
+}
+
+void DaryHeap_free(DaryHeap *heap)
+{
+    free(heap->buffer);
+    free(heap->ids);
+    free(heap->position);
+    DaryHeap_init(heap, heap->arity, heap->num_vertices != SIZE_MAX);
+}
+
+void PriorityQueue_init(PriorityQueue *queue, PriorityQueueKind kind)
+{
+    queue->kind = kind;
+    MinHeap_init(&queue->binary);
+    switch (kind)
+    {
+    case PRIORITY_QUEUE_8ARY:
+        DaryHeap_init(&queue->dary, 8, 1);
+        break;
+    case PRIORITY_QUEUE_LAZY:
+        DaryHeap_init(&queue->dary, 4, 0);
+        break;
+    default:
+        DaryHeap_init(&queue->dary, 4, 1);
+        break;
+    }
+}
+
+int PriorityQueue_reserve(PriorityQueue *queue, size_t num_vertices)
+{
+    if (queue->kind == PRIORITY_QUEUE_BINARY)
+    {
+        if (VecVertexWithPriority_reserve(&queue->binary.data, num_vertices) != 0)
+        {
+            return 1;
+        }
+        size_t const old_size = VecSizeT_size(&queue->binary.index_map);
+        if (old_size < num_vertices && VecSizeT_resize(&queue->binary.index_map, num_vertices) != 0)
+        {
+            return 1;
+        }
+        for (size_t i = old_size; i < num_vertices; i++)
+        {
+            VecSizeT_set(&queue->binary.index_map, i, SIZE_MAX);
+        }
+        return 0;
+    }
+    return DaryHeap_reserve(&queue->dary, num_vertices);
+}
+
+void PriorityQueue_clear(PriorityQueue *queue)
+{
+    if (queue->kind == PRIORITY_QUEUE_BINARY)
+    {
+        MinHeap_clear(&queue->binary);
+    }
+    else
+    {
+        DaryHeap_clear(&queue->dary);
+    }
+}
+
+int PriorityQueue_is_empty(PriorityQueue const *queue)
+{
+    return queue->kind == PRIORITY_QUEUE_BINARY ? MinHeap_is_empty(&queue->binary)
+                                                : DaryHeap_is_empty(&queue->dary);
+}
+
+int PriorityQueue_push(PriorityQueue *queue, size_t vertex_id, double key)
+{
+    if (queue->kind != PRIORITY_QUEUE_BINARY)
+    {
+        return DaryHeap_push(&queue->dary, (uint32_t)vertex_id, key);
+    }
+    if (vertex_id < VecSizeT_size(&queue->binary.index_map) &&
+        VecSizeT_get(&queue->binary.index_map, vertex_id) != SIZE_MAX)
+    {
+        MinHeap_decrease_key(&queue->binary, vertex_id, key);
+    }
+    else
+    {
+        MinHeap_add(&queue->binary, vertex_id, key);
+    }
+    return 0;
+}
+
+double PriorityQueue_pop(PriorityQueue *queue, size_t *vertex_id)
+{
+    if (queue->kind != PRIORITY_QUEUE_BINARY)
+    {
+        uint32_t id;
+        double const key = DaryHeap_pop(&queue->dary, &id);
+        *vertex_id = id;
+        return key;
+    }
+    double const key = VecVertexWithPriority_get(&queue->binary.data, 0).distance;
+    *vertex_id = MinHeap_get(&queue->binary);
+    return key;
+}
+
+void PriorityQueue_free(PriorityQueue *queue)
+{
+    MinHeap_free(&queue->binary);
+    DaryHeap_free(&queue->dary);
+}
+
+IMPLEMENT_VECTOR_INTERFACE(RadixEntry, VecRadixEntry)
+
+static uint64_t __key_bits(double key)
+{
+    uint64_t bits;
+    memcpy(&bits, &key, sizeof(bits));
+    return bits;
+}
+
+static size_t __radix_bucket(uint64_t key, uint64_t last)
+{
+    return key == last ? 0 : 64 - (size_t)__builtin_clzll(key ^ last);
+}
+
+void RadixHeap_init(RadixHeap *heap)
+{
+    for (size_t i = 0; i < RADIX_HEAP_BUCKETS; i++)
+    {
+        VecRadixEntry_init(&heap->buckets[i]);
+    }
+    heap->last = 0;
+    heap->size = 0;
+}
+
+void RadixHeap_clear(RadixHeap *heap)
+{
+    for (size_t i = 0; i < RADIX_HEAP_BUCKETS; i++)
+    {
+        VecRadixEntry_resize(&heap->buckets[i], 0);
+    }
+    heap->last = 0;
+    heap->size = 0;
+}
+
+int RadixHeap_is_empty(RadixHeap const *heap)
+{
+    return heap->size == 0;
+}
+
+void RadixHeap_push(RadixHeap *heap, uint32_t vertex_id, double key)
+{
+    uint64_t const bits = __key_bits(key);
+    VecRadixEntry_push_back(&heap->buckets[__radix_bucket(bits, heap->last)],
+                            (RadixEntry){.key = bits, .vertex_id = vertex_id});
+    heap->size++;
+}
+
+double RadixHeap_pop(RadixHeap *heap, uint32_t *vertex_id)
+{
+    if (VecRadixEntry_is_empty(&heap->buckets[0]))
+    {
+        // o menor bucket não vazio é redistribuído a partir do seu mínimo; cada
+        // entrada vai para um bucket estritamente menor
+        size_t i = 1;
+        while (VecRadixEntry_is_empty(&heap->buckets[i]))
+        {
+            i++;
+        }
+        VecRadixEntry *bucket = &heap->buckets[i];
+        uint64_t minimum = bucket->data[0].key;
+        for (size_t j = 1; j < bucket->size; j++)
+        {
+            minimum = bucket->data[j].key < minimum ? bucket->data[j].key : minimum;
+        }
+        heap->last = minimum;
+        for (size_t j = 0; j < bucket->size; j++)
+        {
+            RadixEntry const entry = bucket->data[j];
+            VecRadixEntry_push_back(&heap->buckets[__radix_bucket(entry.key, minimum)], entry);
+        }
+        VecRadixEntry_resize(bucket, 0);
+    }
+    RadixEntry const entry = heap->buckets[0].data[heap->buckets[0].size - 1];
+    VecRadixEntry_pop_back(&heap->buckets[0]);
+    heap->size--;
+    *vertex_id = entry.vertex_id;
+    double key;
+    memcpy(&key, &entry.key, sizeof(key));
+    return key;
+}
+
+void RadixHeap_free(RadixHeap *heap)
+{
+    for (size_t i = 0; i < RADIX_HEAP_BUCKETS; i++)
+    {
+        VecRadixEntry_free(&heap->buckets[i]);
+    }
+    heap->size = 0;
+}
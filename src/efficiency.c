@@ -0,0 +1,115 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include "graph_library.h"
+
+// Soma de Kahan-Neumaier: o erro de arredondamento de cada adição fica em compensation
+// e é devolvido no final, de modo que o erro da soma de V(V - 1) termos não cresce com
+// o número de termos. Com isso a ordem em que as linhas chegam (threads, processos)
+// quase não altera o resultado. Dentro de uma linha os termos são somados diretamente
+// em blocos de EFFICIENCY_BLOCK (erro relativo ~ EFFICIENCY_BLOCK * 2^-53) e só a soma
+// de cada bloco passa pela compensação, que assim não pesa no laço interno.
+
+#define EFFICIENCY_BLOCK 256
+
+void EfficiencySum_init(EfficiencySum *acc)
+{
+    acc->sum = 0.0;
+    acc->compensation = 0.0;
+}
+
+static inline void __neumaier_add(double *sum, double *compensation, double value)
+{
+    double const t = *sum + value;
+    if (fabs(*sum) >= fabs(value))
+    {
+        *compensation += (*sum - t) + value;
+    }
+    else
+    {
+        *compensation += (value - t) + *sum;
+    }
+    *sum = t;
+}
+
+void EfficiencySum_add(EfficiencySum *acc, double value)
+{
+    __neumaier_add(&acc->sum, &acc->compensation, value);
+}
+
+void EfficiencySum_add_row(EfficiencySum *acc, double const *distances, size_t V, size_t source)
+{
+    for (size_t first = 0; first < V; first += EFFICIENCY_BLOCK)
+    {
+        size_t const last = first + EFFICIENCY_BLOCK < V ? first + EFFICIENCY_BLOCK : V;
+        double block_sum = 0.0;
+        for (size_t j = first; j < last; j++)
+        {
+            if (j != source && !isinf(distances[j]) && distances[j] != 0.0)
+            {
+                block_sum += 1.0 / distances[j];
+            }
+        }
+        __neumaier_add(&acc->sum, &acc->compensation, block_sum);
+    }
+}
+
+void EfficiencySum_add_row_float(EfficiencySum *acc, float const *distances, size_t V, size_t source)
+{
+    for (size_t first = 0; first < V; first += EFFICIENCY_BLOCK)
+    {
+        size_t const last = first + EFFICIENCY_BLOCK < V ? first + EFFICIENCY_BLOCK : V;
+        double block_sum = 0.0;
+        for (size_t j = first; j < last; j++)
+        {
+            if (j != source && !isinf(distances[j]) && distances[j] != 0.0f)
+            {
+                block_sum += 1.0 / (double)distances[j];
+            }
+        }
+        __neumaier_add(&acc->sum, &acc->compensation, block_sum);
+    }
+}
+
+void EfficiencySum_merge(EfficiencySum *acc, EfficiencySum const *other)
+{
+    __neumaier_add(&acc->sum, &acc->compensation, other->sum);
+    acc->compensation += other->compensation;
+}
+
+double EfficiencySum_value(EfficiencySum const *acc)
+{
+    return acc->sum + acc->compensation;
+}
+
+double global_efficiency(EfficiencySum const *local, size_t V, int root, MPI_Comm comm)
+{
+    int rank, nprocs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nprocs);
+    // as somas são reunidas e combinadas na ordem dos processos (em vez de MPI_SUM) para
+    // manter a compensação e um resultado que não depende do algoritmo de redução do MPI
+    double const local_sum[2] = {local->sum, local->compensation};
+    double *all_sums = rank == root ? malloc(2 * (size_t)nprocs * sizeof(double)) : NULL;
+    if (rank == root && all_sums == NULL)
+    {
+        fprintf(stderr, "Falha na alocação da redução da eficiência\n");
+        MPI_Abort(comm, 1);
+    }
+    MPI_Gather(local_sum, 2, MPI_DOUBLE, all_sums, 2, MPI_DOUBLE, root, comm);
+    if (rank != root)
+    {
+        return 0.0;
+    }
+    EfficiencySum total;
+    EfficiencySum_init(&total);
+    for (int p = 0; p < nprocs; p++)
+    {
+        EfficiencySum const partial = {.sum = all_sums[2 * p], .compensation = all_sums[2 * p + 1]};
+        EfficiencySum_merge(&total, &partial);
+    }
+    free(all_sums);
+    return V > 1 ? EfficiencySum_value(&total) / ((double)V * (double)(V - 1)) : 0.0;
+}
@@ -0,0 +1,290 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include "graph_library.h"
+#include "min_plus.h"
+#include "partition.h"
+#include "profiling.h"
+
+// Distribuição 2D bloco-cíclica: o bloco global (I, J) de tamanho b x b
+// pertence ao processo (I mod P_r, J mod P_c) da grade, ou seja, linhas e colunas
+// seguem cada uma uma RowPartition bloco-cíclica. Cada processo guarda seus blocos
+// de forma contígua em uma matriz local.
+
+static size_t __tile_length(size_t V, size_t b, size_t tile)
+{
+    size_t const begin = tile * b;
+    return (begin + b <= V) ? b : V - begin;
+}
+
+void floyd_warshall_2d_grid(size_t V, size_t tile_size, int nprocs, GridPartition *grid)
+{
+    int dims[2] = {0, 0};
+    MPI_Dims_create(nprocs, 2, dims);
+    GridPartition_init(grid, V, dims[0], dims[1], tile_size != 0 ? tile_size : FLOYD_WARSHALL_DEFAULT_TILE_SIZE);
+}
+
+static int __floyd_warshall_2d(Graph const *graph, MatrixDouble *distances, double *efficiency,
+                               size_t tile_size, RankTimings *timings)
+{
+    int rank, nprocs;
+    int result = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+    size_t const V = graph->V;
+    size_t const E = graph->E;
+    size_t const b = tile_size != 0 ? tile_size : FLOYD_WARSHALL_DEFAULT_TILE_SIZE;
+    size_t const num_tiles = (V + b - 1) / b;
+    RankTimings local_timings = {0.0, 0.0, 0.0, 0.0};
+
+    GridPartition grid;
+    floyd_warshall_2d_grid(V, tile_size, nprocs, &grid);
+    int dims[2] = {grid.grid_rows, grid.grid_cols};
+    int periods[2] = {0, 0};
+    int coords[2];
+    MPI_Comm grid_comm, row_comm, col_comm;
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &grid_comm);
+    MPI_Cart_coords(grid_comm, rank, 2, coords);
+    int const grid_rows = dims[0], grid_cols = dims[1];
+    int const my_row = coords[0], my_col = coords[1];
+    int const keep_cols[2] = {0, 1};
+    int const keep_rows[2] = {1, 0};
+    MPI_Cart_sub(grid_comm, keep_cols, &row_comm); // processos da mesma linha da grade
+    MPI_Cart_sub(grid_comm, keep_rows, &col_comm); // processos da mesma coluna da grade
+
+    RowPartition const row_partition = grid.rows;
+    RowPartition const col_partition = grid.cols;
+    size_t const local_nrows = RowPartition_count(&row_partition, my_row);
+    size_t const local_ncols = RowPartition_count(&col_partition, my_col);
+
+    MatrixDouble local_distances, diagonal, k_rows, k_cols, recv_buffer;
+    MatrixDouble_init(&local_distances, 0, 0);
+    MatrixDouble_init(&diagonal, 0, 0);
+    MatrixDouble_init(&k_rows, 0, 0);
+    MatrixDouble_init(&k_cols, 0, 0);
+    MatrixDouble_init(&recv_buffer, 0, 0);
+
+    if (MatrixDouble_init_aligned(&local_distances, local_nrows, local_ncols, MATRIX_ALLOC_HUGE_PAGES) != 0 ||
+        MatrixDouble_init_aligned(&diagonal, b, b, MATRIX_ALLOC_ALIGNED) != 0 ||
+        MatrixDouble_init_aligned(&k_rows, b, local_ncols, MATRIX_ALLOC_ALIGNED) != 0 ||
+        MatrixDouble_init_aligned(&k_cols, local_nrows, b, MATRIX_ALLOC_ALIGNED) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da matriz local no processo %d\n", rank);
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < local_nrows; i++)
+    {
+        size_t const global_i = RowPartition_global_index(&row_partition, my_row, i);
+        for (size_t j = 0; j < local_ncols; j++)
+        {
+            size_t const global_j = RowPartition_global_index(&col_partition, my_col, j);
+            MatrixDouble_set(&local_distances, i, j, (global_i != global_j) ? INFINITY : 0.0);
+        }
+    }
+
+    for (size_t edge_index = 0; edge_index < E; edge_index++)
+    {
+        Edge const edge = VecEdge_get(&graph->edge_list, edge_index);
+        if (RowPartition_owner(&row_partition, edge.from) == my_row &&
+            RowPartition_owner(&col_partition, edge.to) == my_col)
+        {
+            size_t const local_i = RowPartition_local_index(&row_partition, edge.from);
+            size_t const local_j = RowPartition_local_index(&col_partition, edge.to);
+            if (edge.weight < MatrixDouble_get(&local_distances, local_i, local_j))
+            {
+                MatrixDouble_set(&local_distances, local_i, local_j, edge.weight);
+            }
+        }
+    }
+
+    double *const L = local_distances.data;
+    size_t const ld = local_ncols;
+    double const start = MPI_Wtime();
+    PROFILE_BEGIN(PROFILE_FW_2D);
+    PROFILE_THREAD_COUNTERS(counters);
+    PROFILE_THREAD_BEGIN(counters);
+    for (size_t kb = 0; kb < num_tiles; kb++)
+    {
+        size_t const kk = __tile_length(V, b, kb);
+        int const owner_row = kb % grid_rows;
+        int const owner_col = kb % grid_cols;
+        size_t const local_k_row = (kb / grid_rows) * b;
+        size_t const local_k_col = (kb / grid_cols) * b;
+
+        // fase 1: bloco diagonal, enviado para a linha e a coluna da grade que o contém
+        if (my_row == owner_row && my_col == owner_col)
+        {
+            double *tile = L + local_k_row * ld + local_k_col;
+            min_plus_block_dependent(tile, ld, tile, ld, tile, ld, kk, kk, kk);
+            for (size_t i = 0; i < kk; i++)
+            {
+                memcpy(diagonal.data + i * kk, tile + i * ld, kk * sizeof(double));
+            }
+        }
+        double wait_start = MPI_Wtime();
+        if (my_row == owner_row)
+        {
+            MPI_Bcast(diagonal.data, kk * kk, MPI_DOUBLE, owner_col, row_comm);
+        }
+        if (my_col == owner_col)
+        {
+            MPI_Bcast(diagonal.data, kk * kk, MPI_DOUBLE, owner_row, col_comm);
+        }
+        local_timings.wait_time += MPI_Wtime() - wait_start;
+
+        // fase 2: blocos da linha kb e da coluna kb, que dependem só do diagonal
+        if (my_row == owner_row)
+        {
+            double *row_segment = L + local_k_row * ld;
+            min_plus_block_dependent(row_segment, ld, diagonal.data, kk,
+                                     row_segment, ld, kk, local_ncols, kk);
+            if (ld > 0)
+            {
+                memcpy(k_rows.data, row_segment, kk * ld * sizeof(double));
+            }
+        }
+        if (my_col == owner_col)
+        {
+            double *col_segment = L + local_k_col;
+            min_plus_block_dependent(col_segment, ld, col_segment, ld,
+                                     diagonal.data, kk, local_nrows, kk, kk);
+            for (size_t i = 0; i < local_nrows; i++)
+            {
+                memcpy(k_cols.data + i * kk, col_segment + i * ld, kk * sizeof(double));
+            }
+        }
+
+        // cada mensagem carrega uma faixa inteira de blocos (kk linhas ou colunas)
+        wait_start = MPI_Wtime();
+        MPI_Bcast(k_rows.data, kk * local_ncols, MPI_DOUBLE, owner_row, col_comm);
+        MPI_Bcast(k_cols.data, local_nrows * kk, MPI_DOUBLE, owner_col, row_comm);
+        local_timings.wait_time += MPI_Wtime() - wait_start;
+
+        // fase 3: demais blocos; as linhas da faixa kb já estão finalizadas
+        for (size_t local_tile = 0; local_tile * b < local_nrows; local_tile++)
+        {
+            size_t const row_begin = local_tile * b;
+            if (my_row == owner_row && row_begin == local_k_row)
+            {
+                continue;
+            }
+            size_t const rows = (row_begin + b <= local_nrows) ? b : local_nrows - row_begin;
+            min_plus_block(L + row_begin * ld, ld,
+                           k_cols.data + row_begin * kk, kk,
+                           k_rows.data, ld,
+                           rows, local_ncols, kk);
+        }
+    }
+
+    PROFILE_THREAD_END(counters, PROFILE_FW_2D);
+    PROFILE_END(PROFILE_FW_2D);
+    local_timings.compute_time += MPI_Wtime() - start - local_timings.wait_time;
+
+    if (efficiency != NULL)
+    {
+        double const reduce_start = MPI_Wtime();
+        // as colunas locais não são contíguas na matriz global: soma elemento a elemento
+        EfficiencySum partial_sum;
+        EfficiencySum_init(&partial_sum);
+        for (size_t i = 0; i < local_nrows; i++)
+        {
+            size_t const global_i = RowPartition_global_index(&row_partition, my_row, i);
+            for (size_t j = 0; j < local_ncols; j++)
+            {
+                double const dist = MatrixDouble_get(&local_distances, i, j);
+                if (global_i != RowPartition_global_index(&col_partition, my_col, j) && !isinf(dist) && dist != 0.0)
+                {
+                    EfficiencySum_add(&partial_sum, 1.0 / dist);
+                }
+            }
+        }
+        *efficiency = global_efficiency(&partial_sum, V, 0, grid_comm);
+        local_timings.reduce_time += MPI_Wtime() - reduce_start;
+    }
+    if (distances == NULL)
+    {
+        result = 0;
+        goto cleanup;
+    }
+
+    double const gather_start = MPI_Wtime();
+    if (rank == 0)
+    {
+        if (MatrixDouble_init_aligned(distances, V, V, MATRIX_ALLOC_HUGE_PAGES) != 0)
+        {
+            fprintf(stderr, "Falha na alocação da matriz de distância completa");
+            goto cleanup;
+        }
+    }
+    for (int p = 0; p < nprocs; p++)
+    {
+        int p_coords[2];
+        MPI_Cart_coords(grid_comm, p, 2, p_coords);
+        size_t const p_nrows = RowPartition_count(&row_partition, p_coords[0]);
+        size_t const p_ncols = RowPartition_count(&col_partition, p_coords[1]);
+        if (rank == 0)
+        {
+            double const *block = local_distances.data;
+            if (p != 0)
+            {
+                MatrixDouble_free(&recv_buffer);
+                if (MatrixDouble_init(&recv_buffer, p_nrows, p_ncols) != 0)
+                {
+                    fprintf(stderr, "Falha na alocação do buffer de recepção");
+                    MatrixDouble_free(distances);
+                    goto cleanup;
+                }
+                MPI_Recv(recv_buffer.data, p_nrows * p_ncols, MPI_DOUBLE, p, 0, grid_comm, MPI_STATUS_IGNORE);
+                block = recv_buffer.data;
+            }
+            for (size_t i = 0; i < p_nrows; i++)
+            {
+                size_t const global_i = RowPartition_global_index(&row_partition, p_coords[0], i);
+                for (size_t j = 0; j < p_ncols; j++)
+                {
+                    size_t const global_j = RowPartition_global_index(&col_partition, p_coords[1], j);
+                    MatrixDouble_set(distances, global_i, global_j, block[i * p_ncols + j]);
+                }
+            }
+        }
+        else if (rank == p)
+        {
+            MPI_Send(local_distances.data, local_nrows * local_ncols, MPI_DOUBLE, 0, 0, grid_comm);
+        }
+    }
+    local_timings.gather_time += MPI_Wtime() - gather_start;
+
+    result = 0;
+
+cleanup:
+    if (timings != NULL)
+    {
+        *timings = local_timings;
+    }
+    MatrixDouble_free(&local_distances);
+    MatrixDouble_free(&diagonal);
+    MatrixDouble_free(&k_rows);
+    MatrixDouble_free(&k_cols);
+    MatrixDouble_free(&recv_buffer);
+    MPI_Comm_free(&row_comm);
+    MPI_Comm_free(&col_comm);
+    MPI_Comm_free(&grid_comm);
+    return result;
+}
+
+int floyd_warshall_openmpi_2d(Graph const *graph, MatrixDouble *distances, size_t tile_size, RankTimings *timings)
+{
+    return __floyd_warshall_2d(graph, distances, NULL, tile_size, timings);
+}
+
+int floyd_warshall_openmpi_2d_efficiency(Graph const *graph, double *efficiency, size_t tile_size,
+                                         RankTimings *timings)
+{
+    return __floyd_warshall_2d(graph, NULL, efficiency, tile_size, timings);
+}
@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "graph_library.h"
+#include "min_plus.h"
+#include "floyd_warshall_common.h"
+
+// Floyd-Warshall em precisão simples. Os pesos são arredondados para float ao
+// preencher a matriz inicial e as distâncias acumulam um erro relativo da ordem de
+// (comprimento do caminho) * 2^-24; a soma de 1/d é feita em double, como nas
+// variantes em double, para que o erro da eficiência venha só das distâncias.
+
+IMPLEMENT_VECTOR_INTERFACE(float, VecFloat)
+IMPLEMENT_MATRIX_INTERFACE(float, MatrixFloat)
+
+IMPLEMENT_FLOYD_WARSHALL_COMMON(float, MatrixFloat, MPI_FLOAT, KRowBroadcastFloat, _float)
+
+int floyd_warshall_threaded_float(Graph const *graph, MatrixFloat *distances, ThreadConfig const *threads)
+{
+    if (__init_full_matrix_float(graph, distances, threads) != 0)
+    {
+        return 1;
+    }
+    if (floyd_warshall_relax_strip_float(distances, graph->V, __matrix_k_row_float, distances, threads) != 0)
+    {
+        MatrixFloat_free(distances);
+        return 1;
+    }
+    return 0;
+}
+
+int floyd_warshall_openmpi_float_efficiency(Graph const *graph, FloydWarshallOptions const *options,
+                                            double *efficiency, RankTimings *timings)
+{
+    if (options->pipelined)
+    {
+        fprintf(stderr, "O Floyd-Warshall com pipeline não tem variante em precisão simples\n");
+        return 1;
+    }
+    int rank, nprocs;
+    int result = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+    size_t const V = graph->V;
+    RowPartition partition;
+    RowPartition_init(&partition, options->partition, V, nprocs, options->block_size);
+    RankTimings local_timings = {0.0, 0.0, 0.0, 0.0};
+
+    MatrixFloat local_distances;
+    MatrixFloat_init(&local_distances, 0, 0);
+    VecFloat k_row;
+    VecFloat_init(&k_row);
+
+    if (MatrixFloat_init_aligned(&local_distances, RowPartition_count(&partition, rank), V, MATRIX_ALLOC_HUGE_PAGES) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da matriz local no processo %d\n", rank);
+        goto cleanup;
+    }
+    if (floyd_warshall_first_touch(local_distances.data, local_distances.nrows, V * sizeof(float),
+                                   &options->threads) != 0)
+    {
+        goto cleanup;
+    }
+    __init_distance_rows_float(graph, &local_distances, &partition, rank);
+    if (VecFloat_resize(&k_row, V) != 0)
+    {
+        fprintf(stderr, "Falha na alocação de buffer para comunicação MPI no processo %d\n", rank);
+        goto cleanup;
+    }
+
+    KRowBroadcastFloat broadcast = {.local_distances = &local_distances, .partition = &partition,
+                                    .rank = rank, .k_row = k_row.data, .timings = &local_timings};
+    double const start = MPI_Wtime();
+    if (floyd_warshall_relax_strip_float(&local_distances, V, __broadcast_k_row_float, &broadcast,
+                                         &options->threads) != 0)
+    {
+        goto cleanup;
+    }
+    local_timings.compute_time += MPI_Wtime() - start - local_timings.wait_time;
+
+    double const reduce_start = MPI_Wtime();
+    EfficiencySum partial_sum;
+    EfficiencySum_init(&partial_sum);
+    for (size_t i = 0; i < local_distances.nrows; i++)
+    {
+        EfficiencySum_add_row_float(&partial_sum, local_distances.data + i * V, V,
+                                    RowPartition_global_index(&partition, rank, i));
+    }
+    *efficiency = global_efficiency(&partial_sum, V, 0, MPI_COMM_WORLD);
+    local_timings.reduce_time += MPI_Wtime() - reduce_start;
+    result = 0;
+
+cleanup:
+    if (timings != NULL)
+    {
+        *timings = local_timings;
+    }
+    MatrixFloat_free(&local_distances);
+    VecFloat_free(&k_row);
+    return result;
+}
@@ -0,0 +1,841 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+#include <unistd.h>
+#include <mpi.h>
+#include "graph_library.h"
+#include "min_plus.h"
+#include "profiling.h"
+
+#define NO_TILE SIZE_MAX
+#define NO_SLOT SIZE_MAX
+
+typedef enum
+{
+    TILE_READY,
+    TILE_IN_FLIGHT, // na fila ou sendo transferido pela thread auxiliar
+} TileState;
+
+typedef struct
+{
+    size_t tile;       // ib * num_tiles + jb; NO_TILE se o slot está livre
+    double *data;      // tile_size × tile_size, linhas de tile_size elementos
+    TileState state;
+    int dirty;         // diferente do arquivo
+    size_t pins;       // slots presos não estão na lista LRU e não saem do cache
+    int prefetched;    // o pino é da leitura antecipada e passa para o primeiro __acquire
+    size_t prev, next; // lista LRU
+} TileSlot;
+
+// uma transferência de um slot: grava o conteúdo atual e depois lê outro tile no lugar
+typedef struct
+{
+    size_t slot;
+    size_t write_tile; // NO_TILE: nada a gravar
+    size_t read_tile;  // NO_TILE: nada a ler
+} TileTransfer;
+
+typedef struct
+{
+    int fd;
+    size_t V;
+    size_t tile_size;
+    size_t num_tiles; // por dimensão
+    size_t tile_bytes;
+    TileSlot *slots;
+    size_t num_slots;
+    double *buffers;
+    size_t *slot_of; // num_tiles² entradas: slot do tile ou NO_SLOT
+    size_t lru_first; // o menos recente, próximo a sair
+    size_t lru_last;
+    // com a thread auxiliar toda a E/S passa pela fila, em ordem: a leitura de um tile
+    // nunca ultrapassa a gravação dele ao sair do cache
+    int async;
+    thrd_t helper;
+    mtx_t mutex;
+    cnd_t queued;
+    cnd_t done;
+    TileTransfer *queue; // circular, num_slots entradas (um pedido por slot, no máximo)
+    size_t queue_begin;
+    size_t queue_size;
+    int stop;
+    int io_error;
+    OutOfCoreStats stats;
+} TileCache;
+
+void OutOfCoreOptions_init(OutOfCoreOptions *options)
+{
+    options->tile_size = 0;
+    options->memory_budget = OUT_OF_CORE_DEFAULT_MEMORY;
+    options->path = NULL;
+    options->prefetch_depth = OUT_OF_CORE_DEFAULT_PREFETCH;
+}
+
+static int __pwrite_all(int fd, void const *data, size_t bytes, off_t offset)
+{
+    char const *cursor = data;
+    while (bytes > 0)
+    {
+        ssize_t const written = pwrite(fd, cursor, bytes, offset);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            fprintf(stderr, "Erro gravando o arquivo de tiles: %s\n", strerror(errno));
+            return 1;
+        }
+        cursor += written;
+        bytes -= (size_t)written;
+        offset += written;
+    }
+    return 0;
+}
+
+static int __pread_all(int fd, void *data, size_t bytes, off_t offset)
+{
+    char *cursor = data;
+    while (bytes > 0)
+    {
+        ssize_t const read_bytes = pread(fd, cursor, bytes, offset);
+        if (read_bytes < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (read_bytes <= 0)
+        {
+            fprintf(stderr, "Erro lendo o arquivo de tiles: %s\n",
+                    read_bytes == 0 ? "fim inesperado" : strerror(errno));
+            return 1;
+        }
+        cursor += read_bytes;
+        bytes -= (size_t)read_bytes;
+        offset += read_bytes;
+    }
+    return 0;
+}
+
+static off_t __tile_offset(TileCache const *cache, size_t tile)
+{
+    return (off_t)tile * (off_t)cache->tile_bytes;
+}
+
+// linhas (ou colunas) do tile b: o último pode ser menor
+static size_t __tile_extent(TileCache const *cache, size_t b)
+{
+    return b + 1 < cache->num_tiles ? cache->tile_size : cache->V - b * cache->tile_size;
+}
+
+static int __transfer(TileCache *cache, TileTransfer const *transfer)
+{
+    double *data = cache->slots[transfer->slot].data;
+    if (transfer->write_tile != NO_TILE &&
+        __pwrite_all(cache->fd, data, cache->tile_bytes, __tile_offset(cache, transfer->write_tile)) != 0)
+    {
+        return 1;
+    }
+    if (transfer->read_tile != NO_TILE &&
+        __pread_all(cache->fd, data, cache->tile_bytes, __tile_offset(cache, transfer->read_tile)) != 0)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+static int __io_helper(void *arg)
+{
+    TileCache *cache = arg;
+    mtx_lock(&cache->mutex);
+    for (;;)
+    {
+        while (cache->queue_size == 0 && !cache->stop)
+        {
+            cnd_wait(&cache->queued, &cache->mutex);
+        }
+        if (cache->queue_size == 0)
+        {
+            break;
+        }
+        TileTransfer const transfer = cache->queue[cache->queue_begin];
+        cache->queue_begin = (cache->queue_begin + 1) % cache->num_slots;
+        cache->queue_size--;
+        mtx_unlock(&cache->mutex);
+        int const status = __transfer(cache, &transfer);
+        mtx_lock(&cache->mutex);
+        cache->io_error |= status;
+        cache->slots[transfer.slot].state = TILE_READY;
+        cnd_broadcast(&cache->done);
+    }
+    mtx_unlock(&cache->mutex);
+    return 0;
+}
+
+static void __submit(TileCache *cache, TileTransfer const *transfer)
+{
+    if (!cache->async)
+    {
+        cache->io_error |= __transfer(cache, transfer);
+        return;
+    }
+    mtx_lock(&cache->mutex);
+    cache->slots[transfer->slot].state = TILE_IN_FLIGHT;
+    cache->queue[(cache->queue_begin + cache->queue_size) % cache->num_slots] = *transfer;
+    cache->queue_size++;
+    cnd_signal(&cache->queued);
+    mtx_unlock(&cache->mutex);
+}
+
+static void __wait_slot(TileCache *cache, size_t s)
+{
+    if (!cache->async)
+    {
+        return;
+    }
+    mtx_lock(&cache->mutex);
+    while (cache->slots[s].state == TILE_IN_FLIGHT)
+    {
+        cnd_wait(&cache->done, &cache->mutex);
+    }
+    mtx_unlock(&cache->mutex);
+}
+
+static void __lru_remove(TileCache *cache, size_t s)
+{
+    TileSlot *slot = &cache->slots[s];
+    if (slot->prev != NO_SLOT)
+    {
+        cache->slots[slot->prev].next = slot->next;
+    }
+    else
+    {
+        cache->lru_first = slot->next;
+    }
+    if (slot->next != NO_SLOT)
+    {
+        cache->slots[slot->next].prev = slot->prev;
+    }
+    else
+    {
+        cache->lru_last = slot->prev;
+    }
+    slot->prev = NO_SLOT;
+    slot->next = NO_SLOT;
+}
+
+static void __lru_append(TileCache *cache, size_t s)
+{
+    TileSlot *slot = &cache->slots[s];
+    slot->prev = cache->lru_last;
+    slot->next = NO_SLOT;
+    if (cache->lru_last != NO_SLOT)
+    {
+        cache->slots[cache->lru_last].next = s;
+    }
+    else
+    {
+        cache->lru_first = s;
+    }
+    cache->lru_last = s;
+}
+
+// traz tile para o slot menos recente (gravando antes o tile que sai, se modificado) e
+// o deixa preso; NO_SLOT se todos os slots estão presos
+static size_t __load(TileCache *cache, size_t tile, int prefetch)
+{
+    size_t const s = cache->lru_first;
+    if (s == NO_SLOT)
+    {
+        return NO_SLOT;
+    }
+    __lru_remove(cache, s);
+    TileSlot *slot = &cache->slots[s];
+    TileTransfer const transfer = {s, slot->tile != NO_TILE && slot->dirty ? slot->tile : NO_TILE, tile};
+    if (slot->tile != NO_TILE)
+    {
+        cache->slot_of[slot->tile] = NO_SLOT;
+    }
+    slot->tile = tile;
+    slot->dirty = 0;
+    slot->pins = 1;
+    slot->prefetched = prefetch;
+    cache->slot_of[tile] = s;
+    cache->stats.tiles_read++;
+    cache->stats.tiles_written += transfer.write_tile != NO_TILE;
+    __submit(cache, &transfer);
+    return s;
+}
+
+// pede a leitura antecipada de tile; se ele já está no cache, só o torna o mais recente
+static void __prefetch(TileCache *cache, size_t tile)
+{
+    size_t const s = cache->slot_of[tile];
+    if (s == NO_SLOT)
+    {
+        __load(cache, tile, 1);
+    }
+    else if (cache->slots[s].pins == 0)
+    {
+        __lru_remove(cache, s);
+        __lru_append(cache, s);
+    }
+}
+
+// dados de tile, preso no cache até __release; NULL em erro de E/S
+static double *__acquire(TileCache *cache, size_t tile)
+{
+    double const start = MPI_Wtime();
+    size_t s = cache->slot_of[tile];
+    if (s != NO_SLOT)
+    {
+        TileSlot *slot = &cache->slots[s];
+        cache->stats.cache_hits++;
+        if (slot->prefetched)
+        {
+            slot->prefetched = 0;
+        }
+        else if (slot->pins++ == 0)
+        {
+            __lru_remove(cache, s);
+        }
+    }
+    else if ((s = __load(cache, tile, 0)) == NO_SLOT)
+    {
+        fprintf(stderr, "Erro: todos os tiles do cache out-of-core estão presos\n");
+        return NULL;
+    }
+    __wait_slot(cache, s);
+    cache->stats.io_wait_time += MPI_Wtime() - start;
+    return cache->io_error ? NULL : cache->slots[s].data;
+}
+
+static void __release(TileCache *cache, size_t tile, int dirty)
+{
+    size_t const s = cache->slot_of[tile];
+    TileSlot *slot = &cache->slots[s];
+    slot->dirty |= dirty;
+    if (--slot->pins == 0)
+    {
+        __lru_append(cache, s);
+    }
+}
+
+// grava os tiles modificados que ainda estão no cache (nenhum pode estar preso)
+static int __flush(TileCache *cache)
+{
+    double const start = MPI_Wtime();
+    for (size_t s = 0; s < cache->num_slots; s++)
+    {
+        TileSlot *slot = &cache->slots[s];
+        if (slot->tile != NO_TILE && slot->dirty)
+        {
+            TileTransfer const transfer = {s, slot->tile, NO_TILE};
+            slot->dirty = 0;
+            cache->stats.tiles_written++;
+            __submit(cache, &transfer);
+        }
+    }
+    for (size_t s = 0; s < cache->num_slots; s++)
+    {
+        __wait_slot(cache, s);
+    }
+    cache->stats.io_wait_time += MPI_Wtime() - start;
+    return cache->io_error;
+}
+
+static int __open_tile_file(char const *path)
+{
+    if (path != NULL)
+    {
+        int const fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            fprintf(stderr, "Erro abrindo o arquivo de tiles %s: %s\n", path, strerror(errno));
+        }
+        return fd;
+    }
+    char const *directory = getenv("TMPDIR");
+    if (directory == NULL || directory[0] == '\0')
+    {
+        directory = "/tmp";
+    }
+    char name[4096];
+    if (snprintf(name, sizeof(name), "%s/fw_out_of_core_XXXXXX", directory) >= (int)sizeof(name))
+    {
+        fprintf(stderr, "Erro: caminho de TMPDIR longo demais\n");
+        return -1;
+    }
+    int const fd = mkstemp(name);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Erro criando o arquivo de tiles em %s: %s\n", directory, strerror(errno));
+        return -1;
+    }
+    // sem nome o arquivo some ao ser fechado, mesmo se o processo for interrompido
+    unlink(name);
+    return fd;
+}
+
+static int __cache_open(TileCache *cache, int fd, size_t V, size_t tile_size, size_t num_slots, int async)
+{
+    cache->fd = fd;
+    cache->V = V;
+    cache->tile_size = tile_size;
+    cache->num_tiles = (V + tile_size - 1) / tile_size;
+    cache->tile_bytes = tile_size * tile_size * sizeof(double);
+    cache->num_slots = num_slots;
+    cache->lru_first = NO_SLOT;
+    cache->lru_last = NO_SLOT;
+    cache->async = 0;
+    cache->queue_begin = 0;
+    cache->queue_size = 0;
+    cache->stop = 0;
+    cache->io_error = 0;
+    cache->stats.tile_size = tile_size;
+    cache->stats.cache_tiles = num_slots;
+    cache->stats.tiles_read = 0;
+    cache->stats.tiles_written = 0;
+    cache->stats.cache_hits = 0;
+    cache->stats.io_wait_time = 0.0;
+    size_t const num_tiles = cache->num_tiles * cache->num_tiles;
+    cache->slots = malloc(num_slots * sizeof(TileSlot));
+    cache->buffers = matrix_alloc(num_slots * cache->tile_bytes, MATRIX_ALLOC_HUGE_PAGES);
+    cache->slot_of = malloc(num_tiles * sizeof(size_t));
+    cache->queue = malloc(num_slots * sizeof(TileTransfer));
+    if (cache->slots == NULL || cache->buffers == NULL || cache->slot_of == NULL || cache->queue == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do cache de %zu tiles\n", num_slots);
+        return 1;
+    }
+    for (size_t t = 0; t < num_tiles; t++)
+    {
+        cache->slot_of[t] = NO_SLOT;
+    }
+    for (size_t s = 0; s < num_slots; s++)
+    {
+        TileSlot *slot = &cache->slots[s];
+        slot->tile = NO_TILE;
+        slot->data = cache->buffers + s * tile_size * tile_size;
+        slot->state = TILE_READY;
+        slot->dirty = 0;
+        slot->pins = 0;
+        slot->prefetched = 0;
+        __lru_append(cache, s);
+    }
+    if (!async)
+    {
+        return 0;
+    }
+    if (mtx_init(&cache->mutex, mtx_plain) != thrd_success || cnd_init(&cache->queued) != thrd_success ||
+        cnd_init(&cache->done) != thrd_success)
+    {
+        fprintf(stderr, "Falha ao criar a sincronização da thread de E/S\n");
+        return 1;
+    }
+    if (thrd_create(&cache->helper, __io_helper, cache) != thrd_success)
+    {
+        fprintf(stderr, "Falha ao criar a thread de E/S\n");
+        mtx_destroy(&cache->mutex);
+        cnd_destroy(&cache->queued);
+        cnd_destroy(&cache->done);
+        return 1;
+    }
+    cache->async = 1;
+    return 0;
+}
+
+static void __cache_close(TileCache *cache)
+{
+    if (cache->async)
+    {
+        // a thread auxiliar termina os pedidos pendentes antes de sair
+        mtx_lock(&cache->mutex);
+        cache->stop = 1;
+        cnd_signal(&cache->queued);
+        mtx_unlock(&cache->mutex);
+        thrd_join(cache->helper, NULL);
+        mtx_destroy(&cache->mutex);
+        cnd_destroy(&cache->queued);
+        cnd_destroy(&cache->done);
+        cache->async = 0;
+    }
+    free(cache->slots);
+    free(cache->buffers);
+    free(cache->slot_of);
+    free(cache->queue);
+    close(cache->fd);
+}
+
+// grava a matriz inicial, uma linha de tiles por vez (contígua no arquivo), usando os
+// buffers do cache ainda vazio; cada linha de tiles percorre todas as arestas, o que
+// custa num_tiles × E, desprezível perto dos V³ do algoritmo
+static int __write_initial_tiles(TileCache *cache, Graph const *graph)
+{
+    size_t const b = cache->tile_size;
+    size_t const T = cache->num_tiles;
+    size_t const strip_elements = T * b * b;
+    double *strip = cache->buffers;
+    for (size_t ib = 0; ib < T; ib++)
+    {
+        size_t const i0 = ib * b;
+        size_t const ii = __tile_extent(cache, ib);
+        for (size_t e = 0; e < strip_elements; e++)
+        {
+            strip[e] = INFINITY;
+        }
+        for (size_t r = 0; r < ii; r++)
+        {
+            size_t const i = i0 + r;
+            strip[(i / b) * b * b + r * b + i % b] = 0.0;
+        }
+        for (size_t edge_index = 0; edge_index < graph->E; edge_index++)
+        {
+            Edge const edge = VecEdge_get(&graph->edge_list, edge_index);
+            if (edge.from < i0 || edge.from >= i0 + ii)
+            {
+                continue;
+            }
+            double *entry = strip + (edge.to / b) * b * b + (edge.from - i0) * b + edge.to % b;
+            if (edge.weight < *entry)
+            {
+                *entry = edge.weight;
+            }
+        }
+        if (__pwrite_all(cache->fd, strip, T * cache->tile_bytes, __tile_offset(cache, ib * T)) != 0)
+        {
+            return 1;
+        }
+        cache->stats.tiles_written += T;
+    }
+    return 0;
+}
+
+// ordem dos tiles da iteração kb: o diagonal, a linha e a coluna do pivô e depois os
+// demais, em sentido alternado a cada iteração (o começo da próxima varredura é o fim
+// desta, ainda no cache) e com a linha e a coluna de kb + 1, que a próxima iteração usa
+// primeiro, por último
+static size_t __round_schedule(size_t num_tiles, size_t kb, size_t *schedule)
+{
+    size_t const T = num_tiles;
+    size_t const next = kb + 1 < T ? kb + 1 : NO_TILE;
+    size_t count = 0;
+    schedule[count++] = kb * T + kb;
+    for (size_t b = 0; b < T; b++)
+    {
+        if (b != kb)
+        {
+            schedule[count++] = kb * T + b;
+            schedule[count++] = b * T + kb;
+        }
+    }
+    for (size_t step = 0; step < T * T; step++)
+    {
+        size_t const tile = kb % 2 == 0 ? step : T * T - 1 - step;
+        size_t const ib = tile / T;
+        size_t const jb = tile % T;
+        if (ib != kb && jb != kb && ib != next && jb != next)
+        {
+            schedule[count++] = tile;
+        }
+    }
+    if (next != NO_TILE)
+    {
+        for (size_t b = 0; b < T; b++)
+        {
+            if (b != kb && b != next)
+            {
+                schedule[count++] = next * T + b;
+                schedule[count++] = b * T + next;
+            }
+        }
+        schedule[count++] = next * T + next;
+    }
+    return count;
+}
+
+// Os tiles podem ter até OUT_OF_CORE_MAX_TILE_SIZE de lado: cada fase opera em sub-blocos
+// de FLOYD_WARSHALL_DEFAULT_TILE_SIZE, para que os operandos dos kernels continuem no cache
+// do processador como no fw-blocked. Linhas de tile_size elementos.
+
+static size_t __sub_extent(size_t s0, size_t n)
+{
+    return s0 + FLOYD_WARSHALL_DEFAULT_TILE_SIZE <= n ? FLOYD_WARSHALL_DEFAULT_TILE_SIZE : n - s0;
+}
+
+// fase 1: Floyd-Warshall em blocos dentro do tile diagonal D (kk × kk)
+static void __diagonal_tile(double *D, size_t ld, size_t kk)
+{
+    for (size_t s0 = 0; s0 < kk; s0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+    {
+        size_t const ss = __sub_extent(s0, kk);
+        double *pivot = D + s0 * ld + s0;
+        min_plus_block_dependent(pivot, ld, pivot, ld, pivot, ld, ss, ss, ss);
+        for (size_t t0 = 0; t0 < kk; t0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+        {
+            if (t0 != s0)
+            {
+                size_t const tt = __sub_extent(t0, kk);
+                double *row = D + s0 * ld + t0;
+                double *col = D + t0 * ld + s0;
+                min_plus_block_dependent(row, ld, pivot, ld, row, ld, ss, tt, ss);
+                min_plus_block_dependent(col, ld, col, ld, pivot, ld, tt, ss, ss);
+            }
+        }
+        for (size_t t0 = 0; t0 < kk; t0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+        {
+            for (size_t u0 = 0; u0 < kk; u0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+            {
+                if (t0 != s0 && u0 != s0)
+                {
+                    min_plus_block(D + t0 * ld + u0, ld, D + t0 * ld + s0, ld, D + s0 * ld + u0, ld,
+                                   __sub_extent(t0, kk), __sub_extent(u0, kk), __sub_extent(s0, kk));
+                }
+            }
+        }
+    }
+}
+
+// fase 2, linha do pivô: R (kk × jj) = min(R, D ⊗ R), com o diagonal D já pronto; as
+// linhas do sub-bloco s são fechadas primeiro e depois relaxam as demais
+static void __pivot_row_tile(double *R, double const *D, size_t ld, size_t kk, size_t jj)
+{
+    for (size_t s0 = 0; s0 < kk; s0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+    {
+        size_t const ss = __sub_extent(s0, kk);
+        double *rows = R + s0 * ld;
+        min_plus_block_dependent(rows, ld, D + s0 * ld + s0, ld, rows, ld, ss, jj, ss);
+        for (size_t t0 = 0; t0 < kk; t0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+        {
+            if (t0 != s0)
+            {
+                min_plus_block(R + t0 * ld, ld, D + t0 * ld + s0, ld, rows, ld, __sub_extent(t0, kk), jj, ss);
+            }
+        }
+    }
+}
+
+// fase 2, coluna do pivô: C (ii × kk) = min(C, C ⊗ D), idem por sub-blocos de colunas
+static void __pivot_col_tile(double *C, double const *D, size_t ld, size_t ii, size_t kk)
+{
+    for (size_t s0 = 0; s0 < kk; s0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+    {
+        size_t const ss = __sub_extent(s0, kk);
+        double *cols = C + s0;
+        min_plus_block_dependent(cols, ld, cols, ld, D + s0 * ld + s0, ld, ii, ss, ss);
+        for (size_t t0 = 0; t0 < kk; t0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+        {
+            if (t0 != s0)
+            {
+                min_plus_block(C + t0, ld, cols, ld, D + s0 * ld + t0, ld, ii, __sub_extent(t0, kk), ss);
+            }
+        }
+    }
+}
+
+// fase 3: C (ii × jj) = min(C, A (ii × kk) + B (kk × jj)) em fatias de k, para que a fatia
+// de B caiba no cache
+static void __min_plus_tile(double *C, double const *A, double const *B, size_t ld, size_t ii, size_t jj,
+                            size_t kk)
+{
+    for (size_t k0 = 0; k0 < kk; k0 += FLOYD_WARSHALL_DEFAULT_TILE_SIZE)
+    {
+        min_plus_block(C, ld, A + k0, ld, B + k0 * ld, ld, ii, jj, __sub_extent(k0, kk));
+    }
+}
+
+static void __add_tile_efficiency(EfficiencySum *sum, double const *tile, size_t tile_size, size_t i0,
+                                  size_t j0, size_t ii, size_t jj)
+{
+    for (size_t r = 0; r < ii; r++)
+    {
+        size_t const i = i0 + r;
+        // a diagonal da matriz só passa pelos tiles em que i cai entre as colunas
+        size_t const source = i >= j0 && i - j0 < jj ? i - j0 : SIZE_MAX;
+        EfficiencySum_add_row(sum, tile + r * tile_size, jj, source);
+    }
+}
+
+static size_t __choose_tile_size(size_t V, size_t memory_budget)
+{
+    size_t const unit = FLOYD_WARSHALL_DEFAULT_TILE_SIZE;
+    // linha e coluna do pivô, 2 V tile_size doubles, em metade do cache
+    size_t tile_size = memory_budget / (4 * V * sizeof(double)) / unit * unit;
+    if (tile_size < unit)
+    {
+        tile_size = unit;
+    }
+    if (tile_size > OUT_OF_CORE_MAX_TILE_SIZE)
+    {
+        tile_size = OUT_OF_CORE_MAX_TILE_SIZE;
+    }
+    return tile_size < V ? tile_size : V;
+}
+
+static int __run_rounds(TileCache *cache, size_t prefetch_depth, double *efficiency)
+{
+    size_t const b = cache->tile_size;
+    size_t const T = cache->num_tiles;
+    int status = 1;
+    size_t *schedule = malloc(T * T * sizeof(size_t));
+    double **pivot_row = malloc(T * sizeof(double *));
+    double **pivot_col = malloc(T * sizeof(double *));
+    if (schedule == NULL || pivot_row == NULL || pivot_col == NULL)
+    {
+        fprintf(stderr, "Falha na alocação da ordem dos tiles\n");
+        goto clean_up;
+    }
+    EfficiencySum sum;
+    EfficiencySum_init(&sum);
+    PROFILE_BEGIN(PROFILE_FW_OUT_OF_CORE);
+    PROFILE_THREAD_COUNTERS(counters);
+    PROFILE_THREAD_BEGIN(counters);
+    int failed = 0;
+    for (size_t kb = 0; kb < T && !failed; kb++)
+    {
+        size_t const kk = __tile_extent(cache, kb);
+        size_t const count = __round_schedule(T, kb, schedule);
+        for (size_t p = 0; p < count; p++)
+        {
+            for (size_t q = p + 1; q <= p + prefetch_depth && q < count; q++)
+            {
+                __prefetch(cache, schedule[q]);
+            }
+            size_t const tile = schedule[p];
+            size_t const ib = tile / T;
+            size_t const jb = tile % T;
+            size_t const ii = __tile_extent(cache, ib);
+            size_t const jj = __tile_extent(cache, jb);
+            double *C = __acquire(cache, tile);
+            if (C == NULL)
+            {
+                failed = 1;
+                break;
+            }
+            // fase 1 (diagonal) e fase 2 (linha e coluna do pivô): ficam presos até o fim
+            // da iteração, pois a fase 3 os lê
+            if (ib == kb && jb == kb)
+            {
+                __diagonal_tile(C, b, kk);
+                pivot_row[kb] = C;
+                pivot_col[kb] = C;
+            }
+            else if (ib == kb)
+            {
+                __pivot_row_tile(C, pivot_row[kb], b, kk, jj);
+                pivot_row[jb] = C;
+            }
+            else if (jb == kb)
+            {
+                __pivot_col_tile(C, pivot_row[kb], b, ii, kk);
+                pivot_col[ib] = C;
+            }
+            else
+            {
+                __min_plus_tile(C, pivot_col[ib], pivot_row[jb], b, ii, jj, kk);
+            }
+            // na última iteração cada tile fica pronto aqui: a eficiência dispensa outra leitura
+            if (kb + 1 == T)
+            {
+                __add_tile_efficiency(&sum, C, b, ib * b, jb * b, ii, jj);
+            }
+            if (ib != kb && jb != kb)
+            {
+                __release(cache, tile, 1);
+            }
+        }
+        for (size_t other = 0; other < T && !failed; other++)
+        {
+            __release(cache, kb * T + other, 1);
+            if (other != kb)
+            {
+                __release(cache, other * T + kb, 1);
+            }
+        }
+    }
+    PROFILE_THREAD_END(counters, PROFILE_FW_OUT_OF_CORE);
+    PROFILE_END(PROFILE_FW_OUT_OF_CORE);
+    if (!failed)
+    {
+        size_t const V = cache->V;
+        *efficiency = V > 1 ? EfficiencySum_value(&sum) / ((double)V * (double)(V - 1)) : 0.0;
+        status = 0;
+    }
+clean_up:
+    free(schedule);
+    free(pivot_row);
+    free(pivot_col);
+    return status;
+}
+
+int floyd_warshall_out_of_core(Graph const *graph, OutOfCoreOptions const *options, double *efficiency,
+                               OutOfCoreStats *stats)
+{
+    size_t const V = graph->V;
+    *efficiency = 0.0;
+    if (V == 0)
+    {
+        return 0;
+    }
+    size_t const tile_size =
+        options->tile_size != 0 ? options->tile_size : __choose_tile_size(V, options->memory_budget);
+    size_t const num_tiles = (V + tile_size - 1) / tile_size;
+    size_t const tile_bytes = tile_size * tile_size * sizeof(double);
+    // linha e coluna do pivô presas e o tile da fase 3
+    size_t const min_slots = num_tiles > 1 ? 2 * num_tiles : 1;
+    size_t num_slots = options->memory_budget / tile_bytes;
+    if (num_slots < min_slots)
+    {
+        fprintf(stderr, "Erro: o cache out-of-core precisa de pelo menos %zu MiB com tiles de %zu\n",
+                (min_slots * tile_bytes + ((size_t)1 << 20) - 1) >> 20, tile_size);
+        return 1;
+    }
+    if (num_slots > num_tiles * num_tiles)
+    {
+        num_slots = num_tiles * num_tiles;
+    }
+    size_t const prefetch_depth =
+        options->prefetch_depth < num_slots - min_slots ? options->prefetch_depth : num_slots - min_slots;
+    // a leitura antecipada só usa os slots além do mínimo (e é inútil se todos os tiles cabem)
+    if (prefetch_depth < options->prefetch_depth && num_slots < num_tiles * num_tiles)
+    {
+        if (prefetch_depth == 0)
+        {
+            fprintf(stderr, "Aviso: memória do cache out-of-core sem slots livres, leitura antecipada desativada\n");
+        }
+        else
+        {
+            fprintf(stderr, "Aviso: leitura antecipada out-of-core limitada a %zu tiles pela memória\n",
+                    prefetch_depth);
+        }
+    }
+
+    int const fd = __open_tile_file(options->path);
+    if (fd < 0)
+    {
+        return 1;
+    }
+    TileCache cache;
+    if (__cache_open(&cache, fd, V, tile_size, num_slots, prefetch_depth > 0) != 0)
+    {
+        __cache_close(&cache);
+        return 1;
+    }
+    int status =
+        __write_initial_tiles(&cache, graph) != 0 || __run_rounds(&cache, prefetch_depth, efficiency) != 0;
+    // com um arquivo escolhido pelo usuário ele fica com a matriz final
+    if (status == 0 && options->path != NULL)
+    {
+        status = __flush(&cache);
+    }
+    if (stats != NULL)
+    {
+        *stats = cache.stats;
+    }
+    __cache_close(&cache);
+    return status;
+}
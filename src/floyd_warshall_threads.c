@@ -0,0 +1,371 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <threads.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "graph_library.h"
+#include "min_plus.h"
+#include "numa_topology.h"
+#include "profiling.h"
+#include "threading.h"
+
+// Relaxação paralela das linhas de uma faixa da matriz de distâncias: para cada k
+// a thread 0 obtém a linha k (ponteiro para a própria matriz ou buffer recebido via
+// MPI) e todas as threads aplicam-na a blocos de linhas. A mesma implementação serve
+// às faixas em precisão dupla (MatrixDouble) e simples (MatrixFloat), e às faixas em
+// double com a matriz de próximos vértices (MatrixUInt32).
+
+// Com ThreadConfig.pinning e mais de um nó NUMA cada thread fica em uma CPU, e as linhas
+// da faixa são divididas em blocos contíguos por nó, proporcionais às threads de cada um.
+// As páginas de um bloco são tocadas primeiro pelas threads do seu nó
+// (floyd_warshall_first_touch) e, a cada k, só elas relaxam essas linhas; nos nós
+// diferentes do da thread 0 a primeira thread do nó copia a linha k para uma réplica
+// local, lida pelas demais em vez da linha remota.
+
+typedef struct
+{
+    size_t begin; // linhas [begin, end) da faixa
+    size_t end;
+    size_t leader;    // primeira thread do nó, que copia a linha k para a réplica
+    void *k_row_copy; // réplica da linha k; NULL no nó da thread 0 ou sem réplicas
+    // zerado pela thread 0 no início de cada iteração, antes da barreira que a abre
+    atomic_size_t next_row;
+} NodeRows;
+
+typedef struct
+{
+    void *data;
+    size_t nrows;
+    size_t ncols;
+    size_t row_bytes;
+    size_t first_k;
+    size_t num_k;
+    int single_precision;
+    uint32_t *next; // matriz de próximos vértices da faixa; NULL sem caminhos
+    KRowSource fetch_k_row;
+    KRowSourceFloat fetch_k_row_float;
+    void *context;
+    size_t chunk_size;
+    size_t num_threads;
+    ThreadPinning pinning;
+    NumaTopology topology;
+    size_t num_nodes;
+    NodeRows *nodes;
+    int replicated; // algum nó tem réplica da linha k
+    Barrier barrier;
+    void const *k_row;
+} StripRelaxation;
+
+static void const *__fetch_k_row(StripRelaxation const *job, size_t k)
+{
+    return job->single_precision ? (void const *)job->fetch_k_row_float(job->context, k)
+                                 : (void const *)job->fetch_k_row(job->context, k);
+}
+
+// k_row é a linha k a aplicar (talvez uma réplica) e own_row a original, que pode ser
+// uma das linhas da faixa
+static void __relax_rows(StripRelaxation const *job, void const *k_row, void const *own_row, size_t k,
+                         size_t begin, size_t end)
+{
+    size_t const V = job->ncols;
+    for (size_t i = begin; i < end; i++)
+    {
+        if (job->single_precision)
+        {
+            float *row = (float *)job->data + i * V;
+            if (row != own_row) // a linha k não muda passando por ela mesma
+            {
+                min_plus_row_float(row, k_row, row[k], V);
+            }
+        }
+        else
+        {
+            double *row = (double *)job->data + i * V;
+            if (row == own_row)
+            {
+                continue;
+            }
+            if (job->next != NULL)
+            {
+                // quem melhora passando por k segue o mesmo primeiro passo de i até k
+                uint32_t *next_row = job->next + i * V;
+                min_plus_row_next(row, next_row, k_row, row[k], next_row[k], V);
+            }
+            else
+            {
+                min_plus_row(row, k_row, row[k], V);
+            }
+        }
+    }
+}
+
+static void __free_nodes(StripRelaxation *job)
+{
+    for (size_t n = 0; job->nodes != NULL && n < job->num_nodes; n++)
+    {
+        free(job->nodes[n].k_row_copy);
+    }
+    free(job->nodes);
+    job->nodes = NULL;
+    if (job->pinning != PIN_NONE)
+    {
+        NumaTopology_free(&job->topology);
+    }
+}
+
+// divide as linhas entre os nós das num_threads threads; sem fixação, um nó só
+static int __setup_nodes(StripRelaxation *job, int replicate)
+{
+    job->num_nodes = 1;
+    job->replicated = 0;
+    if (job->pinning != PIN_NONE)
+    {
+        if (NumaTopology_detect(&job->topology) != 0)
+        {
+            return 1;
+        }
+        job->num_nodes = job->topology.num_nodes;
+    }
+    job->nodes = calloc(job->num_nodes, sizeof(NodeRows));
+    size_t *threads_per_node = calloc(job->num_nodes, sizeof(size_t));
+    if (job->nodes == NULL || threads_per_node == NULL)
+    {
+        fprintf(stderr, "Falha na alocação da divisão das linhas entre os nós NUMA\n");
+        free(threads_per_node);
+        __free_nodes(job);
+        return 1;
+    }
+    for (size_t t = job->num_threads; t-- > 0;)
+    {
+        size_t const node = NumaTopology_thread_node(&job->topology, job->pinning, t, NULL);
+        threads_per_node[node]++;
+        job->nodes[node].leader = t;
+    }
+    size_t const home = NumaTopology_thread_node(&job->topology, job->pinning, 0, NULL);
+    size_t threads_before = 0;
+    int status = 0;
+    for (size_t n = 0; n < job->num_nodes; n++)
+    {
+        NodeRows *node = &job->nodes[n];
+        node->begin = threads_before * job->nrows / job->num_threads;
+        threads_before += threads_per_node[n];
+        node->end = threads_before * job->nrows / job->num_threads;
+        atomic_init(&node->next_row, 0);
+        if (replicate && n != home && threads_per_node[n] > 0)
+        {
+            // alocada aqui, mas tocada pela primeira vez pelo líder do nó
+            size_t const bytes = (job->row_bytes + 63) / 64 * 64;
+            node->k_row_copy = aligned_alloc(64, bytes > 0 ? bytes : 64);
+            status |= node->k_row_copy == NULL;
+            job->replicated = 1;
+        }
+    }
+    free(threads_per_node);
+    if (status != 0)
+    {
+        fprintf(stderr, "Falha na alocação das réplicas da linha k\n");
+        __free_nodes(job);
+        return 1;
+    }
+    return 0;
+}
+
+static NodeRows *__pin_thread(StripRelaxation *job, size_t thread_id)
+{
+    int cpu;
+    size_t const node = NumaTopology_thread_node(&job->topology, job->pinning, thread_id, &cpu);
+    if (cpu >= 0)
+    {
+        pin_current_thread(cpu);
+    }
+    return &job->nodes[node];
+}
+
+// desfaz __pin_thread ao fim do trabalho; a thread 0 é a chamadora (ou a principal do
+// OpenMP, cujas threads sobrevivem à região), e a próxima detecção da topologia leria só
+// a CPU em que ela ficou
+static void __unpin_thread(StripRelaxation *job)
+{
+    if (job->pinning != PIN_NONE)
+    {
+        NumaTopology_restore_affinity(&job->topology);
+    }
+}
+
+// próximo bloco de linhas do nó; 0 quando elas acabaram
+static int __claim_rows(StripRelaxation *job, NodeRows *node, size_t *begin, size_t *end)
+{
+    size_t const offset = atomic_fetch_add(&node->next_row, job->chunk_size);
+    *begin = node->begin + offset;
+    if (offset >= node->end - node->begin)
+    {
+        return 0;
+    }
+    *end = *begin + job->chunk_size < node->end ? *begin + job->chunk_size : node->end;
+    return 1;
+}
+
+static int __relax_worker(void *arg, size_t thread_id)
+{
+    StripRelaxation *job = arg;
+    NodeRows *node = __pin_thread(job, thread_id);
+    PROFILE_THREAD_COUNTERS(counters);
+    PROFILE_THREAD_BEGIN(counters);
+    for (size_t k = job->first_k; k < job->num_k; k++)
+    {
+        if (thread_id == 0)
+        {
+            job->k_row = __fetch_k_row(job, k);
+            for (size_t n = 0; n < job->num_nodes; n++)
+            {
+                atomic_store(&job->nodes[n].next_row, 0);
+            }
+        }
+        Barrier_wait(&job->barrier);
+        void const *k_row = job->k_row;
+        if (job->replicated)
+        {
+            if (node->k_row_copy != NULL && thread_id == node->leader)
+            {
+                memcpy(node->k_row_copy, k_row, job->row_bytes);
+            }
+            Barrier_wait(&job->barrier);
+            k_row = node->k_row_copy != NULL ? node->k_row_copy : k_row;
+        }
+        size_t begin, end;
+        while (__claim_rows(job, node, &begin, &end))
+        {
+            __relax_rows(job, k_row, job->k_row, k, begin, end);
+        }
+        Barrier_wait(&job->barrier);
+    }
+    PROFILE_THREAD_END(counters, PROFILE_FW_RELAX);
+    __unpin_thread(job);
+    return 0;
+}
+
+// executa worker em num_threads threads do backend, depois de dividir as linhas entre os nós
+static int __run_strip_workers(StripRelaxation *job, ThreadConfig const *config, int replicate,
+                               int (*worker)(void *arg, size_t thread_id))
+{
+    size_t const num_threads = config->num_threads > 0 ? config->num_threads : 1;
+    job->num_threads = num_threads;
+    job->pinning = config->pinning;
+    job->nodes = NULL;
+    job->chunk_size = config->chunk_size > 0 ? config->chunk_size : 1;
+    if (__setup_nodes(job, replicate) != 0)
+    {
+        return 1;
+    }
+    if (Barrier_init(&job->barrier, num_threads) != 0)
+    {
+        fprintf(stderr, "Falha na criação da barreira entre threads\n");
+        __free_nodes(job);
+        return 1;
+    }
+    int const status = run_threads(config, num_threads, worker, job);
+    Barrier_destroy(&job->barrier);
+    __free_nodes(job);
+    return status;
+}
+
+static int __relax_strip_threads(StripRelaxation *job, ThreadConfig const *config)
+{
+    job->row_bytes = job->ncols * (job->single_precision ? sizeof(float) : sizeof(double));
+    if (config->backend == THREADS_OPENMP && config->pinning == PIN_NONE)
+    {
+#ifdef _OPENMP
+        size_t const num_threads = config->num_threads > 0 ? config->num_threads : 1;
+        void const *k_row = NULL;
+#pragma omp parallel num_threads(num_threads) shared(k_row)
+        {
+            PROFILE_THREAD_COUNTERS(counters);
+            PROFILE_THREAD_BEGIN(counters);
+            for (size_t k = job->first_k; k < job->num_k; k++)
+            {
+#pragma omp master
+                k_row = __fetch_k_row(job, k);
+#pragma omp barrier
+#pragma omp for schedule(runtime)
+                for (size_t i = 0; i < job->nrows; i++)
+                {
+                    __relax_rows(job, k_row, k_row, k, i, i + 1);
+                }
+            }
+            PROFILE_THREAD_END(counters, PROFILE_FW_RELAX);
+        }
+        return 0;
+#endif
+    }
+    job->k_row = NULL;
+    return __run_strip_workers(job, config, 1, __relax_worker);
+}
+
+static int __relax_strip(StripRelaxation *job, ThreadConfig const *config)
+{
+    PROFILE_BEGIN(PROFILE_FW_RELAX);
+    int const status = __relax_strip_threads(job, config);
+    PROFILE_END(PROFILE_FW_RELAX);
+    return status;
+}
+
+int floyd_warshall_relax_strip(MatrixDouble *strip, size_t num_k, KRowSource fetch_k_row, void *context,
+                               ThreadConfig const *config)
+{
+    return floyd_warshall_relax_strip_from(strip, 0, num_k, fetch_k_row, context, config);
+}
+
+int floyd_warshall_relax_strip_from(MatrixDouble *strip, size_t first_k, size_t num_k, KRowSource fetch_k_row,
+                                    void *context, ThreadConfig const *config)
+{
+    StripRelaxation job = {.data = strip->data, .nrows = strip->nrows, .ncols = strip->ncols,
+                           .first_k = first_k, .num_k = num_k, .single_precision = 0,
+                           .fetch_k_row = fetch_k_row, .context = context};
+    return __relax_strip(&job, config);
+}
+
+int floyd_warshall_relax_strip_paths(MatrixDouble *strip, MatrixUInt32 *next, size_t num_k, KRowSource fetch_k_row,
+                                     void *context, ThreadConfig const *config)
+{
+    StripRelaxation job = {.data = strip->data, .nrows = strip->nrows, .ncols = strip->ncols,
+                           .first_k = 0, .num_k = num_k, .single_precision = 0, .next = next->data,
+                           .fetch_k_row = fetch_k_row, .context = context};
+    return __relax_strip(&job, config);
+}
+
+int floyd_warshall_relax_strip_float(MatrixFloat *strip, size_t num_k, KRowSourceFloat fetch_k_row,
+                                     void *context, ThreadConfig const *config)
+{
+    StripRelaxation job = {.data = strip->data, .nrows = strip->nrows, .ncols = strip->ncols,
+                           .num_k = num_k, .single_precision = 1, .fetch_k_row_float = fetch_k_row,
+                           .context = context};
+    return __relax_strip(&job, config);
+}
+
+static int __first_touch_worker(void *arg, size_t thread_id)
+{
+    StripRelaxation *job = arg;
+    NodeRows *node = __pin_thread(job, thread_id);
+    size_t begin, end;
+    while (__claim_rows(job, node, &begin, &end))
+    {
+        memset((char *)job->data + begin * job->row_bytes, 0, (end - begin) * job->row_bytes);
+    }
+    __unpin_thread(job);
+    return 0;
+}
+
+int floyd_warshall_first_touch(void *data, size_t nrows, size_t row_bytes, ThreadConfig const *config)
+{
+    if (config->pinning == PIN_NONE || data == NULL)
+    {
+        return 0;
+    }
+    StripRelaxation job = {.data = data, .nrows = nrows, .row_bytes = row_bytes};
+    return __run_strip_workers(&job, config, 0, __first_touch_worker);
+}
@@ -0,0 +1,180 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <mpi.h>
+#include "graph_library.h"
+
+// Distribuição do grafo lido pelo processo raiz: em vez de replicar a edgelist inteira,
+// cada processo recebe com MPI_Scatterv apenas as arestas que lhe pertencem (engines
+// de Floyd-Warshall), ou o CSR já construído (engine dijkstra, que precisa do grafo
+// inteiro em todos os processos, mas com 12 bytes por aresta em vez de 24).
+
+_Static_assert(sizeof(size_t) == sizeof(uint64_t), "Edge é transmitida com campos MPI_UINT64_T");
+
+// maior MPI_Bcast por chamada, em elementos
+#define GRAPH_BCAST_CHUNK ((size_t)1 << 26)
+
+int Graph_edge_row_owner(void const *rows, Edge const *edge)
+{
+    return RowPartition_owner(rows, edge->from);
+}
+
+int Graph_edge_grid_owner(void const *grid, Edge const *edge)
+{
+    return GridPartition_owner(grid, edge->from, edge->to);
+}
+
+// tipo MPI com o layout de Edge, incluindo o preenchimento no fim da struct
+static void __create_edge_type(MPI_Datatype *edge_type)
+{
+    int const block_lengths[3] = {1, 1, 1};
+    MPI_Aint const displacements[3] = {offsetof(Edge, from), offsetof(Edge, to), offsetof(Edge, weight)};
+    MPI_Datatype const types[3] = {MPI_UINT64_T, MPI_UINT64_T, MPI_DOUBLE};
+    MPI_Datatype packed;
+    MPI_Type_create_struct(3, block_lengths, displacements, types, &packed);
+    MPI_Type_create_resized(packed, 0, sizeof(Edge), edge_type);
+    MPI_Type_commit(edge_type);
+    MPI_Type_free(&packed);
+}
+
+int Graph_scatter_edges(Graph *graph, EdgeOwnerFunction owner, void const *context, int root, MPI_Comm comm)
+{
+    int rank, nprocs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nprocs);
+    int status = 0;
+    int *counts = NULL;
+    int *displacements = NULL;
+    VecEdge send_buffer;
+    VecEdge_init(&send_buffer);
+    VecEdge local_edges;
+    VecEdge_init(&local_edges);
+
+    // o raiz agrupa as arestas por processo de destino (ordenação por contagem estável)
+    if (rank == root)
+    {
+        counts = calloc((size_t)nprocs, sizeof(int));
+        displacements = malloc((size_t)nprocs * sizeof(int));
+        size_t *next = calloc((size_t)nprocs, sizeof(size_t));
+        if (counts == NULL || displacements == NULL || next == NULL ||
+            VecEdge_resize(&send_buffer, graph->E) != 0)
+        {
+            fprintf(stderr, "Falha na alocação do buffer de distribuição das arestas\n");
+            status = 1;
+        }
+        else if (graph->E > INT_MAX)
+        {
+            fprintf(stderr, "Número de arestas grande demais para MPI_Scatterv\n");
+            status = 1;
+        }
+        else
+        {
+            for (size_t i = 0; i < graph->E; i++)
+            {
+                next[owner(context, &graph->edge_list.data[i])]++;
+            }
+            size_t offset = 0;
+            for (int p = 0; p < nprocs; p++)
+            {
+                counts[p] = (int)next[p];
+                displacements[p] = (int)offset;
+                next[p] = offset;
+                offset += (size_t)counts[p];
+            }
+            for (size_t i = 0; i < graph->E; i++)
+            {
+                Edge const edge = graph->edge_list.data[i];
+                send_buffer.data[next[owner(context, &edge)]++] = edge;
+            }
+            // a cópia agrupada substitui a original, que não é mais necessária
+            VecEdge_free(&graph->edge_list);
+        }
+        free(next);
+    }
+    MPI_Bcast(&status, 1, MPI_INT, root, comm);
+    if (status != 0)
+    {
+        goto clean_up;
+    }
+
+    int local_count = 0;
+    MPI_Scatter(counts, 1, MPI_INT, &local_count, 1, MPI_INT, root, comm);
+    if (VecEdge_resize(&local_edges, (size_t)local_count) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da edge list no processo %d\n", rank);
+        status = 1;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm);
+    if (status != 0)
+    {
+        goto clean_up;
+    }
+    MPI_Datatype edge_type;
+    __create_edge_type(&edge_type);
+    MPI_Scatterv(send_buffer.data, counts, displacements, edge_type, local_edges.data, local_count, edge_type,
+                 root, comm);
+    MPI_Type_free(&edge_type);
+
+    VecEdge_free(&graph->edge_list);
+    graph->edge_list = local_edges;
+    VecEdge_init(&local_edges);
+    graph->E = (size_t)local_count;
+
+clean_up:
+    VecEdge_free(&local_edges);
+    VecEdge_free(&send_buffer);
+    free(displacements);
+    free(counts);
+    return status;
+}
+
+static void __bcast_large(void *data, size_t count, size_t element_size, MPI_Datatype type, int root,
+                          MPI_Comm comm)
+{
+    for (size_t first = 0; first < count; first += GRAPH_BCAST_CHUNK)
+    {
+        size_t const chunk = count - first < GRAPH_BCAST_CHUNK ? count - first : GRAPH_BCAST_CHUNK;
+        MPI_Bcast((char *)data + first * element_size, (int)chunk, type, root, comm);
+    }
+}
+
+int Graph_broadcast_adjacency(Graph *graph, int root, MPI_Comm comm)
+{
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    uint64_t sizes[2] = {graph->V, graph->E};
+    MPI_Bcast(sizes, 2, MPI_UINT64_T, root, comm);
+
+    int status = 0;
+    AdjList *adj = &graph->adjacency_list;
+    if (rank == root)
+    {
+        status = adj->offsets == NULL;
+    }
+    else
+    {
+        Graph_destroy(graph);
+        graph->V = sizes[0];
+        graph->E = sizes[1];
+        adj->offsets = malloc((graph->V + 1) * sizeof(uint64_t));
+        adj->neighbors = malloc((graph->E > 0 ? graph->E : 1) * sizeof(uint32_t));
+        adj->weights = malloc((graph->E > 0 ? graph->E : 1) * sizeof(double));
+        status = adj->offsets == NULL || adj->neighbors == NULL || adj->weights == NULL;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm);
+    if (status != 0)
+    {
+        if (rank != root)
+        {
+            AdjList_free(adj);
+        }
+        fprintf(stderr, "Falha ao distribuir a lista de adjacência no processo %d\n", rank);
+        return 1;
+    }
+    __bcast_large(adj->offsets, graph->V + 1, sizeof(uint64_t), MPI_UINT64_T, root, comm);
+    __bcast_large(adj->neighbors, graph->E, sizeof(uint32_t), MPI_UINT32_T, root, comm);
+    __bcast_large(adj->weights, graph->E, sizeof(double), MPI_DOUBLE, root, comm);
+    return 0;
+}
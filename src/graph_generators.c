@@ -0,0 +1,190 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include "graph_library.h"
+#include "random.h"
+
+// Geradores de grafos sintéticos para o modo benchmark. Todos são determinísticos dada a
+// semente e deixam o grafo no mesmo estado que Graph_create_edgelist (edgelist com V e E
+// preenchidos, sem lista de adjacência), então seguem o caminho normal de distribuição.
+
+void GeneratorOptions_init(GeneratorOptions *options)
+{
+    options->kind = GENERATOR_ERDOS_RENYI;
+    options->V = 0;
+    options->E = 0;
+    options->min_weight = 1.0;
+    options->max_weight = 10.0;
+    options->seed = 1;
+    options->rmat[0] = 0.57;
+    options->rmat[1] = 0.19;
+    options->rmat[2] = 0.19;
+    options->rmat[3] = 0.05;
+}
+
+char const *GeneratorKind_name(GeneratorKind kind)
+{
+    switch (kind)
+    {
+    case GENERATOR_ERDOS_RENYI:
+        return "er";
+    case GENERATOR_RMAT:
+        return "rmat";
+    case GENERATOR_GRID:
+        return "grid";
+    }
+    return "?";
+}
+
+static double __random_weight(GeneratorOptions const *options, Random *random)
+{
+    return options->min_weight + (options->max_weight - options->min_weight) * Random_uniform(random);
+}
+
+// G(V, E): origem e destino uniformes, sem laços; arestas repetidas viram paralelas
+static void __generate_erdos_renyi(Graph *graph, GeneratorOptions const *options, Random *random)
+{
+    size_t const V = options->V;
+    for (size_t e = 0; e < graph->E; e++)
+    {
+        size_t from, to;
+        do
+        {
+            from = (size_t)(Random_next(random) % V);
+            to = (size_t)(Random_next(random) % V);
+        } while (from == to);
+        graph->edge_list.data[e] = (Edge){.from = from, .to = to, .weight = __random_weight(options, random)};
+    }
+}
+
+// R-MAT: cada aresta desce log2 V níveis da matriz de adjacência escolhendo um dos
+// quadrantes com probabilidades rmat[0..3]. Vértices fora de [0, V) são sorteados de
+// novo, e os ids passam por uma permutação aleatória para que os vértices de grau alto
+// não fiquem todos nas primeiras linhas (o que desequilibraria a partição em blocos).
+static int __generate_rmat(Graph *graph, GeneratorOptions const *options, Random *random)
+{
+    size_t const V = options->V;
+    size_t scale = 0;
+    while (((size_t)1 << scale) < V)
+    {
+        scale++;
+    }
+    size_t *permutation = malloc(V * sizeof(size_t));
+    if (permutation == NULL)
+    {
+        fprintf(stderr, "Falha na alocação da permutação do gerador R-MAT\n");
+        return 1;
+    }
+    for (size_t v = 0; v < V; v++)
+    {
+        permutation[v] = v;
+    }
+    Random_shuffle(random, permutation, V);
+
+    double const ab = options->rmat[0] + options->rmat[1];
+    double const abc = ab + options->rmat[2];
+    for (size_t e = 0; e < graph->E; e++)
+    {
+        size_t from, to;
+        do
+        {
+            from = 0;
+            to = 0;
+            for (size_t level = 0; level < scale; level++)
+            {
+                double const r = Random_uniform(random);
+                from = 2 * from + (r >= ab);
+                to = 2 * to + ((r >= options->rmat[0] && r < ab) || r >= abc);
+            }
+        } while (from >= V || to >= V || from == to);
+        graph->edge_list.data[e] = (Edge){.from = permutation[from], .to = permutation[to],
+                                          .weight = __random_weight(options, random)};
+    }
+    free(permutation);
+    return 0;
+}
+
+// grade com floor(sqrt(V)) linhas; cada vértice liga-se aos vizinhos da direita e de
+// baixo nos dois sentidos (a última linha pode ficar incompleta)
+static size_t __grid_columns(size_t V)
+{
+    size_t rows = (size_t)sqrt((double)V);
+    while (rows > 1 && rows * rows > V)
+    {
+        rows--;
+    }
+    return rows > 0 ? (V + rows - 1) / rows : 0;
+}
+
+static size_t __grid_edge_count(size_t V)
+{
+    size_t const cols = __grid_columns(V);
+    size_t count = 0;
+    for (size_t v = 0; v < V; v++)
+    {
+        count += (v % cols + 1 < cols && v + 1 < V) + (v + cols < V);
+    }
+    return 2 * count;
+}
+
+static void __generate_grid(Graph *graph, GeneratorOptions const *options, Random *random)
+{
+    size_t const V = options->V;
+    size_t const cols = __grid_columns(V);
+    size_t e = 0;
+    for (size_t v = 0; v < V; v++)
+    {
+        size_t const neighbors[2] = {v % cols + 1 < cols && v + 1 < V ? v + 1 : V, v + cols < V ? v + cols : V};
+        for (int n = 0; n < 2; n++)
+        {
+            if (neighbors[n] < V)
+            {
+                graph->edge_list.data[e++] = (Edge){.from = v, .to = neighbors[n],
+                                                    .weight = __random_weight(options, random)};
+                graph->edge_list.data[e++] = (Edge){.from = neighbors[n], .to = v,
+                                                    .weight = __random_weight(options, random)};
+            }
+        }
+    }
+}
+
+int Graph_generate(Graph *graph, GeneratorOptions const *options)
+{
+    size_t const V = options->V;
+    if (V < 2 || V > UINT32_MAX)
+    {
+        fprintf(stderr, "Número de vértices inválido para o gerador: %zu\n", V);
+        return 1;
+    }
+    if (!(options->min_weight > 0.0) || options->max_weight < options->min_weight)
+    {
+        fprintf(stderr, "Intervalo de pesos inválido: [%g, %g]\n", options->min_weight, options->max_weight);
+        return 1;
+    }
+    size_t const E = options->kind == GENERATOR_GRID ? __grid_edge_count(V)
+                     : options->E != 0               ? options->E
+                                                     : GENERATOR_DEFAULT_DEGREE * V;
+    if (VecEdge_resize(&graph->edge_list, E) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da edgelist do grafo gerado\n");
+        return 1;
+    }
+    graph->V = V;
+    graph->E = E;
+    Random random;
+    Random_init(&random, options->seed);
+    switch (options->kind)
+    {
+    case GENERATOR_ERDOS_RENYI:
+        __generate_erdos_renyi(graph, options, &random);
+        return 0;
+    case GENERATOR_RMAT:
+        return __generate_rmat(graph, options, &random);
+    case GENERATOR_GRID:
+        __generate_grid(graph, options, &random);
+        return 0;
+    }
+    return 1;
+}
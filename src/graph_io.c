@@ -0,0 +1,969 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "graph_library.h"
+
+// Leitura da edgelist: o arquivo é mapeado em memória e o corpo é dividido em blocos
+// que terminam em fim de linha. Uma primeira passada conta as arestas (linhas não
+// vazias) de cada bloco; com a soma de prefixos cada bloco sabe onde começam suas
+// arestas e a segunda passada as escreve diretamente no VecEdge já reservado.
+
+#define EDGELIST_MIN_CHUNK_BYTES ((size_t)1 << 20)
+
+typedef enum
+{
+    EDGELIST_OK,
+    EDGELIST_INVALID_FORMAT,
+    EDGELIST_INVALID_VERTEX,
+    EDGELIST_INVALID_WEIGHT,
+} EdgeListError;
+
+typedef struct
+{
+    char const *begin;
+    char const *end;
+    size_t first_edge; // índice global da primeira aresta do bloco
+    size_t num_edges;
+    EdgeListError error;
+    size_t error_edge; // primeira aresta inválida do bloco
+} EdgeListChunk;
+
+typedef struct
+{
+    EdgeListChunk *chunks;
+    size_t num_chunks;
+    size_t V;
+    size_t E;
+    Edge *edges;
+    int parse; // 0: contagem, 1: leitura
+} EdgeListJob;
+
+static int __is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static char const *__skip_blanks(char const *p, char const *end)
+{
+    while (p < end && __is_blank(*p))
+    {
+        p++;
+    }
+    return p;
+}
+
+static int __parse_size(char const **cursor, char const *end, size_t *value)
+{
+    char const *p = *cursor;
+    if (p < end && *p == '+')
+    {
+        p++;
+    }
+    char const *const digits = p;
+    size_t result = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        size_t const digit = (size_t)(*p - '0');
+        if (result > (SIZE_MAX - digit) / 10)
+        {
+            return 1;
+        }
+        result = result * 10 + digit;
+        p++;
+    }
+    if (p == digits)
+    {
+        return 1;
+    }
+    *value = result;
+    *cursor = p;
+    return 0;
+}
+
+static double const __powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Caminho rápido de Clinger: com mantissa < 2^53 e |expoente| <= 22 uma única
+// multiplicação ou divisão já é corretamente arredondada, igual ao strtod. Os demais
+// casos (muitos dígitos, expoentes grandes, inf, nan, hexadecimal) usam o strtod.
+static int __parse_double(char const **cursor, char const *end, double *value)
+{
+    char const *p = *cursor;
+    int negative = 0;
+    if (p < end && (*p == '+' || *p == '-'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+    uint64_t mantissa = 0;
+    int num_digits = 0;
+    int exponent = 0;
+    int any_digit = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        if (num_digits < 19)
+        {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            num_digits += mantissa != 0;
+        }
+        else
+        {
+            exponent++;
+            num_digits++;
+        }
+        any_digit = 1;
+        p++;
+    }
+    if (p < end && *p == '.')
+    {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            if (num_digits < 19)
+            {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                num_digits += mantissa != 0;
+                exponent--;
+            }
+            else
+            {
+                num_digits++;
+            }
+            any_digit = 1;
+            p++;
+        }
+    }
+    if (any_digit && p < end && (*p == 'e' || *p == 'E'))
+    {
+        char const *q = p + 1;
+        int exponent_negative = 0;
+        if (q < end && (*q == '+' || *q == '-'))
+        {
+            exponent_negative = *q == '-';
+            q++;
+        }
+        if (q < end && *q >= '0' && *q <= '9')
+        {
+            int explicit_exponent = 0;
+            while (q < end && *q >= '0' && *q <= '9')
+            {
+                explicit_exponent = explicit_exponent < 10000 ? explicit_exponent * 10 + (*q - '0') : 10000;
+                q++;
+            }
+            exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+            p = q;
+        }
+    }
+    int const token_ends = p == end || __is_blank(*p) || *p == '\n';
+    if (any_digit && token_ends && num_digits <= 19 && mantissa < ((uint64_t)1 << 53) && exponent >= -22 &&
+        exponent <= 22)
+    {
+        double result = (double)mantissa;
+        result = exponent < 0 ? result / __powers_of_ten[-exponent] : result * __powers_of_ten[exponent];
+        *value = negative ? -result : result;
+        *cursor = p;
+        return 0;
+    }
+
+    // o mapeamento não termina em '\0': o token é copiado antes do strtod
+    char token[128];
+    char const *token_end = *cursor;
+    while (token_end < end && !__is_blank(*token_end) && *token_end != '\n')
+    {
+        token_end++;
+    }
+    size_t const length = (size_t)(token_end - *cursor);
+    if (length == 0 || length >= sizeof(token))
+    {
+        return 1;
+    }
+    memcpy(token, *cursor, length);
+    token[length] = '\0';
+    char *parsed_end;
+    *value = strtod(token, &parsed_end);
+    if (parsed_end != token + length)
+    {
+        return 1;
+    }
+    *cursor = token_end;
+    return 0;
+}
+
+static void __count_chunk(EdgeListChunk *chunk)
+{
+    size_t num_edges = 0;
+    char const *p = chunk->begin;
+    while (p < chunk->end)
+    {
+        p = __skip_blanks(p, chunk->end);
+        if (p < chunk->end && *p != '\n')
+        {
+            num_edges++;
+            char const *newline = memchr(p, '\n', (size_t)(chunk->end - p));
+            p = newline != NULL ? newline : chunk->end;
+        }
+        if (p < chunk->end)
+        {
+            p++;
+        }
+    }
+    chunk->num_edges = num_edges;
+}
+
+static void __parse_chunk(EdgeListJob const *job, EdgeListChunk *chunk)
+{
+    size_t edge_index = chunk->first_edge;
+    char const *p = chunk->begin;
+    char const *const end = chunk->end;
+    chunk->error = EDGELIST_OK;
+    while (p < end && edge_index < job->E)
+    {
+        p = __skip_blanks(p, end);
+        if (p == end)
+        {
+            break;
+        }
+        if (*p == '\n')
+        {
+            p++;
+            continue;
+        }
+        Edge current_edge;
+        int invalid = __parse_size(&p, end, &current_edge.from);
+        p = __skip_blanks(p, end);
+        invalid = invalid || __parse_size(&p, end, &current_edge.to);
+        p = __skip_blanks(p, end);
+        invalid = invalid || __parse_double(&p, end, &current_edge.weight);
+        p = __skip_blanks(p, end);
+        if (invalid || (p < end && *p != '\n'))
+        {
+            chunk->error = EDGELIST_INVALID_FORMAT;
+        }
+        else if (current_edge.from >= job->V || current_edge.to >= job->V)
+        {
+            chunk->error = EDGELIST_INVALID_VERTEX;
+        }
+        else if (current_edge.weight <= 0)
+        {
+            chunk->error = EDGELIST_INVALID_WEIGHT;
+        }
+        if (chunk->error != EDGELIST_OK)
+        {
+            chunk->error_edge = edge_index;
+            return;
+        }
+        job->edges[edge_index++] = current_edge;
+        if (p < end)
+        {
+            p++;
+        }
+    }
+}
+
+static int __edgelist_worker(void *arg, size_t thread_id)
+{
+    EdgeListJob *job = arg;
+    if (thread_id < job->num_chunks)
+    {
+        if (job->parse)
+        {
+            __parse_chunk(job, &job->chunks[thread_id]);
+        }
+        else
+        {
+            __count_chunk(&job->chunks[thread_id]);
+        }
+    }
+    return 0;
+}
+
+static void __run_edgelist_pass(EdgeListJob *job, ThreadConfig const *threads)
+{
+    // a quantidade de blocos já é o número de threads
+    run_threads(threads, job->num_chunks, __edgelist_worker, job);
+}
+
+int Graph_create_edgelist_threaded(Graph *graph, char const *filename, ThreadConfig const *threads)
+{
+    int result = 1;
+    VecEdge edge_list;
+    VecEdge_init(&edge_list);
+    EdgeListJob job = {.chunks = NULL};
+    char *mapping = MAP_FAILED;
+    size_t file_size = 0;
+
+    int const fd = open(filename, O_RDONLY);
+    struct stat file_status;
+    if (fd < 0 || fstat(fd, &file_status) != 0)
+    {
+        fprintf(stderr, "O arquivo não conseguiu ser aberto\n");
+        goto clean_up;
+    }
+    file_size = (size_t)file_status.st_size;
+    if (file_size == 0)
+    {
+        fprintf(stderr, "Não foi possível ler o número de vérticies");
+        goto clean_up;
+    }
+    mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "O arquivo não conseguiu ser aberto\n");
+        goto clean_up;
+    }
+    madvise(mapping, file_size, MADV_SEQUENTIAL);
+    char const *const end = mapping + file_size;
+    char const *p = mapping;
+
+    size_t V, E;
+    while (p < end && (__is_blank(*p) || *p == '\n'))
+    {
+        p++;
+    }
+    if (__parse_size(&p, end, &V) != 0)
+    {
+        fprintf(stderr, "Não foi possível ler o número de vérticies");
+        goto clean_up;
+    };
+    while (p < end && (__is_blank(*p) || *p == '\n'))
+    {
+        p++;
+    }
+    if (__parse_size(&p, end, &E) != 0)
+    {
+        fprintf(stderr, "Não foi possível ler o número de edges");
+        goto clean_up;
+    };
+
+    if (VecEdge_reserve(&edge_list, E) != 0)
+    {
+        fprintf(stderr, "Alocação da edgelist não foi bem sucessida");
+        goto clean_up;
+    }
+
+    // blocos de pelo menos EDGELIST_MIN_CHUNK_BYTES, um por thread
+    size_t const body_size = (size_t)(end - p);
+    size_t const num_threads = threads->num_threads > 0 ? threads->num_threads : 1;
+    size_t const max_chunks = body_size / EDGELIST_MIN_CHUNK_BYTES + 1;
+    job.num_chunks = num_threads < max_chunks ? num_threads : max_chunks;
+    job.chunks = calloc(job.num_chunks, sizeof(EdgeListChunk));
+    job.V = V;
+    job.E = E;
+    job.edges = edge_list.data;
+    if (job.chunks == NULL)
+    {
+        fprintf(stderr, "Alocação da edgelist não foi bem sucessida");
+        goto clean_up;
+    }
+    char const *chunk_begin = p;
+    for (size_t c = 0; c < job.num_chunks; c++)
+    {
+        char const *chunk_end = end;
+        if (c + 1 < job.num_chunks)
+        {
+            chunk_end = p + (c + 1) * body_size / job.num_chunks;
+            chunk_end = chunk_end < chunk_begin ? chunk_begin : chunk_end;
+            char const *newline = memchr(chunk_end, '\n', (size_t)(end - chunk_end));
+            chunk_end = newline != NULL ? newline + 1 : end;
+        }
+        job.chunks[c].begin = chunk_begin;
+        job.chunks[c].end = chunk_end;
+        chunk_begin = chunk_end;
+    }
+
+    job.parse = 0;
+    __run_edgelist_pass(&job, threads);
+    size_t num_line = 0;
+    for (size_t c = 0; c < job.num_chunks; c++)
+    {
+        job.chunks[c].first_edge = num_line;
+        num_line += job.chunks[c].num_edges;
+    }
+    job.parse = 1;
+    __run_edgelist_pass(&job, threads);
+
+    // reporta o primeiro erro do arquivo, como a leitura sequencial faria
+    for (size_t c = 0; c < job.num_chunks; c++)
+    {
+        EdgeListChunk const *chunk = &job.chunks[c];
+        switch (chunk->error)
+        {
+        case EDGELIST_INVALID_FORMAT:
+            fprintf(stderr, "Linha %zu com formatação inválida", chunk->error_edge);
+            goto clean_up;
+        case EDGELIST_INVALID_VERTEX:
+            fprintf(stderr, "Erro: Vértice com índice inválido na linha %zu.\n", chunk->error_edge);
+            goto clean_up;
+        case EDGELIST_INVALID_WEIGHT:
+            fprintf(stderr, "Erro: Peso não-positivo na linha %zu.\n", chunk->error_edge);
+            goto clean_up;
+        default:
+            break;
+        }
+    }
+    if (num_line < E)
+    {
+        fprintf(stderr, "Número de edges incompatível com o arquivo fornecido\n");
+        goto clean_up;
+    };
+    VecEdge_resize(&edge_list, E);
+    graph->V = V;
+    graph->E = E;
+    graph->edge_list = edge_list;
+    result = 0;
+
+clean_up:
+    if (result != 0)
+    {
+        VecEdge_free(&edge_list);
+    }
+    free(job.chunks);
+    if (mapping != MAP_FAILED)
+    {
+        munmap(mapping, file_size);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return result;
+}
+
+int Graph_create_edgelist(Graph *graph, char const *filename)
+{
+    ThreadConfig threads;
+    ThreadConfig_init(&threads);
+    return Graph_create_edgelist_threaded(graph, filename, &threads);
+}
+
+int Graph_read_edge_updates(char const *filename, size_t V, VecEdge *updates)
+{
+    // arquivos de atualização são pequenos: fscanf basta, e strtod aceita "inf"
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Falha ao abrir o arquivo de atualizações '%s'\n", filename);
+        return 1;
+    }
+    int result = 0;
+    Edge edge;
+    int fields;
+    while ((fields = fscanf(file, "%zu %zu %lf", &edge.from, &edge.to, &edge.weight)) == 3)
+    {
+        if (edge.from >= V || edge.to >= V || !(edge.weight > 0.0))
+        {
+            fprintf(stderr, "Atualização inválida: %zu %zu %f\n", edge.from, edge.to, edge.weight);
+            result = 1;
+            break;
+        }
+        if (VecEdge_push_back(updates, edge) != 0)
+        {
+            fprintf(stderr, "Falha na alocação das atualizações\n");
+            result = 1;
+            break;
+        }
+    }
+    if (result == 0 && fields != EOF)
+    {
+        fprintf(stderr, "Erro de formato no arquivo de atualizações '%s'\n", filename);
+        result = 1;
+    }
+    fclose(file);
+    return result;
+}
+
+// Formato binário: cabeçalho de tamanho fixo seguido das seções, cada uma começando em
+// um múltiplo de GRAPH_BINARY_ALIGNMENT. Os inteiros são gravados na ordem de bytes da
+// máquina; byte_order permite recusar arquivos gerados com a ordem oposta.
+
+#define GRAPH_BINARY_MAGIC "MYGRAPH"
+#define GRAPH_BINARY_BYTE_ORDER 0x01020304u
+#define GRAPH_BINARY_MAX_SECTIONS 4
+
+typedef enum
+{
+    GRAPH_SECTION_OFFSETS = 1,   // uint64_t[V + 1]: vizinhos de v em [offsets[v], offsets[v + 1])
+    GRAPH_SECTION_NEIGHBORS = 2, // uint32_t[E]
+    GRAPH_SECTION_WEIGHTS = 3,   // double[E]
+    GRAPH_SECTION_COUNT
+} GraphSectionKind;
+
+typedef struct
+{
+    uint32_t kind;
+    uint32_t element_size;
+    uint64_t offset; // em bytes, a partir do início do arquivo
+    uint64_t count;  // número de elementos
+} GraphSection;
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t V;
+    uint64_t E;
+    uint32_t num_sections;
+    uint32_t reserved;
+    GraphSection sections[GRAPH_BINARY_MAX_SECTIONS];
+} GraphBinaryHeader;
+
+static uint64_t __align_offset(uint64_t offset)
+{
+    return (offset + GRAPH_BINARY_ALIGNMENT - 1) / GRAPH_BINARY_ALIGNMENT * GRAPH_BINARY_ALIGNMENT;
+}
+
+// confere a assinatura, a ordem de bytes e a versão do cabeçalho
+static int __check_binary_format(GraphBinaryHeader const *header)
+{
+    if (memcmp(header->magic, GRAPH_BINARY_MAGIC, sizeof(header->magic)) != 0)
+    {
+        fprintf(stderr, "O arquivo não está no formato binário do grafo\n");
+        return 1;
+    }
+    if (header->byte_order != GRAPH_BINARY_BYTE_ORDER)
+    {
+        fprintf(stderr, "O arquivo binário foi gerado com outra ordem de bytes\n");
+        return 1;
+    }
+    if (header->version != GRAPH_BINARY_VERSION)
+    {
+        fprintf(stderr, "Versão %u do formato binário não suportada\n", header->version);
+        return 1;
+    }
+    return 0;
+}
+
+// valida o cabeçalho contra o tamanho do arquivo e devolve as seções indexadas pelo tipo
+static int __check_binary_header(GraphBinaryHeader const *header, uint64_t file_size,
+                                 GraphSection const *sections[GRAPH_SECTION_COUNT])
+{
+    if (__check_binary_format(header) != 0)
+    {
+        return 1;
+    }
+    for (int kind = 0; kind < GRAPH_SECTION_COUNT; kind++)
+    {
+        sections[kind] = NULL;
+    }
+    for (uint32_t s = 0; s < header->num_sections && s < GRAPH_BINARY_MAX_SECTIONS; s++)
+    {
+        GraphSection const *section = &header->sections[s];
+        if (section->kind > 0 && section->kind < GRAPH_SECTION_COUNT)
+        {
+            sections[section->kind] = section;
+        }
+    }
+    uint32_t const element_sizes[GRAPH_SECTION_COUNT] = {0, sizeof(uint64_t), sizeof(uint32_t), sizeof(double)};
+    uint64_t const counts[GRAPH_SECTION_COUNT] = {0, header->V + 1, header->E, header->E};
+    for (int kind = 1; kind < GRAPH_SECTION_COUNT; kind++)
+    {
+        GraphSection const *section = sections[kind];
+        if (section == NULL || section->element_size != element_sizes[kind] || section->count != counts[kind])
+        {
+            fprintf(stderr, "Seções do arquivo binário inválidas\n");
+            return 1;
+        }
+        if (section->offset % GRAPH_BINARY_ALIGNMENT != 0 || section->offset > file_size ||
+            section->count > (file_size - section->offset) / section->element_size)
+        {
+            fprintf(stderr, "Arquivo binário truncado\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// os offsets precisam ser crescentes e terminar em E para que as faixas fiquem no arquivo
+static int __check_binary_offsets(uint64_t const *offsets, size_t V, size_t E)
+{
+    if (offsets[0] != 0 || offsets[V] != E)
+    {
+        fprintf(stderr, "Offsets do CSR inválidos no arquivo binário\n");
+        return 1;
+    }
+    for (size_t v = 0; v < V; v++)
+    {
+        if (offsets[v] > offsets[v + 1])
+        {
+            fprintf(stderr, "Offsets do CSR inválidos no arquivo binário\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// completa com zeros até o início da próxima seção e grava os count elementos de data
+static int __write_section(FILE *file, uint64_t *position, GraphSection const *section, void const *data)
+{
+    static char const zeros[GRAPH_BINARY_ALIGNMENT] = {0};
+    size_t const padding = (size_t)(section->offset - *position);
+    if (fwrite(zeros, 1, padding, file) != padding ||
+        (section->count > 0 && fwrite(data, section->element_size, section->count, file) != section->count))
+    {
+        return 1;
+    }
+    *position = section->offset + section->count * section->element_size;
+    return 0;
+}
+
+int Graph_write_binary(Graph const *graph, char const *filename)
+{
+    AdjList const *adj = &graph->adjacency_list;
+    if (adj->offsets == NULL)
+    {
+        fprintf(stderr, "A lista de adjacência precisa ser construída antes da conversão\n");
+        return 1;
+    }
+
+    GraphBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_BINARY_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_BINARY_VERSION;
+    header.byte_order = GRAPH_BINARY_BYTE_ORDER;
+    header.V = graph->V;
+    header.E = graph->E;
+    header.num_sections = 3;
+    void const *data[3] = {adj->offsets, adj->neighbors, adj->weights};
+    uint32_t const element_sizes[3] = {sizeof(uint64_t), sizeof(uint32_t), sizeof(double)};
+    uint64_t const counts[3] = {graph->V + 1, graph->E, graph->E};
+    uint64_t offset = sizeof(header);
+    for (int s = 0; s < 3; s++)
+    {
+        header.sections[s].kind = GRAPH_SECTION_OFFSETS + s;
+        header.sections[s].element_size = element_sizes[s];
+        header.sections[s].offset = __align_offset(offset);
+        header.sections[s].count = counts[s];
+        offset = header.sections[s].offset + counts[s] * element_sizes[s];
+    }
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "O arquivo %s não conseguiu ser criado\n", filename);
+        return 1;
+    }
+    int result = 1;
+    uint64_t position = sizeof(header);
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        goto clean_up;
+    }
+    for (int s = 0; s < 3; s++)
+    {
+        if (__write_section(file, &position, &header.sections[s], data[s]) != 0)
+        {
+            goto clean_up;
+        }
+    }
+    result = 0;
+
+clean_up:
+    if (fclose(file) != 0)
+    {
+        result = 1;
+    }
+    if (result != 0)
+    {
+        fprintf(stderr, "Falha ao escrever o arquivo binário %s\n", filename);
+    }
+    return result;
+}
+
+int Graph_is_binary_file(char const *filename)
+{
+    char magic[sizeof(((GraphBinaryHeader *)NULL)->magic)];
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        return 0;
+    }
+    size_t const read = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    return read == sizeof(magic) && memcmp(magic, GRAPH_BINARY_MAGIC, sizeof(magic)) == 0;
+}
+
+int Graph_read_binary_header(char const *filename, size_t *V, size_t *E)
+{
+    GraphBinaryHeader header;
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "O arquivo não conseguiu ser aberto\n");
+        return 1;
+    }
+    size_t const read = fread(&header, sizeof(header), 1, file);
+    fclose(file);
+    if (read != 1)
+    {
+        fprintf(stderr, "Arquivo binário truncado\n");
+        return 1;
+    }
+    if (__check_binary_format(&header) != 0)
+    {
+        return 1;
+    }
+    *V = header.V;
+    *E = header.E;
+    return 0;
+}
+
+int Graph_map_binary(Graph *graph, char const *filename)
+{
+    int result = 1;
+    char *mapping = MAP_FAILED;
+    size_t file_size = 0;
+
+    int const fd = open(filename, O_RDONLY);
+    struct stat file_status;
+    if (fd < 0 || fstat(fd, &file_status) != 0)
+    {
+        fprintf(stderr, "O arquivo não conseguiu ser aberto\n");
+        goto clean_up;
+    }
+    file_size = (size_t)file_status.st_size;
+    if (file_size < sizeof(GraphBinaryHeader))
+    {
+        fprintf(stderr, "Arquivo binário truncado\n");
+        goto clean_up;
+    }
+    mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "O arquivo não conseguiu ser aberto\n");
+        goto clean_up;
+    }
+    GraphBinaryHeader const *header = (GraphBinaryHeader const *)mapping;
+    GraphSection const *sections[GRAPH_SECTION_COUNT];
+    if (__check_binary_header(header, file_size, sections) != 0)
+    {
+        goto clean_up;
+    }
+    // somente leitura: o mapeamento é privado e com PROT_READ
+    AdjList adjlist;
+    adjlist.offsets = (uint64_t *)(mapping + sections[GRAPH_SECTION_OFFSETS]->offset);
+    adjlist.neighbors = (uint32_t *)(mapping + sections[GRAPH_SECTION_NEIGHBORS]->offset);
+    adjlist.weights = (double *)(mapping + sections[GRAPH_SECTION_WEIGHTS]->offset);
+    if (__check_binary_offsets(adjlist.offsets, header->V, header->E) != 0)
+    {
+        goto clean_up;
+    }
+
+    Graph_destroy(graph);
+    graph->V = header->V;
+    graph->E = header->E;
+    graph->adjacency_list = adjlist;
+    graph->mapping = mapping;
+    graph->mapping_size = file_size;
+    result = 0;
+
+clean_up:
+    if (result != 0 && mapping != MAP_FAILED)
+    {
+        munmap(mapping, file_size);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return result;
+}
+
+// maior leitura coletiva por chamada, em elementos
+#define GRAPH_BINARY_READ_CHUNK ((size_t)1 << 26)
+
+// Coletiva: lê para buffer os elementos [block_first[b], block_first[b] + block_lengths[b])
+// da seção, com um tipo hindexed como visão do arquivo; count é a soma de block_lengths
+static int __read_section_blocks(MPI_File file, GraphSection const *section, MPI_Datatype element_type,
+                                 size_t num_blocks, uint64_t const *block_first, int const *block_lengths,
+                                 MPI_Aint *displacements, void *buffer, size_t count, MPI_Comm comm)
+{
+    for (size_t b = 0; b < num_blocks; b++)
+    {
+        displacements[b] = (MPI_Aint)(block_first[b] * section->element_size);
+    }
+    MPI_Datatype file_type;
+    MPI_Type_create_hindexed((int)num_blocks, block_lengths, displacements, element_type, &file_type);
+    MPI_Type_commit(&file_type);
+    int failed = MPI_File_set_view(file, (MPI_Offset)section->offset, element_type, file_type, "native",
+                                   MPI_INFO_NULL) != MPI_SUCCESS;
+    unsigned long long num_reads = (count + GRAPH_BINARY_READ_CHUNK - 1) / GRAPH_BINARY_READ_CHUNK;
+    MPI_Allreduce(MPI_IN_PLACE, &num_reads, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, comm);
+    for (size_t r = 0; r < num_reads; r++)
+    {
+        size_t const first = r * GRAPH_BINARY_READ_CHUNK;
+        size_t chunk = first < count ? count - first : 0;
+        chunk = chunk < GRAPH_BINARY_READ_CHUNK ? chunk : GRAPH_BINARY_READ_CHUNK;
+        failed |= MPI_File_read_all(file, (char *)buffer + first * section->element_size, (int)chunk,
+                                    element_type, MPI_STATUS_IGNORE) != MPI_SUCCESS;
+    }
+    MPI_Type_free(&file_type);
+    return failed;
+}
+
+int Graph_read_binary_rows(Graph *graph, char const *filename, RowPartition const *rows, int part,
+                           MPI_Comm comm)
+{
+    int result = 1;
+    int local_ok = 0;
+    MPI_File file = MPI_FILE_NULL;
+    GraphBinaryHeader header;
+    GraphSection const *sections[GRAPH_SECTION_COUNT];
+    uint64_t *offsets = NULL;
+    uint64_t *block_first = NULL;
+    int *block_lengths = NULL;
+    MPI_Aint *displacements = NULL;
+    uint32_t *neighbors = NULL;
+    double *weights = NULL;
+    size_t const num_rows = RowPartition_count(rows, part);
+    size_t V = 0;
+    size_t local_edges = 0;
+    size_t num_blocks = 0;
+    VecEdge edge_list;
+    VecEdge_init(&edge_list);
+
+    if (MPI_File_open(comm, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS)
+    {
+        fprintf(stderr, "O arquivo não conseguiu ser aberto\n");
+        return 1;
+    }
+
+    // cada processo lê o cabeçalho e os offsets (O(V)) de forma independente; só as
+    // arestas das suas linhas são lidas com a leitura coletiva
+    MPI_Offset file_size = 0;
+    MPI_File_get_size(file, &file_size);
+    if ((size_t)file_size < sizeof(header) ||
+        MPI_File_read_at(file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE) != MPI_SUCCESS ||
+        __check_binary_header(&header, (uint64_t)file_size, sections) != 0)
+    {
+        goto clean_up;
+    }
+    V = header.V;
+    offsets = malloc((V + 1) * sizeof(uint64_t));
+    if (offsets == NULL)
+    {
+        fprintf(stderr, "Falha na alocação dos offsets do CSR no processo %d\n", part);
+        goto clean_up;
+    }
+    for (size_t first = 0; first < V + 1; first += GRAPH_BINARY_READ_CHUNK)
+    {
+        size_t const count = V + 1 - first < GRAPH_BINARY_READ_CHUNK ? V + 1 - first : GRAPH_BINARY_READ_CHUNK;
+        MPI_Offset const position = (MPI_Offset)(sections[GRAPH_SECTION_OFFSETS]->offset + first * sizeof(uint64_t));
+        if (MPI_File_read_at(file, position, offsets + first, (int)count, MPI_UINT64_T, MPI_STATUS_IGNORE) !=
+            MPI_SUCCESS)
+        {
+            fprintf(stderr, "Falha ao ler os offsets do CSR no processo %d\n", part);
+            goto clean_up;
+        }
+    }
+    if (__check_binary_offsets(offsets, V, header.E) != 0)
+    {
+        goto clean_up;
+    }
+
+    // linhas locais consecutivas no arquivo formam um único bloco da visão do arquivo
+    block_first = malloc((num_rows + 1) * sizeof(uint64_t));
+    block_lengths = malloc((num_rows + 1) * sizeof(int));
+    displacements = malloc((num_rows + 1) * sizeof(MPI_Aint));
+    if (block_first == NULL || block_lengths == NULL || displacements == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do tipo de leitura no processo %d\n", part);
+        goto clean_up;
+    }
+    size_t previous_end = SIZE_MAX;
+    for (size_t local = 0; local < num_rows; local++)
+    {
+        size_t const row = RowPartition_global_index(rows, part, local);
+        size_t const row_edges = offsets[row + 1] - offsets[row];
+        if (row_edges == 0)
+        {
+            continue;
+        }
+        if (row_edges > INT32_MAX)
+        {
+            fprintf(stderr, "Vértice %zu com vizinhos demais para a leitura com MPI-IO\n", row);
+            goto clean_up;
+        }
+        if (previous_end == offsets[row] && (size_t)block_lengths[num_blocks - 1] + row_edges <= INT32_MAX)
+        {
+            block_lengths[num_blocks - 1] += (int)row_edges;
+        }
+        else
+        {
+            block_first[num_blocks] = offsets[row];
+            block_lengths[num_blocks] = (int)row_edges;
+            num_blocks++;
+        }
+        previous_end = offsets[row + 1];
+        local_edges += row_edges;
+    }
+    neighbors = malloc((local_edges > 0 ? local_edges : 1) * sizeof(uint32_t));
+    weights = malloc((local_edges > 0 ? local_edges : 1) * sizeof(double));
+    if (neighbors == NULL || weights == NULL || VecEdge_reserve(&edge_list, local_edges) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da edge list no processo %d\n", part);
+        goto clean_up;
+    }
+    local_ok = 1;
+
+clean_up:
+    // as leituras das arestas são coletivas: os processos desistem juntos se algum falhou
+    MPI_Allreduce(MPI_IN_PLACE, &local_ok, 1, MPI_INT, MPI_MIN, comm);
+    if (local_ok)
+    {
+        int read_failed =
+            __read_section_blocks(file, sections[GRAPH_SECTION_NEIGHBORS], MPI_UINT32_T, num_blocks, block_first,
+                                  block_lengths, displacements, neighbors, local_edges, comm);
+        read_failed |=
+            __read_section_blocks(file, sections[GRAPH_SECTION_WEIGHTS], MPI_DOUBLE, num_blocks, block_first,
+                                  block_lengths, displacements, weights, local_edges, comm);
+
+        size_t next = 0;
+        for (size_t local = 0; local < num_rows && !read_failed; local++)
+        {
+            size_t const row = RowPartition_global_index(rows, part, local);
+            for (uint64_t n = offsets[row]; n < offsets[row + 1]; n++, next++)
+            {
+                Edge const edge = {.from = row, .to = neighbors[next], .weight = weights[next]};
+                if (edge.to >= V)
+                {
+                    fprintf(stderr, "Erro: Vértice com índice inválido no arquivo binário.\n");
+                    read_failed = 1;
+                    break;
+                }
+                if (VecEdge_push_back(&edge_list, edge) != 0)
+                {
+                    fprintf(stderr, "Falha na alocação da edge list no processo %d\n", part);
+                    read_failed = 1;
+                    break;
+                }
+            }
+        }
+        if (!read_failed)
+        {
+            Graph_destroy(graph);
+            graph->V = V;
+            graph->E = local_edges;
+            graph->edge_list = edge_list;
+            result = 0;
+        }
+    }
+    if (result != 0)
+    {
+        VecEdge_free(&edge_list);
+    }
+    free(weights);
+    free(neighbors);
+    free(displacements);
+    free(block_lengths);
+    free(block_first);
+    free(offsets);
+    MPI_File_close(&file);
+    return result;
+}
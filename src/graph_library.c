@@ -3,150 +3,42 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
 #include <mpi.h>
 #include "graph_library.h"
 
 #include "data_structures.h"
+#include "min_plus.h"
+#include "profiling.h"
+#include "floyd_warshall_common.h"
 
 IMPLEMENT_VECTOR_INTERFACE(Edge, VecEdge)
-IMPLEMENT_VECTOR_INTERFACE(VertexWithWeight, VecVertexWeight)
 IMPLEMENT_VECTOR_INTERFACE(double, VecDouble)
-IMPLEMENT_VECTOR_INTERFACE(SpanVertexWeight, VecSpanVertexWeight)
 IMPLEMENT_MATRIX_INTERFACE(double, MatrixDouble)
 
-void AdjList_init(AdjList *adjlist)
-{
-    VecSpanVertexWeight_init(&adjlist->neighboors);
-    VecVertexWeight_init(&adjlist->flatten_buffer);
-}
-void AdjList_free(AdjList *adjlist)
-{
-    VecSpanVertexWeight_free(&adjlist->neighboors);
-    VecVertexWeight_free(&adjlist->flatten_buffer);
-}
-
-int Graph_create_edgelist(Graph *graph, char const *filename)
-{
-    FILE *file = fopen(filename, "r");
-    VecEdge edge_list;
-    VecEdge_init(&edge_list);
-    if (file == NULL)
-    {
-        fprintf(stderr, "O arquivo não conseguiu ser aberto\n");
-        goto clean_up;
-    }
-    size_t V, E;
-    if (fscanf(file, "%zu", &V) != 1)
-    {
-        fprintf(stderr, "Não foi possível ler o número de vérticies");
-        goto clean_up;
-    };
-    if (fscanf(file, "%zu", &E) != 1)
-    {
-        fprintf(stderr, "Não foi possível ler o número de edges");
-        goto clean_up;
-    };
-
-    if (VecEdge_reserve(&edge_list, E) != 0)
-    {
-        fprintf(stderr, "Alocação da edgelist não foi bem sucessida");
-        goto clean_up;
-    }
-    size_t num_line = 0;
-    while (!feof(file) && num_line != E)
-    {
-        Edge current_edge;
-        if (fscanf(file, " %zu %zu %lf ",
-                   &current_edge.from,
-                   &current_edge.to,
-                   &current_edge.weight) != 3)
-        {
-            fprintf(stderr, "Linha %zu com formatação inválida", num_line);
-            goto clean_up;
-        };
-        if (current_edge.from >= V || current_edge.to >= V)
-        {
-            fprintf(stderr, "Erro: Vértice com índice inválido na linha %zu.\n", num_line);
-            goto clean_up;
-        }
-
-        if (current_edge.weight <= 0)
-        {
-            fprintf(stderr, "Erro: Peso não-positivo na linha %zu.\n", num_line);
-            goto clean_up;
-        }
-        VecEdge_push_back(&edge_list, current_edge);
-        num_line++;
-    };
-    if (num_line != E)
-    {
-        fprintf(stderr, "Número de edges incompatível com o arquivo fornecido\n");
-        goto clean_up;
-    };
-    graph->V = V;
-    graph->E = E;
-    graph->edge_list = edge_list;
-    return 0;
-clean_up:
-    VecEdge_free(&edge_list);
-    fclose(file);
-    return 1;
-}
-
-int Graph_create_adjacency_list(Graph *graph)
-{
-    if (!graph->edge_list.data)
-    {
-        fprintf(stderr, "A edgelist está vazia, não é possível criar a lista de adjacência\n");
-        return 1;
-    };
-    AdjList adjlist;
-    AdjList_init(&adjlist);
-    VecSpanVertexWeight_reserve(&adjlist.neighboors, graph->V);
-    VecVertexWeight_reserve(&adjlist.flatten_buffer, graph->E);
-
-    for (size_t i = 0; i < graph->V; i++)
-    {
-        SpanVertexWeight empty_element = {NULL, 0};
-        VecSpanVertexWeight_set(&adjlist.neighboors, i, empty_element);
-    }
-
-    size_t current_vertex = VecEdge_get(&graph->edge_list, 0).from;
-    VertexWithWeight *data_ptr = adjlist.flatten_buffer.data;
-    size_t num_neighbors = 0;
-
-    for (size_t i = 0; i < graph->E; i++)
-    {
-        Edge current_edge = VecEdge_get(&graph->edge_list, i);
-        if (current_vertex != current_edge.from)
-        {
-            SpanVertexWeight span = {.begin = data_ptr, .N = num_neighbors};
-            VecSpanVertexWeight_set(&adjlist.neighboors, current_vertex, span);
-            data_ptr += num_neighbors;
-            num_neighbors = 0;
-            current_vertex = current_edge.from;
-        }
-        num_neighbors++;
-        VertexWithWeight element = {.vertex_id = current_edge.to, .weight = current_edge.weight};
-        VecVertexWeight_set(&adjlist.flatten_buffer, i, element);
-    }
-    SpanVertexWeight last_span = {.begin = data_ptr, .N = num_neighbors};
-    VecSpanVertexWeight_set(&adjlist.neighboors, current_vertex, last_span);
-    graph->adjacency_list = adjlist;
-    return 0;
-}
-
 void Graph_init(Graph *graph)
 {
     graph->E = 0;
     graph->V = 0;
     VecEdge_init(&graph->edge_list);
     AdjList_init(&graph->adjacency_list);
+    graph->mapping = NULL;
+    graph->mapping_size = 0;
 }
 
 void Graph_destroy(Graph *graph)
 {
     VecEdge_free(&graph->edge_list);
+    if (graph->mapping != NULL)
+    {
+        // o CSR aponta para o mapeamento, que não foi alocado com malloc
+        AdjList_init(&graph->adjacency_list);
+        munmap(graph->mapping, graph->mapping_size);
+        graph->mapping = NULL;
+        graph->mapping_size = 0;
+    }
     AdjList_free(&graph->adjacency_list);
 }
 
@@ -154,7 +46,7 @@ int floyd_warshall(Graph const *graph, MatrixDouble *distances)
 {
     size_t const V = graph->V;
     size_t const E = graph->E;
-    if (MatrixDouble_init(distances, V,V) != 0)
+    if (MatrixDouble_init_aligned(distances, V, V, MATRIX_ALLOC_HUGE_PAGES) != 0)
     {
         fprintf(stderr, "Alocação da matriz de distância falhou");
         goto clean_up;
@@ -191,154 +83,517 @@ clean_up:
     return 1;
 }
 
+IMPLEMENT_FLOYD_WARSHALL_COMMON(double, MatrixDouble, MPI_DOUBLE, KRowBroadcast, )
 
-int floyd_warshall_openmpi(Graph const *graph, MatrixDouble *distances)
+int floyd_warshall_threaded(Graph const *graph, MatrixDouble *distances, ThreadConfig const *threads)
+{
+    if (__init_full_matrix(graph, distances, threads) != 0)
+    {
+        return 1;
+    }
+    if (floyd_warshall_relax_strip(distances, graph->V, __matrix_k_row, distances, threads) != 0)
+    {
+        MatrixDouble_free(distances);
+        return 1;
+    }
+    return 0;
+}
+
+// next(i, j) = j para as arestas e para a diagonal, PATH_NO_VERTEX para o resto
+static int __init_next_rows(MatrixDouble const *distances, MatrixUInt32 *next, RowPartition const *partition,
+                            int part)
+{
+    size_t const V = distances->ncols;
+    if (V >= UINT32_MAX)
+    {
+        fprintf(stderr, "A matriz de próximos vértices suporta no máximo %u vértices\n", UINT32_MAX - 1);
+        return 1;
+    }
+    if (MatrixUInt32_init(next, distances->nrows, V) != 0)
+    {
+        fprintf(stderr, "Alocação da matriz de próximos vértices falhou\n");
+        return 1;
+    }
+    for (size_t i = 0; i < distances->nrows; i++)
+    {
+        double const *row = distances->data + i * V;
+        uint32_t *next_row = next->data + i * V;
+        for (size_t j = 0; j < V; j++)
+        {
+            next_row[j] = isinf(row[j]) ? PATH_NO_VERTEX : (uint32_t)j;
+        }
+        size_t const self = RowPartition_global_index(partition, part, i);
+        next_row[self] = (uint32_t)self;
+    }
+    return 0;
+}
+
+int floyd_warshall_paths(Graph const *graph, MatrixDouble *distances, MatrixUInt32 *next,
+                         ThreadConfig const *threads)
+{
+    size_t const V = graph->V;
+    if (__init_full_matrix(graph, distances, NULL) != 0)
+    {
+        return 1;
+    }
+    RowPartition whole_matrix;
+    RowPartition_init(&whole_matrix, PARTITION_BLOCK, V, 1, 0);
+    if (__init_next_rows(distances, next, &whole_matrix, 0) != 0 ||
+        floyd_warshall_relax_strip_paths(distances, next, V, __matrix_k_row, distances, threads) != 0)
+    {
+        MatrixDouble_free(distances);
+        MatrixUInt32_free(next);
+        return 1;
+    }
+    return 0;
+}
+
+void FloydWarshallOptions_init(FloydWarshallOptions *options)
+{
+    options->partition = PARTITION_BLOCK;
+    options->block_size = FLOYD_WARSHALL_DEFAULT_TILE_SIZE;
+    options->pipelined = 0;
+    ThreadConfig_init(&options->threads);
+    CheckpointOptions_init(&options->checkpoint);
+}
+
+// processo 0: recebe as linhas de part diretamente nas suas posições da matriz completa
+static void __irecv_partition_rows(MatrixDouble *distances, RowPartition const *partition, int part,
+                                   MPI_Datatype row_type, MPI_Request *request)
+{
+    size_t const b = partition->block_size;
+    size_t const num_rows = RowPartition_count(partition, part);
+    size_t const num_blocks = (num_rows + b - 1) / b;
+    int *lengths = malloc(num_blocks * sizeof(int));
+    int *displs = malloc(num_blocks * sizeof(int));
+    for (size_t block = 0; block < num_blocks; block++)
+    {
+        size_t const local = block * b;
+        lengths[block] = (int)((local + b <= num_rows) ? b : num_rows - local);
+        displs[block] = (int)RowPartition_global_index(partition, part, local);
+    }
+    MPI_Datatype rows_type;
+    MPI_Type_indexed((int)num_blocks, lengths, displs, row_type, &rows_type);
+    MPI_Type_commit(&rows_type);
+    MPI_Irecv(distances->data, 1, rows_type, part, 0, MPI_COMM_WORLD, request);
+    MPI_Type_free(&rows_type);
+    free(lengths);
+    free(displs);
+}
+
+// o processo 0 recebe as linhas de todos os processos diretamente na matriz completa;
+// cada linha é um elemento do tipo derivado para que os contadores do MPI não
+// estourem int em grafos grandes
+static int __gather_row_strips(MatrixDouble const *local_distances, MatrixDouble *distances,
+                               RowPartition const *partition)
 {
     int rank, nprocs;
     int result = 1;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    size_t const V = local_distances->ncols;
+    int *counts = NULL;
+    int *displs = NULL;
+    MPI_Request *requests = NULL;
 
-    size_t const V = graph->V;
-    size_t const E = graph->E;
+    MPI_Datatype row_type;
+    MPI_Type_contiguous((int)V, MPI_DOUBLE, &row_type);
+    MPI_Type_commit(&row_type);
 
-    size_t rows_per_proc = V / nprocs;
-    size_t start_row = rank * rows_per_proc;
-    size_t num_rows = (rank != nprocs - 1) ? rows_per_proc : V - start_row;
-    
-    MatrixDouble local_distances;
-    MatrixDouble_init(&local_distances, 0, 0);  
-    
-    VecDouble k_row;
-    VecDouble_init(&k_row);
-    
-    if (MatrixDouble_init(&local_distances, num_rows, V) != 0)
+    if (rank == 0)
     {
-        fprintf(stderr, "Falha na alocação da matriz local no processo %d\n", rank);
-        goto cleanup;
+        counts = malloc(nprocs * sizeof(int));
+        displs = malloc(nprocs * sizeof(int));
+        requests = malloc(nprocs * sizeof(MPI_Request));
+        if (counts == NULL || displs == NULL || requests == NULL ||
+            MatrixDouble_init_aligned(distances, V, V, MATRIX_ALLOC_HUGE_PAGES) != 0)
+        {
+            fprintf(stderr, "Falha na alocação da matriz de distância completa");
+            goto cleanup;
+        }
+        for (int p = 0; p < nprocs; p++)
+        {
+            displs[p] = (int)RowPartition_block_start(partition, p);
+            counts[p] = (int)RowPartition_count(partition, p);
+        }
     }
 
-    for (size_t i = 0; i < num_rows; i++)
+    if (partition->kind == PARTITION_BLOCK)
     {
-        for (size_t j = 0; j < V; j++)
+        MPI_Gatherv(local_distances->data, (int)local_distances->nrows, row_type,
+                    rank == 0 ? distances->data : NULL, counts, displs, row_type,
+                    0, MPI_COMM_WORLD);
+    }
+    else if (rank == 0)
+    {
+        // linhas intercaladas: um tipo indexado por processo evita cópias intermediárias
+        requests[0] = MPI_REQUEST_NULL;
+        for (int p = 1; p < nprocs; p++)
         {
-            size_t global_i = start_row + i;
-            MatrixDouble_set(&local_distances, i, j, (global_i != j) ? INFINITY : 0.0);
+            __irecv_partition_rows(distances, partition, p, row_type, &requests[p]);
         }
+        for (size_t i = 0; i < local_distances->nrows; i++)
+        {
+            memcpy(distances->data + RowPartition_global_index(partition, 0, i) * V,
+                   local_distances->data + i * V, V * sizeof(double));
+        }
+        MPI_Waitall(nprocs, requests, MPI_STATUSES_IGNORE);
+    }
+    else
+    {
+        MPI_Send(local_distances->data, (int)local_distances->nrows, row_type, 0, 0, MPI_COMM_WORLD);
     }
+    result = 0;
 
-    for (size_t edge_index = 0; edge_index < E; edge_index++)
+cleanup:
+    MPI_Type_free(&row_type);
+    free(counts);
+    free(displs);
+    free(requests);
+    return result;
+}
+
+// soma de 1/d fora da diagonal nas linhas locais; o processo 0 recebe
+// a eficiência global já normalizada por V(V - 1)
+static void __reduce_efficiency_rows(MatrixDouble const *local_distances,
+                                     RowPartition const *partition, int rank, double *efficiency)
+{
+    size_t const V = local_distances->ncols;
+    EfficiencySum partial_sum;
+    EfficiencySum_init(&partial_sum);
+    for (size_t i = 0; i < local_distances->nrows; i++)
     {
-        Edge const edge = VecEdge_get(&graph->edge_list, edge_index);
-        if (edge.from >= start_row && edge.from < start_row + num_rows)
-        {
-            size_t local_i = edge.from - start_row;
-            MatrixDouble_set(&local_distances, local_i, edge.to, edge.weight);
-        }
+        EfficiencySum_add_row(&partial_sum, local_distances->data + i * V, V,
+                              RowPartition_global_index(partition, rank, i));
     }
+    *efficiency = global_efficiency(&partial_sum, V, 0, MPI_COMM_WORLD);
+}
 
-    if (VecDouble_reserve(&k_row, V) != 0)
+// sem distances a matriz completa nunca é reunida, apenas a eficiência global
+static int __collect_row_strips(MatrixDouble const *local_distances, RowPartition const *partition,
+                                int rank, MatrixDouble *distances, double *efficiency, RankTimings *timings)
+{
+    if (efficiency != NULL)
     {
-        fprintf(stderr, "Falha na alocação de buffer para comunicação MPI no processo %d\n", rank);
-        goto cleanup;
+        double const start = MPI_Wtime();
+        __reduce_efficiency_rows(local_distances, partition, rank, efficiency);
+        timings->reduce_time += MPI_Wtime() - start;
+    }
+    if (distances != NULL)
+    {
+        double const start = MPI_Wtime();
+        int const status = __gather_row_strips(local_distances, distances, partition);
+        timings->gather_time += MPI_Wtime() - start;
+        return status;
     }
-    VecDouble_resize(&k_row, V);
+    return 0;
+}
 
-    for (size_t k = 0; k < V; k++)
+// tempo de checkpoint conta como espera: a thread 0 não está calculando
+static void __checkpoint_step(Checkpoint *checkpoint, MatrixDouble const *local_distances, size_t k,
+                              RankTimings *timings)
+{
+    if (checkpoint != NULL)
     {
-        int owner = k / rows_per_proc;
-        if (owner >= nprocs) {
-            owner = nprocs - 1;  
-        }
+        double const start = MPI_Wtime();
+        Checkpoint_step(checkpoint, local_distances, k);
+        timings->wait_time += MPI_Wtime() - start;
+    }
+}
 
-        if (rank == owner)
-        {
-            size_t local_k = k - start_row;
-            for (size_t j = 0; j < V; j++)
-            {
-                VecDouble_set(&k_row, j, MatrixDouble_get(&local_distances, local_k, j));
-            }
-        }
+typedef struct
+{
+    KRowBroadcast broadcast;
+    Checkpoint *checkpoint; // NULL sem checkpoints
+} CheckpointedKRowBroadcast;
+
+// grava o checkpoint da iteração k, se for a hora, antes de difundir a linha k
+static double const *__checkpoint_and_broadcast_k_row(void *context, size_t k)
+{
+    CheckpointedKRowBroadcast *checkpointed = context;
+    KRowBroadcast *broadcast = &checkpointed->broadcast;
+    __checkpoint_step(checkpointed->checkpoint, broadcast->local_distances, k, broadcast->timings);
+    return __broadcast_k_row(broadcast, k);
+}
 
-        MPI_Bcast(k_row.data, V, MPI_DOUBLE, owner, MPI_COMM_WORLD);
+static int __floyd_warshall_1d_loop(MatrixDouble *local_distances, RowPartition const *partition,
+                                    int rank, double *k_row, ThreadConfig const *threads,
+                                    size_t first_k, Checkpoint *checkpoint, RankTimings *timings)
+{
+    CheckpointedKRowBroadcast broadcast = {
+        .broadcast = {.local_distances = local_distances, .partition = partition,
+                      .rank = rank, .k_row = k_row, .timings = timings},
+        .checkpoint = checkpoint};
+    double const wait_before = timings->wait_time;
+    double const start = MPI_Wtime();
+    int const status = floyd_warshall_relax_strip_from(local_distances, first_k, local_distances->ncols,
+                                                       __checkpoint_and_broadcast_k_row, &broadcast, threads);
+    timings->compute_time += MPI_Wtime() - start - (timings->wait_time - wait_before);
+    return status;
+}
 
-        for (size_t i = 0; i < num_rows; i++)
+// enquanto a linha k é aplicada, a linha k + 1 já está em trânsito no outro buffer
+static void __floyd_warshall_pipelined_loop(MatrixDouble *local_distances, RowPartition const *partition,
+                                            int rank, double *k_rows[2], size_t first_k, Checkpoint *checkpoint,
+                                            RankTimings *timings)
+{
+    size_t const V = local_distances->ncols;
+    PROFILE_BEGIN(PROFILE_FW_PIPELINED);
+    PROFILE_THREAD_COUNTERS(counters);
+    PROFILE_THREAD_BEGIN(counters);
+    if (first_k < V)
+    {
+        int const owner = RowPartition_owner(partition, first_k);
+        if (rank == owner)
         {
-            for (size_t j = 0; j < V; j++)
-            {
-                double current_dist = MatrixDouble_get(&local_distances, i, j);
-                double new_dist = MatrixDouble_get(&local_distances, i, k) + VecDouble_get(&k_row, j);
-                if (new_dist < current_dist)
-                {
-                    MatrixDouble_set(&local_distances, i, j, new_dist);
-                }
-            }
+            memcpy(k_rows[first_k % 2], local_distances->data + RowPartition_local_index(partition, first_k) * V,
+                   V * sizeof(double));
         }
+        double const wait_start = MPI_Wtime();
+        MPI_Bcast(k_rows[first_k % 2], V, MPI_DOUBLE, owner, MPI_COMM_WORLD);
+        timings->wait_time += MPI_Wtime() - wait_start;
     }
 
-    if (rank == 0)
+    for (size_t k = first_k; k < V; k++)
     {
-        if (MatrixDouble_init(distances, V, V) != 0)
-        {
-            fprintf(stderr, "Falha na alocação da matriz de distância completa");
-            goto cleanup;
-        }
+        // no início da iteração k todas as linhas locais já receberam as iterações 0..k-1
+        __checkpoint_step(checkpoint, local_distances, k, timings);
+        double const compute_start = MPI_Wtime();
+        double const *k_row = k_rows[k % 2];
+        double *next_row = k_rows[(k + 1) % 2];
+        size_t local_next = SIZE_MAX;
+        MPI_Request request = MPI_REQUEST_NULL;
 
-        for (size_t i = 0; i < num_rows; i++)
+        if (k + 1 < V)
         {
-            for (size_t j = 0; j < V; j++)
+            // o dono da linha k + 1 a relaxa primeiro para publicá-la o quanto antes
+            int const next_owner = RowPartition_owner(partition, k + 1);
+            if (rank == next_owner)
             {
-                MatrixDouble_set(distances, start_row + i, j, MatrixDouble_get(&local_distances, i, j));
+                local_next = RowPartition_local_index(partition, k + 1);
+                double *row = local_distances->data + local_next * V;
+                min_plus_row(row, k_row, row[k], V);
+                memcpy(next_row, row, V * sizeof(double));
             }
+            MPI_Ibcast(next_row, V, MPI_DOUBLE, next_owner, MPI_COMM_WORLD, &request);
         }
 
-        for (int p = 1; p < nprocs; p++)
+        for (size_t i = 0; i < local_distances->nrows; i++)
         {
-            size_t p_start_row = p * rows_per_proc;
-            size_t p_local_rows;
-            
-            if (p == nprocs - 1) {
-                p_local_rows = V - p_start_row;
-            } else {
-                p_local_rows = rows_per_proc;
+            if (i == local_next)
+            {
+                continue;
             }
-
-            MatrixDouble recv_buffer;
-            if (MatrixDouble_init(&recv_buffer, p_local_rows, V) != 0)
+            double *row = local_distances->data + i * V;
+            min_plus_row(row, k_row, row[k], V);
+            if (i % 64 == 63) // permite que a biblioteca MPI progrida a transmissão
             {
-                fprintf(stderr, "Falha na alocação do buffer de recepção");
-                MatrixDouble_free(distances);
-                goto cleanup;
+                int done;
+                MPI_Test(&request, &done, MPI_STATUS_IGNORE);
             }
+        }
+        double const wait_start = MPI_Wtime();
+        timings->compute_time += wait_start - compute_start;
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+        timings->wait_time += MPI_Wtime() - wait_start;
+    }
+    PROFILE_THREAD_END(counters, PROFILE_FW_PIPELINED);
+    PROFILE_END(PROFILE_FW_PIPELINED);
+}
+
+int floyd_warshall_openmpi_with_options(Graph const *graph, FloydWarshallOptions const *options,
+                                        MatrixDouble *distances, double *efficiency,
+                                        RankTimings *timings)
+{
+    int rank, nprocs;
+    int result = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
 
-            MPI_Recv(recv_buffer.data, p_local_rows * V, MPI_DOUBLE, p, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    size_t const V = graph->V;
+    RowPartition partition;
+    RowPartition_init(&partition, options->partition, V, nprocs, options->block_size);
+    size_t const num_rows = RowPartition_count(&partition, rank);
+    RankTimings local_timings = {0.0, 0.0, 0.0, 0.0};
 
-            for (size_t i = 0; i < p_local_rows; i++)
-            {
-                for (size_t j = 0; j < V; j++)
-                {
-                    MatrixDouble_set(distances, p_start_row + i, j, MatrixDouble_get(&recv_buffer, i, j));
-                }
-            }
-            MatrixDouble_free(&recv_buffer);
+    MatrixDouble local_distances;
+    MatrixDouble_init(&local_distances, 0, 0);
+
+    VecDouble k_rows[2];
+    VecDouble_init(&k_rows[0]);
+    VecDouble_init(&k_rows[1]);
+    Checkpoint checkpoint;
+    int checkpointing = 0;
+    size_t first_k = 0;
+
+    if (MatrixDouble_init_aligned(&local_distances, num_rows, V, MATRIX_ALLOC_HUGE_PAGES) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da matriz local no processo %d\n", rank);
+        goto cleanup;
+    }
+    // o fw-pipelined relaxa a faixa só na thread 0
+    if (!options->pipelined &&
+        floyd_warshall_first_touch(local_distances.data, num_rows, V * sizeof(double), &options->threads) != 0)
+    {
+        goto cleanup;
+    }
+    __init_distance_rows(graph, &local_distances, &partition, rank);
+
+    if (VecDouble_resize(&k_rows[0], V) != 0 ||
+        (options->pipelined && VecDouble_resize(&k_rows[1], V) != 0))
+    {
+        fprintf(stderr, "Falha na alocação de buffer para comunicação MPI no processo %d\n", rank);
+        goto cleanup;
+    }
+    // com --resume a faixa inicial é substituída pela do checkpoint
+    if (options->checkpoint.path != NULL)
+    {
+        if (Checkpoint_open(&checkpoint, &options->checkpoint, &local_distances, &partition, rank,
+                            MPI_COMM_WORLD, &first_k) != 0)
+        {
+            goto cleanup;
         }
+        checkpointing = 1;
     }
-    else
+
+    if (options->pipelined)
     {
-        MPI_Send(local_distances.data, num_rows * V, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD);
+        double *buffers[2] = {k_rows[0].data, k_rows[1].data};
+        __floyd_warshall_pipelined_loop(&local_distances, &partition, rank, buffers, first_k,
+                                        checkpointing ? &checkpoint : NULL, &local_timings);
+    }
+    else if (__floyd_warshall_1d_loop(&local_distances, &partition, rank, k_rows[0].data, &options->threads,
+                                      first_k, checkpointing ? &checkpoint : NULL, &local_timings) != 0)
+    {
+        goto cleanup;
+    }
+    if (checkpointing)
+    {
+        // confirma a última gravação e libera a cópia da faixa antes da coleta
+        Checkpoint_close(&checkpoint);
+        checkpointing = 0;
     }
 
-    result = 0;  
+    if (__collect_row_strips(&local_distances, &partition, rank, distances, efficiency, &local_timings) != 0)
+    {
+        goto cleanup;
+    }
+
+    result = 0;
 
 cleanup:
+    if (checkpointing)
+    {
+        Checkpoint_close(&checkpoint);
+    }
+    if (timings != NULL)
+    {
+        *timings = local_timings;
+    }
     MatrixDouble_free(&local_distances);
+    VecDouble_free(&k_rows[0]);
+    VecDouble_free(&k_rows[1]);
+    return result;
+}
+
+int floyd_warshall_openmpi_paths(Graph const *graph, FloydWarshallOptions const *options, DistributedPaths *paths,
+                                 RankTimings *timings)
+{
+    int rank, nprocs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    size_t const V = graph->V;
+    RowPartition_init(&paths->partition, options->partition, V, nprocs, options->block_size);
+    paths->rank = rank;
+    MatrixDouble_init(&paths->local_distances, 0, 0);
+    MatrixUInt32_init(&paths->local_next, 0, 0);
+    if (options->pipelined)
+    {
+        fprintf(stderr, "O Floyd-Warshall com pipeline não tem variante com caminhos\n");
+        return 1;
+    }
+
+    int result = 1;
+    RankTimings local_timings = {0.0, 0.0, 0.0, 0.0};
+    VecDouble k_row;
+    VecDouble_init(&k_row);
+    if (MatrixDouble_init_aligned(&paths->local_distances, RowPartition_count(&paths->partition, rank), V,
+                                  MATRIX_ALLOC_HUGE_PAGES) != 0 ||
+        VecDouble_resize(&k_row, V) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da matriz local no processo %d\n", rank);
+        goto cleanup;
+    }
+    if (floyd_warshall_first_touch(paths->local_distances.data, paths->local_distances.nrows, V * sizeof(double),
+                                   &options->threads) != 0)
+    {
+        goto cleanup;
+    }
+    __init_distance_rows(graph, &paths->local_distances, &paths->partition, rank);
+    if (__init_next_rows(&paths->local_distances, &paths->local_next, &paths->partition, rank) != 0)
+    {
+        goto cleanup;
+    }
+
+    KRowBroadcast broadcast = {.local_distances = &paths->local_distances, .partition = &paths->partition,
+                               .rank = rank, .k_row = k_row.data, .timings = &local_timings};
+    double const start = MPI_Wtime();
+    if (floyd_warshall_relax_strip_paths(&paths->local_distances, &paths->local_next, V, __broadcast_k_row,
+                                         &broadcast, &options->threads) != 0)
+    {
+        goto cleanup;
+    }
+    local_timings.compute_time += MPI_Wtime() - start - local_timings.wait_time;
+    result = 0;
+
+cleanup:
+    if (result != 0)
+    {
+        DistributedPaths_free(paths);
+    }
+    if (timings != NULL)
+    {
+        *timings = local_timings;
+    }
     VecDouble_free(&k_row);
     return result;
 }
 
-int dijkstra(Graph const *graph, size_t source, VecDouble *distances)
+int floyd_warshall_openmpi(Graph const *graph, MatrixDouble *distances)
+{
+    FloydWarshallOptions options;
+    FloydWarshallOptions_init(&options);
+    return floyd_warshall_openmpi_with_options(graph, &options, distances, NULL, NULL);
+}
+
+int floyd_warshall_openmpi_efficiency(Graph const *graph, double *efficiency)
+{
+    FloydWarshallOptions options;
+    FloydWarshallOptions_init(&options);
+    return floyd_warshall_openmpi_with_options(graph, &options, NULL, efficiency, NULL);
+}
+
+int floyd_warshall_openmpi_pipelined(Graph const *graph, MatrixDouble *distances, RankTimings *timings)
+{
+    FloydWarshallOptions options;
+    FloydWarshallOptions_init(&options);
+    options.pipelined = 1;
+    return floyd_warshall_openmpi_with_options(graph, &options, distances, NULL, timings);
+}
+
+int floyd_warshall_openmpi_pipelined_efficiency(Graph const *graph, double *efficiency, RankTimings *timings)
 {
-    if (graph->adjacency_list.flatten_buffer.data == NULL)
+    FloydWarshallOptions options;
+    FloydWarshallOptions_init(&options);
+    options.pipelined = 1;
+    return floyd_warshall_openmpi_with_options(graph, &options, NULL, efficiency, timings);
+}
+
+// validações comuns aos algoritmos de fonte única; deixa distances com V entradas
+// infinitas, exceto a fonte
+static int __prepare_distances(Graph const *graph, size_t source, VecDouble *distances)
+{
+    if (graph->adjacency_list.offsets == NULL)
     {
         fprintf(stderr, "A lista de adjacência está vazia, não é possível executar o algoritmo de Dijkstra\n");
         return 1;
@@ -358,37 +613,519 @@ int dijkstra(Graph const *graph, size_t source, VecDouble *distances)
             return 1;
         };
     }
-    VecDouble_resize(distances, 0);
-    MinHeap heap;
-    MinHeap_init(&heap);
+    VecDouble_resize(distances, V);
     for (size_t i = 0; i < V; i++)
     {
-        double const distance = i != source ? INFINITY : 0;
-        MinHeap_add(&heap, i, distance);
-        VecDouble_push_back(distances, distance);
-    };
+        distances->data[i] = INFINITY;
+    }
+    distances->data[source] = 0.0;
+    return 0;
+}
+
+// parents == NULL nas chamadas sem caminhos: com a função expandida em cada chamador o
+// teste some do laço interno
+static inline int __dijkstra_with_queue(Graph const *graph, size_t source, VecDouble *distances,
+                                        PriorityQueue *queue, uint32_t *parents)
+{
+    if (__prepare_distances(graph, source, distances) != 0 || PriorityQueue_reserve(queue, graph->V) != 0)
+    {
+        return 1;
+    }
+    double *dist = distances->data;
+    // cópias locais: as chamadas à fila não podem invalidá-las
+    uint64_t const *const offsets = graph->adjacency_list.offsets;
+    uint32_t const *const neighbors = graph->adjacency_list.neighbors;
+    double const *const weights = graph->adjacency_list.weights;
+
+    // os vértices só entram na fila quando alcançados pela primeira vez
+    PriorityQueue_clear(queue);
+    PriorityQueue_push(queue, source, 0.0);
+    while (!PriorityQueue_is_empty(queue))
+    {
+        size_t vertex_id;
+        double const d_j = PriorityQueue_pop(queue, &vertex_id);
+        if (d_j > dist[vertex_id]) // entrada obsoleta da fila preguiçosa
+        {
+            continue;
+        }
+        uint64_t const end = offsets[vertex_id + 1];
+        for (uint64_t n = offsets[vertex_id]; n < end; n++)
+        {
+            uint32_t const neighbor = neighbors[n];
+            double const new_distance = d_j + weights[n];
+            if (new_distance < dist[neighbor])
+            {
+                dist[neighbor] = new_distance;
+                if (parents != NULL)
+                {
+                    parents[neighbor] = (uint32_t)vertex_id;
+                }
+                if (PriorityQueue_push(queue, neighbor, new_distance) != 0)
+                {
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int dijkstra_with_queue(Graph const *graph, size_t source, VecDouble *distances, PriorityQueue *queue)
+{
+    return __dijkstra_with_queue(graph, source, distances, queue, NULL);
+}
+
+int dijkstra(Graph const *graph, size_t source, VecDouble *distances)
+{
+    PriorityQueue queue;
+    PriorityQueue_init(&queue, PRIORITY_QUEUE_DEFAULT);
+    int const result = dijkstra_with_queue(graph, source, distances, &queue);
+    PriorityQueue_free(&queue);
+    return result;
+}
+
+int dijkstra_paths(Graph const *graph, size_t source, VecDouble *distances, VecUInt32 *parents)
+{
+    if (graph->V >= UINT32_MAX)
+    {
+        fprintf(stderr, "O vetor de predecessores suporta no máximo %u vértices\n", UINT32_MAX - 1);
+        return 1;
+    }
+    if (VecUInt32_resize(parents, graph->V) != 0)
+    {
+        fprintf(stderr, "Alocação do vetor de predecessores falhou\n");
+        return 1;
+    }
+    for (size_t v = 0; v < graph->V; v++)
+    {
+        parents->data[v] = PATH_NO_VERTEX;
+    }
+    if (source < graph->V)
+    {
+        parents->data[source] = (uint32_t)source;
+    }
+    PriorityQueue queue;
+    PriorityQueue_init(&queue, PRIORITY_QUEUE_DEFAULT);
+    int const result = __dijkstra_with_queue(graph, source, distances, &queue, parents->data);
+    PriorityQueue_free(&queue);
+    return result;
+}
+
+int radix_heap_dijkstra(Graph const *graph, size_t source, VecDouble *distances, RadixHeap *heap)
+{
+    if (__prepare_distances(graph, source, distances) != 0)
+    {
+        return 1;
+    }
+    if (graph->V >= UINT32_MAX)
+    {
+        fprintf(stderr, "O radix heap suporta no máximo %u vértices\n", UINT32_MAX - 1);
+        return 1;
+    }
+    double *dist = distances->data;
+    // cópias locais: as chamadas à fila não podem invalidá-las
+    uint64_t const *const offsets = graph->adjacency_list.offsets;
+    uint32_t const *const neighbors = graph->adjacency_list.neighbors;
+    double const *const weights = graph->adjacency_list.weights;
+    RadixHeap_clear(heap);
+    RadixHeap_push(heap, (uint32_t)source, 0.0);
+    while (!RadixHeap_is_empty(heap))
+    {
+        uint32_t vertex_id;
+        double const d_j = RadixHeap_pop(heap, &vertex_id);
+        if (d_j > dist[vertex_id])
+        {
+            continue;
+        }
+        uint64_t const end = offsets[vertex_id + 1];
+        for (uint64_t n = offsets[vertex_id]; n < end; n++)
+        {
+            uint32_t const neighbor = neighbors[n];
+            double const new_distance = d_j + weights[n];
+            if (new_distance < dist[neighbor])
+            {
+                dist[neighbor] = new_distance;
+                RadixHeap_push(heap, neighbor, new_distance);
+            }
+        }
+    }
+    return 0;
+}
+
+static double __max_weight(Graph const *graph)
+{
+    double const *weights = graph->adjacency_list.weights;
+    double max_weight = 0.0;
+    for (size_t i = 0; i < graph->E; i++)
+    {
+        max_weight = weights[i] > max_weight ? weights[i] : max_weight;
+    }
+    return max_weight;
+}
+
+double delta_stepping_default_delta(Graph const *graph)
+{
+    // Meyer e Sanders: Δ = Θ(1/d) para pesos em [0, 1], ou seja, peso máximo / grau médio
+    double const average_degree = graph->V > 0 ? (double)graph->E / (double)graph->V : 1.0;
+    double const max_weight = __max_weight(graph);
+    return average_degree > 1.0 ? max_weight / average_degree : max_weight;
+}
+
+// Delta-stepping: o bucket i contém os vértices com distância provisória em
+// [iΔ, (i+1)Δ). As arestas leves (peso <= Δ) do bucket atual são relaxadas em fases
+// até ele parar de receber vértices; depois as pesadas, uma única vez por vértice.
+// Como todas as distâncias provisórias ficam a menos de Δ + peso máximo do bucket
+// atual, basta um vetor circular de buckets. As distâncias são doubles não negativos
+// guardados como uint64_t, cuja ordem é a mesma, para usar CAS nas relaxações.
+
+#define DELTA_STEPPING_CHUNK 64
+#define DELTA_STEPPING_MAX_BUCKETS ((size_t)1 << 16)
+
+typedef struct
+{
+    Graph const *graph;
+    double delta;
+    size_t num_threads;
+    Barrier barrier;
+    _Atomic uint64_t *dist;
+    ArenaVecSizeT *buckets;
+    size_t num_buckets;
+    size_t current;         // índice absoluto do bucket atual
+    ArenaVecSizeT frontier; // vértices do bucket atual a expandir na fase leve
+    ArenaVecSizeT settled;  // vértices removidos do bucket atual, para a fase pesada
+    size_t *frontier_stamp;
+    size_t *settled_stamp;
+    size_t phase;
+    VecSizeT *requests; // por thread: vértices cuja distância diminuiu (fora da arena,
+                        // que só a thread 0 usa)
+    atomic_size_t next_index;
+    int done;
+    // 1 após uma falha de alocação; a thread 0 então esvazia a fronteira e encerra o
+    // laço, para que todas as threads saiam juntas nas mesmas barreiras
+    atomic_int status;
+} DeltaStepping;
+
+static uint64_t __distance_bits(double distance)
+{
+    uint64_t bits;
+    memcpy(&bits, &distance, sizeof(bits));
+    return bits;
+}
+
+static double __bits_distance(uint64_t bits)
+{
+    double distance;
+    memcpy(&distance, &bits, sizeof(distance));
+    return distance;
+}
+
+static size_t __bucket_of(DeltaStepping const *job, double distance)
+{
+    return (size_t)(distance / job->delta);
+}
+
+// relaxa as arestas leves (light = 1) ou pesadas de vertices, em blocos dinâmicos
+static void __delta_relax(DeltaStepping *job, ArenaVecSizeT const *vertices, size_t thread_id, int light)
+{
+    size_t const size = vertices->size;
+    VecSizeT *requests = &job->requests[thread_id];
+    AdjList const *adj = &job->graph->adjacency_list;
+    for (;;)
+    {
+        size_t const begin = atomic_fetch_add(&job->next_index, DELTA_STEPPING_CHUNK);
+        if (begin >= size)
+        {
+            break;
+        }
+        size_t const end = begin + DELTA_STEPPING_CHUNK < size ? begin + DELTA_STEPPING_CHUNK : size;
+        for (size_t i = begin; i < end; i++)
+        {
+            size_t const vertex_id = vertices->data[i];
+            double const d_v = __bits_distance(atomic_load_explicit(&job->dist[vertex_id], memory_order_relaxed));
+            uint64_t const stop = adj->offsets[vertex_id + 1];
+            for (uint64_t n = adj->offsets[vertex_id]; n < stop; n++)
+            {
+                double const weight = adj->weights[n];
+                if ((weight <= job->delta) != light)
+                {
+                    continue;
+                }
+                uint32_t const neighbor = adj->neighbors[n];
+                uint64_t const candidate = __distance_bits(d_v + weight);
+                uint64_t old = atomic_load_explicit(&job->dist[neighbor], memory_order_relaxed);
+                while (candidate < old)
+                {
+                    if (atomic_compare_exchange_weak_explicit(&job->dist[neighbor], &old, candidate,
+                                                              memory_order_relaxed, memory_order_relaxed))
+                    {
+                        if (VecSizeT_push_back(requests, neighbor) != 0)
+                        {
+                            atomic_store(&job->status, 1);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
 
-    while (!MinHeap_is_empty(&heap))
+// thread 0, entre barreiras: após a fase leve, vértices melhorados que caem no bucket
+// atual formam a próxima fronteira; os demais (e todos, após a fase pesada) vão para o
+// seu bucket
+static void __delta_merge_requests(DeltaStepping *job, int light)
+{
+    job->phase++;
+    ArenaVecSizeT_resize(&job->frontier, 0);
+    for (size_t t = 0; t < job->num_threads; t++)
     {
-        size_t vertex_id = MinHeap_get(&heap);
-        double const d_j = VecDouble_get(distances, vertex_id);
-        if (isinf(d_j)) // uma distância infinita não pode ser relaxada
+        VecSizeT *requests = &job->requests[t];
+        for (size_t i = 0; i < requests->size; i++)
+        {
+            size_t const vertex_id = requests->data[i];
+            size_t const bucket = __bucket_of(job, __bits_distance(atomic_load_explicit(&job->dist[vertex_id],
+                                                                                        memory_order_relaxed)));
+            int failed = 0;
+            if (!light || bucket != job->current)
+            {
+                failed = ArenaVecSizeT_push_back(&job->buckets[bucket % job->num_buckets], vertex_id) != 0;
+            }
+            else if (job->frontier_stamp[vertex_id] != job->phase)
+            {
+                job->frontier_stamp[vertex_id] = job->phase;
+                failed = ArenaVecSizeT_push_back(&job->frontier, vertex_id) != 0;
+            }
+            if (failed)
+            {
+                atomic_store(&job->status, 1);
+            }
+        }
+        VecSizeT_resize(requests, 0);
+    }
+    if (atomic_load(&job->status) != 0)
+    {
+        ArenaVecSizeT_resize(&job->frontier, 0);
+    }
+    atomic_store(&job->next_index, 0);
+}
+
+// thread 0: avança até o próximo bucket não vazio e monta a sua fronteira,
+// descartando entradas obsoletas (vértices que já desceram para um bucket anterior)
+static void __delta_select_bucket(DeltaStepping *job)
+{
+    job->phase++;
+    ArenaVecSizeT_resize(&job->frontier, 0);
+    ArenaVecSizeT_resize(&job->settled, 0);
+    job->done = 1;
+    for (size_t k = 0; k < job->num_buckets && job->done; k++)
+    {
+        ArenaVecSizeT *bucket = &job->buckets[(job->current + k) % job->num_buckets];
+        for (size_t i = 0; i < bucket->size; i++)
+        {
+            size_t const vertex_id = bucket->data[i];
+            double const distance = __bits_distance(atomic_load_explicit(&job->dist[vertex_id], memory_order_relaxed));
+            if (__bucket_of(job, distance) == job->current + k && job->frontier_stamp[vertex_id] != job->phase)
+            {
+                job->frontier_stamp[vertex_id] = job->phase;
+                if (ArenaVecSizeT_push_back(&job->frontier, vertex_id) != 0)
+                {
+                    atomic_store(&job->status, 1);
+                }
+            }
+        }
+        ArenaVecSizeT_resize(bucket, 0);
+        if (job->frontier.size > 0)
+        {
+            job->current += k;
+            job->done = 0;
+        }
+    }
+    if (atomic_load(&job->status) != 0)
+    {
+        job->done = 1;
+    }
+    atomic_store(&job->next_index, 0);
+}
+
+static void __delta_settle_frontier(DeltaStepping *job)
+{
+    for (size_t i = 0; i < job->frontier.size; i++)
+    {
+        size_t const vertex_id = job->frontier.data[i];
+        if (job->settled_stamp[vertex_id] != job->current + 1)
+        {
+            job->settled_stamp[vertex_id] = job->current + 1;
+            if (ArenaVecSizeT_push_back(&job->settled, vertex_id) != 0)
+            {
+                atomic_store(&job->status, 1);
+            }
+        }
+    }
+}
+
+static int __delta_stepping_worker(void *arg, size_t thread_id)
+{
+    DeltaStepping *job = arg;
+    for (;;)
+    {
+        if (thread_id == 0)
+        {
+            __delta_select_bucket(job);
+        }
+        Barrier_wait(&job->barrier);
+        if (job->done)
         {
             break;
         }
-        SpanVertexWeight neighbors = VecSpanVertexWeight_get(
-            &graph->adjacency_list.neighboors, vertex_id);
-        VertexWithWeight *end = neighbors.begin + neighbors.N;
-        for (VertexWithWeight *neighbor_ptr = neighbors.begin; neighbor_ptr < end; neighbor_ptr++)
+        while (job->frontier.size > 0)
         {
-            double const new_distance = d_j + neighbor_ptr->weight;
-            if (new_distance < VecDouble_get(distances, neighbor_ptr->vertex_id))
+            __delta_relax(job, &job->frontier, thread_id, 1);
+            Barrier_wait(&job->barrier);
+            if (thread_id == 0)
             {
-                VecDouble_set(distances, neighbor_ptr->vertex_id, new_distance);
-                MinHeap_decrease_key(&heap, neighbor_ptr->vertex_id, new_distance);
+                __delta_settle_frontier(job);
+                __delta_merge_requests(job, 1);
             }
+            Barrier_wait(&job->barrier);
+        }
+        __delta_relax(job, &job->settled, thread_id, 0);
+        Barrier_wait(&job->barrier);
+        if (thread_id == 0)
+        {
+            __delta_merge_requests(job, 0);
         }
     }
-    MinHeap_free(&heap);
     return 0;
 }
+
+int delta_stepping(Graph const *graph, size_t source, VecDouble *distances, double delta,
+                   ThreadConfig const *threads, Arena *scratch)
+{
+    if (__prepare_distances(graph, source, distances) != 0)
+    {
+        return 1;
+    }
+    size_t const V = graph->V;
+    double const max_weight = __max_weight(graph);
+    if (delta <= 0.0)
+    {
+        delta = delta_stepping_default_delta(graph);
+    }
+    if (delta <= 0.0 || max_weight / delta >= (double)DELTA_STEPPING_MAX_BUCKETS)
+    {
+        delta = max_weight > 0.0 ? max_weight / (double)(DELTA_STEPPING_MAX_BUCKETS - 2) : 1.0;
+        fprintf(stderr, "Aviso: Δ muito pequeno, usando %g\n", delta);
+    }
+
+    size_t const max_threads = threads->num_threads > 0 ? threads->num_threads : 1;
+    DeltaStepping job = {.graph = graph, .delta = delta, .num_threads = max_threads,
+                         .num_buckets = (size_t)(max_weight / delta) + 2};
+    // sem arena do chamador, uma local dura só esta chamada
+    Arena local_scratch;
+    Arena_init(&local_scratch, 0);
+    Arena *arena = scratch != NULL ? scratch : &local_scratch;
+    ArenaVecSizeT_init(&job.frontier, arena);
+    ArenaVecSizeT_init(&job.settled, arena);
+    atomic_init(&job.next_index, 0);
+    atomic_init(&job.status, 0);
+    job.dist = Arena_alloc(arena, V * sizeof(*job.dist));
+    job.buckets = Arena_alloc(arena, job.num_buckets * sizeof(ArenaVecSizeT));
+    job.frontier_stamp = Arena_calloc(arena, V * sizeof(size_t));
+    job.settled_stamp = Arena_calloc(arena, V * sizeof(size_t));
+    job.requests = calloc(job.num_threads, sizeof(VecSizeT));
+    int result = 1;
+    if (job.dist == NULL || job.buckets == NULL || job.frontier_stamp == NULL || job.settled_stamp == NULL ||
+        job.requests == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do delta-stepping\n");
+        goto cleanup;
+    }
+    for (size_t b = 0; b < job.num_buckets; b++)
+    {
+        ArenaVecSizeT_init(&job.buckets[b], arena);
+    }
+    if (Barrier_init(&job.barrier, job.num_threads) != 0)
+    {
+        fprintf(stderr, "Falha ao criar a barreira do delta-stepping\n");
+        goto cleanup;
+    }
+    for (size_t v = 0; v < V; v++)
+    {
+        atomic_init(&job.dist[v], __distance_bits(INFINITY));
+    }
+    atomic_store(&job.dist[source], __distance_bits(0.0));
+    if (ArenaVecSizeT_push_back(&job.buckets[0], source) != 0)
+    {
+        fprintf(stderr, "Falha na alocação do delta-stepping\n");
+        Barrier_destroy(&job.barrier);
+        goto cleanup;
+    }
+
+    run_threads(threads, job.num_threads, __delta_stepping_worker, &job);
+    Barrier_destroy(&job.barrier);
+    if (atomic_load(&job.status) != 0)
+    {
+        fprintf(stderr, "Falha na alocação das filas do delta-stepping\n");
+        goto cleanup;
+    }
+    for (size_t v = 0; v < V; v++)
+    {
+        distances->data[v] = __bits_distance(atomic_load(&job.dist[v]));
+    }
+    result = 0;
+
+cleanup:
+    for (size_t t = 0; job.requests != NULL && t < max_threads; t++)
+    {
+        VecSizeT_free(&job.requests[t]);
+    }
+    free(job.requests);
+    Arena_free(&local_scratch);
+    return result;
+}
+
+void SsspOptions_init(SsspOptions *options)
+{
+    options->algorithm = SSSP_DIJKSTRA;
+    options->queue = PRIORITY_QUEUE_DEFAULT;
+    options->delta = 0.0;
+    ThreadConfig_init(&options->threads);
+}
+
+size_t SsspOptions_source_threads(SsspOptions const *options, ThreadConfig const *threads)
+{
+    if (options->algorithm == SSSP_DELTA_STEPPING)
+    {
+        return 1;
+    }
+    return threads->num_threads > 0 ? threads->num_threads : 1;
+}
+
+void SsspWorkspace_init(SsspWorkspace *workspace, SsspOptions const *options)
+{
+    PriorityQueue_init(&workspace->queue, options->queue);
+    RadixHeap_init(&workspace->radix);
+    Arena_init(&workspace->scratch, 0);
+}
+
+void SsspWorkspace_free(SsspWorkspace *workspace)
+{
+    PriorityQueue_free(&workspace->queue);
+    RadixHeap_free(&workspace->radix);
+    Arena_free(&workspace->scratch);
+}
+
+int sssp(Graph const *graph, size_t source, VecDouble *distances, SsspOptions const *options,
+         SsspWorkspace *workspace)
+{
+    switch (options->algorithm)
+    {
+    case SSSP_RADIX_HEAP:
+        return radix_heap_dijkstra(graph, source, distances, &workspace->radix);
+    case SSSP_DELTA_STEPPING:
+        Arena_reset(&workspace->scratch);
+        return delta_stepping(graph, source, distances, options->delta, &options->threads, &workspace->scratch);
+    default:
+        return dijkstra_with_queue(graph, source, distances, &workspace->queue);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stddef.h>
+
+// Arena de rascunho: alocação por incremento de ponteiro em blocos grandes, sem free
+// individual. Tudo o que foi alocado é devolvido de uma vez por Arena_reset, que mantém a
+// memória para a próxima rodada (se a rodada precisou de vários blocos, eles viram um só
+// com a soma dos tamanhos). Serve para os dados temporários de uma chamada que se repete
+// milhões de vezes, como uma fonte do Dijkstra de todas as fontes. Não é thread-safe: cada
+// thread usa a sua.
+
+#define ARENA_ALIGNMENT 64 // todas as alocações começam em uma linha de cache
+#define ARENA_DEFAULT_BLOCK_SIZE ((size_t)1 << 20)
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct
+{
+    ArenaBlock *head;  // bloco atual; os anteriores seguem em head->next
+    size_t block_size; // tamanho mínimo de um bloco novo
+    void *last;        // alocação mais recente, a única que cresce no lugar
+} Arena;
+
+void Arena_init(Arena *arena, size_t block_size);
+// alinhado a ARENA_ALIGNMENT; NULL se a alocação falhar (já reportado em stderr)
+void *Arena_alloc(Arena *arena, size_t bytes);
+// idem, zerado
+void *Arena_calloc(Arena *arena, size_t bytes);
+// aumenta uma alocação feita nesta arena, no lugar se ela é a mais recente e cabe no
+// bloco; senão copia old_bytes para uma nova (a antiga só volta em Arena_reset)
+void *Arena_realloc(Arena *arena, void *ptr, size_t old_bytes, size_t new_bytes);
+// invalida todas as alocações
+void Arena_reset(Arena *arena);
+void Arena_free(Arena *arena);
@@ -0,0 +1,77 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <mpi.h>
+
+// Modo benchmark (main_cli bench): cada repetição percorre o pipeline inteiro (leitura ou
+// geração do grafo, distribuição, cálculo e redução) e cada processo cronometra as fases
+// separadamente; o processo 0 reúne os tempos e grava JSON ou CSV.
+typedef enum
+{
+    PHASE_LOAD,       // leitura do arquivo (processo 0 ou MPI-IO) ou geração do grafo
+    PHASE_CSR,        // construção da lista de adjacência (ou da edgelist a partir dela)
+    PHASE_DISTRIBUTE, // envio do grafo aos processos
+    PHASE_COMPUTE,    // cálculo das distâncias, incluindo a espera por comunicação
+    PHASE_WAIT,       // parte de PHASE_COMPUTE esperando comunicação (se o engine separa)
+    PHASE_GATHER,     // reunião da matriz completa no processo 0 (--gather)
+    PHASE_REDUCE,     // soma de 1/d e redução da eficiência
+    PHASE_COUNT,
+} BenchmarkPhase;
+
+typedef struct
+{
+    double seconds[PHASE_COUNT];
+} PhaseTimes;
+
+void PhaseTimes_init(PhaseTimes* times);
+char const* BenchmarkPhase_name(BenchmarkPhase phase);
+// soma das fases, sem PHASE_WAIT (que já está contida em PHASE_COMPUTE)
+double PhaseTimes_total(PhaseTimes const* times);
+
+typedef enum
+{
+    BENCHMARK_JSON,
+    BENCHMARK_CSV, // uma linha por repetição e processo
+} BenchmarkFormat;
+
+typedef struct
+{
+    size_t warmup;      // repetições executadas e descartadas antes das medidas
+    size_t repetitions; // repetições medidas
+    char const* output; // NULL: saída padrão
+    BenchmarkFormat format;
+} BenchmarkOptions;
+
+void BenchmarkOptions_init(BenchmarkOptions* options);
+
+// configuração gravada junto dos tempos
+typedef struct
+{
+    char const* graph;     // arquivo do grafo ou nome do gerador
+    size_t V;
+    size_t E;
+    uint64_t seed;         // apenas grafos gerados
+    char const* engine;
+    char const* backend;
+    size_t num_threads;
+    int nprocs;
+} BenchmarkInfo;
+
+// tempos de todas as repetições medidas, guardados apenas no processo 0
+typedef struct
+{
+    size_t repetitions;
+    size_t recorded;
+    int nprocs;
+    int rank;
+    double* times;        // repetitions × nprocs × PHASE_COUNT
+    double* efficiencies; // uma por repetição
+} BenchmarkReport;
+
+int BenchmarkReport_init(BenchmarkReport* report, size_t repetitions, MPI_Comm comm);
+// coletiva em comm: reúne no processo 0 os tempos de cada processo nesta repetição
+void BenchmarkReport_record(BenchmarkReport* report, PhaseTimes const* times, double efficiency, MPI_Comm comm);
+// apenas no processo 0: grava o relatório e resume as fases na saída padrão (o tempo de
+// uma fase em uma repetição é o do processo mais lento)
+int BenchmarkReport_write(BenchmarkReport const* report, BenchmarkInfo const* info, BenchmarkOptions const* options);
+void BenchmarkReport_free(BenchmarkReport* report);
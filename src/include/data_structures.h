@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include "arena.h"
 
 #define DECLARE_SPAN(T, name) \
     typedef struct            \
@@ -11,36 +12,127 @@
         size_t N;             \
     } name;
 
-#define DECLARE_VECTOR_INTERFACE(T, name)                 \
-    typedef struct                                        \
-    {                                                     \
-        size_t capacity;                                  \
-        size_t size;                                      \
-        T *data;                                          \
-    } name;                                               \
-    void name##_init(name *vector);                       \
+// primeira capacidade de um vetor vazio que recebe push_back (uma linha de cache de size_t)
+#define VECTOR_MIN_CAPACITY 8
+
+// Alocação dos dados de uma matriz. Todas são liberadas por free(): as páginas enormes
+// são as transparentes do Linux (alocação alinhada a 2 MiB e madvise(MADV_HUGEPAGE)), e
+// matrizes menores que uma página enorme ficam só alinhadas a 64 bytes.
+typedef enum
+{
+    MATRIX_ALLOC_DEFAULT,    // malloc
+    MATRIX_ALLOC_ALIGNED,    // início em uma linha de cache
+    MATRIX_ALLOC_HUGE_PAGES, // idem, em páginas de 2 MiB quando o kernel permite
+} MatrixAllocation;
+
+#define MATRIX_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+void *matrix_alloc(size_t bytes, MatrixAllocation allocation);
+
+#define __DECLARE_VECTOR_OPERATIONS(T, name)              \
     int name##_is_empty(name const *vector);              \
     size_t name##_size(name const *vector);               \
     int name##_reserve(name *vector, size_t capacity);    \
-    void name##_push_back(name *vector, T element);       \
+    int name##_push_back(name *vector, T element);        \
     void name##_pop_back(name *vector);                   \
     int name##_resize(name *vector, size_t new_size);     \
     T name##_get(name const *vector, size_t index);       \
     void name##_set(name *vector, size_t index, T value); \
     void name##_free(name *vector);
 
-#define DECLARE_MATRIX_INTERFACE(T, name)                           \
-    typedef struct                                                  \
-    {                                                               \
-        size_t nrows;                                               \
-        size_t ncols;                                               \
-        T *data;                                                    \
-    } name;                                                         \
-    int name##_init(name *matrix, size_t nrows, size_t ncols);      \
-    T name##_get(name const *matrix, size_t row, size_t col);       \
-    void name##_set(name *matrix, size_t row, size_t col, T value); \
+#define DECLARE_VECTOR_INTERFACE(T, name) \
+    typedef struct                        \
+    {                                     \
+        size_t capacity;                  \
+        size_t size;                      \
+        T *data;                          \
+    } name;                               \
+    void name##_init(name *vector);       \
+    __DECLARE_VECTOR_OPERATIONS(T, name)
+
+// Variante dos vetores cuja memória vem de uma Arena (arena.h): crescer não chama
+// realloc e liberar não chama free; tudo volta para a arena em Arena_reset.
+#define DECLARE_ARENA_VECTOR_INTERFACE(T, name)   \
+    typedef struct                                \
+    {                                             \
+        size_t capacity;                          \
+        size_t size;                              \
+        T *data;                                  \
+        Arena *arena;                             \
+    } name;                                       \
+    void name##_init(name *vector, Arena *arena); \
+    __DECLARE_VECTOR_OPERATIONS(T, name)
+
+#define DECLARE_MATRIX_INTERFACE(T, name)                                                           \
+    typedef struct                                                                                  \
+    {                                                                                               \
+        size_t nrows;                                                                               \
+        size_t ncols;                                                                               \
+        T *data;                                                                                    \
+    } name;                                                                                         \
+    int name##_init(name *matrix, size_t nrows, size_t ncols);                                      \
+    int name##_init_aligned(name *matrix, size_t nrows, size_t ncols, MatrixAllocation allocation); \
+    T name##_get(name const *matrix, size_t row, size_t col);                                       \
+    void name##_set(name *matrix, size_t row, size_t col, T value);                                 \
     void name##_free(name *matrix);
 
+#define __IMPLEMENT_VECTOR_OPERATIONS(T, name)                \
+    int name##_resize(name *vector, size_t new_size)          \
+    {                                                         \
+        if (new_size > vector->capacity)                      \
+        {                                                     \
+            if (name##_reserve(vector, new_size) != 0)        \
+            {                                                 \
+                return 1;                                     \
+            }                                                 \
+        }                                                     \
+        vector->size = new_size;                              \
+        return 0;                                             \
+    }                                                         \
+                                                              \
+    size_t name##_size(name const *vector)                    \
+    {                                                         \
+        return vector->size;                                  \
+    }                                                         \
+    int name##_is_empty(name const *vector)                   \
+    {                                                         \
+        return vector->size == 0;                             \
+    }                                                         \
+                                                              \
+    /* 1 se o vetor precisou crescer e a alocação falhou */   \
+    int name##_push_back(name *vector, T element)             \
+    {                                                         \
+        if (vector->size >= vector->capacity)                 \
+        {                                                     \
+            size_t const capacity = vector->capacity == 0     \
+                                        ? VECTOR_MIN_CAPACITY \
+                                        : 2 * vector->capacity;   \
+            if (name##_reserve(vector, capacity) != 0)        \
+            {                                                 \
+                return 1;                                     \
+            }                                                 \
+        }                                                     \
+        vector->data[vector->size] = element;                 \
+        vector->size++;                                       \
+        return 0;                                             \
+    }                                                         \
+                                                              \
+    T name##_get(name const *vector, size_t index)            \
+    {                                                         \
+        return vector->data[index];                           \
+    }                                                         \
+    void name##_set(name *vector, size_t index, T value)      \
+    {                                                         \
+        vector->data[index] = value;                          \
+    }                                                         \
+    void name##_pop_back(name *vector)                        \
+    {                                                         \
+        if (vector->size > 0)                                 \
+        {                                                     \
+            vector->size--;                                   \
+        }                                                     \
+    }
+
 #define IMPLEMENT_VECTOR_INTERFACE(T, name)                            \
                                                                        \
     void name##_init(name *vector)                                     \
@@ -49,27 +141,6 @@
         vector->size = 0;                                              \
         vector->data = NULL;                                           \
     }                                                                  \
-    int name##_resize(name *vector, size_t new_size)                   \
-    {                                                                  \
-        if (new_size > vector->capacity)                               \
-        {                                                              \
-            if (name##_reserve(vector, new_size) != 0)                 \
-            {                                                          \
-                return 1;                                              \
-            }                                                          \
-        }                                                              \
-        vector->size = new_size;                                       \
-        return 0;                                                      \
-    }                                                                  \
-                                                                       \
-    size_t name##_size(name const *vector)                             \
-    {                                                                  \
-        return vector->size;                                           \
-    }                                                                  \
-    int name##_is_empty(name const *vector)                            \
-    {                                                                  \
-        return vector->size == 0;                                      \
-    }                                                                  \
     int name##_reserve(name *vector, size_t capacity)                  \
     {                                                                  \
         if (capacity > vector->capacity)                               \
@@ -86,39 +157,6 @@
             vector->capacity = capacity;                               \
         }                                                              \
         return 0;                                                      \
-    }                                                                  \
-                                                                       \
-    void name##_push_back(name *vector, T element)                     \
-    {                                                                  \
-        if (vector->size >= vector->capacity)                          \
-        {                                                              \
-            if (vector->capacity == 0)                                 \
-            {                                                          \
-                name##_reserve(vector, 1);                             \
-            }                                                          \
-            else                                                       \
-            {                                                          \
-                name##_reserve(vector, 2 * vector->capacity);          \
-            }                                                          \
-        }                                                              \
-        vector->data[vector->size] = element;                          \
-        vector->size++;                                                \
-    }                                                                  \
-                                                                       \
-    T name##_get(name const *vector, size_t index)                     \
-    {                                                                  \
-        return vector->data[index];                                    \
-    }                                                                  \
-    void name##_set(name *vector, size_t index, T value)               \
-    {                                                                  \
-        vector->data[index] = value;                                   \
-    }                                                                  \
-    void name##_pop_back(name *vector)                                 \
-    {                                                                  \
-        if (vector->size > 0)                                          \
-        {                                                              \
-            vector->size--;                                            \
-        }                                                              \
     }                                                                  \
     void name##_free(name *vector)                                     \
     {                                                                  \
@@ -126,43 +164,83 @@
         vector->data = NULL;                                           \
         vector->capacity = 0;                                          \
         vector->size = 0;                                              \
-    }
+    }                                                                  \
+    __IMPLEMENT_VECTOR_OPERATIONS(T, name)
 
-#define IMPLEMENT_MATRIX_INTERFACE(T, name)                                  \
-    int name##_init(name *matrix, size_t nrows, size_t ncols)                \
-    {                                                                        \
-        matrix->nrows = nrows;                                               \
-        matrix->ncols = ncols;                                               \
-        size_t num_elements = nrows * ncols;                                 \
-        if (num_elements == 0)                                               \
-        {                                                                    \
-            matrix->data = NULL;                                             \
-            return 0;                                                        \
-        }                                                                    \
-        matrix->data = (T *)malloc(nrows * ncols * sizeof(T));               \
-        if (matrix->data == NULL)                                            \
-        {                                                                    \
-            fprintf(stderr, "Falha na alocação de memória para a matriz\n"); \
-            matrix->nrows = 0;                                               \
-            matrix->ncols = 0;                                               \
-            return 1;                                                        \
-        }                                                                    \
-        return 0;                                                            \
-    }                                                                        \
-    T name##_get(name const *matrix, size_t row, size_t col)                 \
-    {                                                                        \
-        return matrix->data[row * matrix->ncols + col];                      \
-    }                                                                        \
-    void name##_set(name *matrix, size_t row, size_t col, T value)           \
-    {                                                                        \
-        matrix->data[row * matrix->ncols + col] = value;                     \
-    }                                                                        \
-    void name##_free(name *matrix)                                           \
-    {                                                                        \
-        free(matrix->data);                                                  \
-        matrix->data = NULL;                                                 \
-        matrix->ncols = 0;                                                   \
-        matrix->nrows = 0;                                                   \
+#define IMPLEMENT_ARENA_VECTOR_INTERFACE(T, name)                          \
+                                                                           \
+    void name##_init(name *vector, Arena *arena)                           \
+    {                                                                      \
+        vector->capacity = 0;                                              \
+        vector->size = 0;                                                  \
+        vector->data = NULL;                                               \
+        vector->arena = arena;                                             \
+    }                                                                      \
+    int name##_reserve(name *vector, size_t capacity)                      \
+    {                                                                      \
+        if (capacity > vector->capacity)                                   \
+        {                                                                  \
+            T *new_data = (T *)Arena_realloc(vector->arena, vector->data,  \
+                                             vector->capacity * sizeof(T), \
+                                             capacity * sizeof(T));        \
+            if (new_data == NULL)                                          \
+            {                                                              \
+                return 1;                                                  \
+            }                                                              \
+            vector->data = new_data;                                       \
+            vector->capacity = capacity;                                   \
+        }                                                                  \
+        return 0;                                                          \
+    }                                                                      \
+    /* a memória só volta para a arena em Arena_reset */                   \
+    void name##_free(name *vector)                                         \
+    {                                                                      \
+        vector->data = NULL;                                               \
+        vector->capacity = 0;                                              \
+        vector->size = 0;                                                  \
+    }                                                                      \
+    __IMPLEMENT_VECTOR_OPERATIONS(T, name)
+
+#define IMPLEMENT_MATRIX_INTERFACE(T, name)                                      \
+    int name##_init_aligned(name *matrix, size_t nrows, size_t ncols,            \
+                            MatrixAllocation allocation)                         \
+    {                                                                            \
+        matrix->nrows = nrows;                                                   \
+        matrix->ncols = ncols;                                                   \
+        size_t num_elements = nrows * ncols;                                     \
+        if (num_elements == 0)                                                   \
+        {                                                                        \
+            matrix->data = NULL;                                                 \
+            return 0;                                                            \
+        }                                                                        \
+        matrix->data = (T *)matrix_alloc(nrows * ncols * sizeof(T), allocation); \
+        if (matrix->data == NULL)                                                \
+        {                                                                        \
+            fprintf(stderr, "Falha na alocação de memória para a matriz\n");     \
+            matrix->nrows = 0;                                                   \
+            matrix->ncols = 0;                                                   \
+            return 1;                                                            \
+        }                                                                        \
+        return 0;                                                                \
+    }                                                                            \
+    int name##_init(name *matrix, size_t nrows, size_t ncols)                    \
+    {                                                                            \
+        return name##_init_aligned(matrix, nrows, ncols, MATRIX_ALLOC_DEFAULT);  \
+    }                                                                            \
+    T name##_get(name const *matrix, size_t row, size_t col)                     \
+    {                                                                            \
+        return matrix->data[row * matrix->ncols + col];                          \
+    }                                                                            \
+    void name##_set(name *matrix, size_t row, size_t col, T value)               \
+    {                                                                            \
+        matrix->data[row * matrix->ncols + col] = value;                         \
+    }                                                                            \
+    void name##_free(name *matrix)                                               \
+    {                                                                            \
+        free(matrix->data);                                                      \
+        matrix->data = NULL;                                                     \
+        matrix->ncols = 0;                                                       \
+        matrix->nrows = 0;                                                       \
     }
 
 typedef struct
@@ -173,6 +251,7 @@ typedef struct
 
 DECLARE_VECTOR_INTERFACE(VertexWithPriority, VecVertexWithPriority)
 DECLARE_VECTOR_INTERFACE(size_t, VecSizeT)
+DECLARE_ARENA_VECTOR_INTERFACE(size_t, ArenaVecSizeT)
 typedef struct
 {
     VecVertexWithPriority data;
@@ -181,7 +260,93 @@ typedef struct
 
 void MinHeap_init(MinHeap *heap);
 void MinHeap_free(MinHeap *heap);
+void MinHeap_clear(MinHeap *heap);
 int MinHeap_is_empty(MinHeap const *heap);
 void MinHeap_add(MinHeap *heap, size_t vertex_id, double distance);
 void MinHeap_decrease_key(MinHeap *heap, size_t vertex_id, double new_distance);
 size_t MinHeap_get(MinHeap *heap);
+
+// Heap d-ário com ids de 32 bits em estrutura de vetores (chaves e ids separados) e
+// sift iterativo. Com position != NULL é indexado (decrease-key no lugar, cada vértice
+// no máximo uma vez); sem o mapa de posições é o heap de remoção preguiçosa: cada
+// melhoria empilha uma nova entrada e as obsoletas são descartadas por quem desempilha.
+// Os d filhos de um nó começam em um múltiplo de d, ou seja, em uma linha de cache
+// para d = 8.
+typedef struct
+{
+    size_t arity;
+    size_t size;
+    size_t capacity;
+    double *keys;
+    uint32_t *ids;
+    void *buffer;       // alocação alinhada que contém keys
+    uint32_t *position; // posição de cada vértice no heap, UINT32_MAX se ausente
+    size_t num_vertices;
+} DaryHeap;
+
+void DaryHeap_init(DaryHeap *heap, size_t arity, int indexed);
+// prepara o heap para vértices 0..num_vertices-1 (num_vertices < UINT32_MAX)
+int DaryHeap_reserve(DaryHeap *heap, size_t num_vertices);
+void DaryHeap_clear(DaryHeap *heap);
+int DaryHeap_is_empty(DaryHeap const *heap);
+// insere o vértice ou, se indexado e já presente, diminui sua chave
+int DaryHeap_push(DaryHeap *heap, uint32_t vertex_id, double key);
+// remove o mínimo e retorna sua chave
+double DaryHeap_pop(DaryHeap *heap, uint32_t *vertex_id);
+void DaryHeap_free(DaryHeap *heap);
+
+// fila de prioridade usada pelo Dijkstra, com a implementação escolhida em tempo de execução
+typedef enum
+{
+    PRIORITY_QUEUE_BINARY, // MinHeap: binário indexado, ids size_t
+    PRIORITY_QUEUE_4ARY,   // DaryHeap indexado com d = 4
+    PRIORITY_QUEUE_8ARY,   // DaryHeap indexado com d = 8
+    PRIORITY_QUEUE_LAZY,   // DaryHeap com d = 4 sem mapa de posições
+} PriorityQueueKind;
+
+#define PRIORITY_QUEUE_DEFAULT PRIORITY_QUEUE_4ARY
+
+typedef struct
+{
+    PriorityQueueKind kind;
+    MinHeap binary;
+    DaryHeap dary;
+} PriorityQueue;
+
+void PriorityQueue_init(PriorityQueue *queue, PriorityQueueKind kind);
+int PriorityQueue_reserve(PriorityQueue *queue, size_t num_vertices);
+void PriorityQueue_clear(PriorityQueue *queue);
+int PriorityQueue_is_empty(PriorityQueue const *queue);
+// insere ou melhora a chave do vértice
+int PriorityQueue_push(PriorityQueue *queue, size_t vertex_id, double key);
+// remove o mínimo; com PRIORITY_QUEUE_LAZY a chave retornada pode ser obsoleta
+double PriorityQueue_pop(PriorityQueue *queue, size_t *vertex_id);
+void PriorityQueue_free(PriorityQueue *queue);
+
+// Radix heap monotônico para chaves double não negativas: a representação IEEE de
+// doubles não negativos preserva a ordem como uint64_t. As chaves inseridas não podem
+// ser menores que a última removida (vale no Dijkstra com pesos não negativos). Não há
+// decrease-key: cada melhoria insere uma nova entrada, como em PRIORITY_QUEUE_LAZY.
+typedef struct
+{
+    uint64_t key;
+    uint32_t vertex_id;
+} RadixEntry;
+
+DECLARE_VECTOR_INTERFACE(RadixEntry, VecRadixEntry)
+
+#define RADIX_HEAP_BUCKETS 65
+
+typedef struct
+{
+    VecRadixEntry buckets[RADIX_HEAP_BUCKETS]; // bucket i: o bit mais alto que difere de last é o i - 1
+    uint64_t last;
+    size_t size;
+} RadixHeap;
+
+void RadixHeap_init(RadixHeap *heap);
+void RadixHeap_clear(RadixHeap *heap);
+int RadixHeap_is_empty(RadixHeap const *heap);
+void RadixHeap_push(RadixHeap *heap, uint32_t vertex_id, double key);
+double RadixHeap_pop(RadixHeap *heap, uint32_t *vertex_id);
+void RadixHeap_free(RadixHeap *heap);
@@ -0,0 +1,172 @@
+#pragma once
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <mpi.h>
+#include "graph_library.h"
+#include "min_plus.h"
+#include "profiling.h"
+
+// Partes do Floyd-Warshall iguais nas duas precisões, no estilo de IMPLEMENT_MATRIX_INTERFACE.
+// IMPLEMENT_FLOYD_WARSHALL_COMMON(T, Matrix, MPI_T, KRowBroadcastT, suffix) define o tipo
+// KRowBroadcastT e, com o sufixo dado (vazio para double, _float para float), as funções
+// static __init_distance_rows, __init_full_matrix, __matrix_k_row e __broadcast_k_row e a
+// floyd_warshall_blocked declarada em graph_library.h.
+// Usa min_plus_block##suffix e min_plus_block_dependent##suffix de min_plus.h.
+
+#define IMPLEMENT_FLOYD_WARSHALL_COMMON(T, Matrix, MPI_T, KRowBroadcastT, suffix)                    \
+    /* preenche as linhas locais do processo part na matriz de distâncias inicial; */                \
+    /* arestas paralelas ficam com o menor peso */                                                   \
+    static void __init_distance_rows##suffix(Graph const *graph, Matrix *distances,                  \
+                                             RowPartition const *partition, int part)                \
+    {                                                                                                \
+        size_t const V = graph->V;                                                                   \
+        for (size_t i = 0; i < distances->nrows; i++)                                                \
+        {                                                                                            \
+            T *row = distances->data + i * distances->ncols;                                         \
+            for (size_t j = 0; j < V; j++)                                                           \
+            {                                                                                        \
+                row[j] = INFINITY;                                                                   \
+            }                                                                                        \
+            row[RowPartition_global_index(partition, part, i)] = (T)0;                               \
+        }                                                                                            \
+        for (size_t edge_index = 0; edge_index < graph->E; edge_index++)                             \
+        {                                                                                            \
+            Edge const edge = VecEdge_get(&graph->edge_list, edge_index);                            \
+            if (RowPartition_owner(partition, edge.from) == part)                                    \
+            {                                                                                        \
+                size_t const local_i = RowPartition_local_index(partition, edge.from);               \
+                T const weight = (T)edge.weight;                                                     \
+                if (weight < Matrix##_get(distances, local_i, edge.to))                              \
+                {                                                                                    \
+                    Matrix##_set(distances, local_i, edge.to, weight);                               \
+                }                                                                                    \
+            }                                                                                        \
+        }                                                                                            \
+    }                                                                                                \
+                                                                                                     \
+    /* matriz V×V inicial; threads: quem a relaxa depois (NULL: sem first touch) */                  \
+    static int __init_full_matrix##suffix(Graph const *graph, Matrix *distances,                     \
+                                          ThreadConfig const *threads)                               \
+    {                                                                                                \
+        size_t const V = graph->V;                                                                   \
+        if (Matrix##_init_aligned(distances, V, V, MATRIX_ALLOC_HUGE_PAGES) != 0)                    \
+        {                                                                                            \
+            fprintf(stderr, "Alocação da matriz de distância falhou");                               \
+            return 1;                                                                                \
+        }                                                                                            \
+        if (threads != NULL &&                                                                       \
+            floyd_warshall_first_touch(distances->data, V, V * sizeof(T), threads) != 0)             \
+        {                                                                                            \
+            Matrix##_free(distances);                                                                \
+            return 1;                                                                                \
+        }                                                                                            \
+        RowPartition whole_matrix;                                                                   \
+        RowPartition_init(&whole_matrix, PARTITION_BLOCK, V, 1, 0);                                  \
+        __init_distance_rows##suffix(graph, distances, &whole_matrix, 0);                            \
+        return 0;                                                                                    \
+    }                                                                                                \
+                                                                                                     \
+    /* a linha k não muda durante a iteração k, então pode ser lida diretamente da matriz */         \
+    static T const *__matrix_k_row##suffix(void *context, size_t k)                                  \
+    {                                                                                                \
+        Matrix const *distances = context;                                                           \
+        return distances->data + k * distances->ncols;                                               \
+    }                                                                                                \
+                                                                                                     \
+    typedef struct                                                                                   \
+    {                                                                                                \
+        Matrix const *local_distances;                                                               \
+        RowPartition const *partition;                                                               \
+        int rank;                                                                                    \
+        T *k_row;                                                                                    \
+        RankTimings *timings;                                                                        \
+    } KRowBroadcastT;                                                                                \
+                                                                                                     \
+    /* chamada apenas pela thread 0 de cada processo, entre as barreiras das iterações */            \
+    static T const *__broadcast_k_row##suffix(void *context, size_t k)                               \
+    {                                                                                                \
+        KRowBroadcastT *broadcast = context;                                                         \
+        size_t const V = broadcast->local_distances->ncols;                                          \
+        int const owner = RowPartition_owner(broadcast->partition, k);                               \
+        if (broadcast->rank == owner)                                                                \
+        {                                                                                            \
+            size_t const local_k = RowPartition_local_index(broadcast->partition, k);                \
+            memcpy(broadcast->k_row, broadcast->local_distances->data + local_k * V, V * sizeof(T)); \
+        }                                                                                            \
+        double const wait_start = MPI_Wtime();                                                       \
+        MPI_Bcast(broadcast->k_row, V, MPI_T, owner, MPI_COMM_WORLD);                                \
+        broadcast->timings->wait_time += MPI_Wtime() - wait_start;                                   \
+        return broadcast->k_row;                                                                     \
+    }                                                                                                \
+                                                                                                     \
+    int floyd_warshall_blocked##suffix(Graph const *graph, Matrix *distances, size_t tile_size)      \
+    {                                                                                                \
+        size_t const V = graph->V;                                                                   \
+        if (tile_size == 0)                                                                          \
+        {                                                                                            \
+            tile_size = FLOYD_WARSHALL_DEFAULT_TILE_SIZE;                                            \
+        }                                                                                            \
+        if (__init_full_matrix##suffix(graph, distances, NULL) != 0)                                 \
+        {                                                                                            \
+            return 1;                                                                                \
+        }                                                                                            \
+                                                                                                     \
+        T *D = distances->data;                                                                      \
+        size_t const num_tiles = (V + tile_size - 1) / tile_size;                                    \
+        PROFILE_BEGIN(PROFILE_FW_BLOCKED);                                                           \
+        PROFILE_THREAD_COUNTERS(counters);                                                           \
+        PROFILE_THREAD_BEGIN(counters);                                                              \
+        for (size_t kb = 0; kb < num_tiles; kb++)                                                    \
+        {                                                                                            \
+            size_t const k0 = kb * tile_size;                                                        \
+            size_t const kk = (k0 + tile_size <= V) ? tile_size : V - k0;                            \
+            T *diagonal = D + k0 * V + k0;                                                           \
+                                                                                                     \
+            /* fase 1: bloco diagonal, que só depende de si mesmo */                                 \
+            min_plus_block_dependent##suffix(diagonal, V, diagonal, V, diagonal, V, kk, kk, kk);     \
+                                                                                                     \
+            /* fase 2: blocos da linha kb e da coluna kb, que dependem do diagonal */                \
+            for (size_t b = 0; b < num_tiles; b++)                                                   \
+            {                                                                                        \
+                if (b == kb)                                                                         \
+                {                                                                                    \
+                    continue;                                                                        \
+                }                                                                                    \
+                size_t const b0 = b * tile_size;                                                     \
+                size_t const bb = (b0 + tile_size <= V) ? tile_size : V - b0;                        \
+                T *row_tile = D + k0 * V + b0;                                                       \
+                T *col_tile = D + b0 * V + k0;                                                       \
+                min_plus_block_dependent##suffix(row_tile, V, diagonal, V, row_tile, V, kk, bb, kk); \
+                min_plus_block_dependent##suffix(col_tile, V, col_tile, V, diagonal, V, bb, kk, kk); \
+            }                                                                                        \
+                                                                                                     \
+            /* fase 3: demais blocos, que só leem a linha e a coluna kb já finalizadas */            \
+            for (size_t ib = 0; ib < num_tiles; ib++)                                                \
+            {                                                                                        \
+                if (ib == kb)                                                                        \
+                {                                                                                    \
+                    continue;                                                                        \
+                }                                                                                    \
+                size_t const i0 = ib * tile_size;                                                    \
+                size_t const ii = (i0 + tile_size <= V) ? tile_size : V - i0;                        \
+                for (size_t jb = 0; jb < num_tiles; jb++)                                            \
+                {                                                                                    \
+                    if (jb == kb)                                                                    \
+                    {                                                                                \
+                        continue;                                                                    \
+                    }                                                                                \
+                    size_t const j0 = jb * tile_size;                                                \
+                    size_t const jj = (j0 + tile_size <= V) ? tile_size : V - j0;                    \
+                    min_plus_block##suffix(D + i0 * V + j0, V,                                       \
+                                           D + i0 * V + k0, V,                                       \
+                                           D + k0 * V + j0, V,                                       \
+                                           ii, jj, kk);                                              \
+                }                                                                                    \
+            }                                                                                        \
+        }                                                                                            \
+        PROFILE_THREAD_END(counters, PROFILE_FW_BLOCKED);                                            \
+        PROFILE_END(PROFILE_FW_BLOCKED);                                                             \
+        return 0;                                                                                    \
+    }
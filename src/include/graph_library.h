@@ -4,6 +4,9 @@
 #include <math.h>
 #include <stdlib.h>
 #include "data_structures.h"
+#include "partition.h"
+#include "threading.h"
+#include <mpi.h>
 #pragma once
 
 
@@ -14,21 +17,19 @@ typedef struct
     double weight;
 } Edge;
 
-typedef struct {
-    size_t vertex_id;
-    double weight;
-} VertexWithWeight;
-
 DECLARE_VECTOR_INTERFACE(Edge, VecEdge)
-DECLARE_VECTOR_INTERFACE(VertexWithWeight, VecVertexWeight)
-DECLARE_SPAN(VertexWithWeight,SpanVertexWeight)
-DECLARE_VECTOR_INTERFACE(SpanVertexWeight,VecSpanVertexWeight)
-typedef struct{
-    VecSpanVertexWeight neighboors;
-    VecVertexWeight flatten_buffer; 
+
+// Lista de adjacência em CSR: os vizinhos de v ocupam as posições
+// [offsets[v], offsets[v + 1]) de neighbors (ids de 32 bits) e weights
+typedef struct
+{
+    uint64_t *offsets; // V + 1 entradas
+    uint32_t *neighbors;
+    double *weights;
 } AdjList;
 
 void AdjList_init(AdjList* adjlist);
+void AdjList_free(AdjList* adjlist);
 
 typedef struct
 {
@@ -36,17 +37,412 @@ typedef struct
     size_t E;
     VecEdge edge_list;
     AdjList adjacency_list;
+    void *mapping; // arquivo binário mapeado (Graph_map_binary), NULL caso contrário
+    size_t mapping_size;
 } Graph;
 
 void Graph_init(Graph* graph);
 int Graph_create_edgelist(Graph *graph, char const *filename);
+// lê atualizações "origem destino peso", uma por linha; o peso deve ser positivo e "inf"
+// remove a aresta
+int Graph_read_edge_updates(char const *filename, size_t V, VecEdge *updates);
+// mapeia o arquivo em memória e lê blocos de linhas em paralelo (uma aresta por linha)
+int Graph_create_edgelist_threaded(Graph *graph, char const *filename, ThreadConfig const *threads);
+// parâmetros da construção do CSR a partir da edgelist (em qualquer ordem)
+typedef struct
+{
+    int sort_neighbors;   // ordena os vizinhos de cada vértice pelo id (e pelo peso)
+    int free_edge_list;   // libera a edgelist depois da construção
+    ThreadConfig threads; // threads das passadas de contagem, soma de prefixos e espalhamento
+} AdjacencyOptions;
+
+void AdjacencyOptions_init(AdjacencyOptions* options);
+int Graph_create_adjacency_list_with_options(Graph* graph, AdjacencyOptions const* options);
+// sequencial, mantém a edgelist e a ordem dos vizinhos dentro de cada vértice
 int Graph_create_adjacency_list(Graph* graph);
+// reconstrói a edgelist (ordenada pela origem) a partir da lista de adjacência
+int Graph_create_edgelist_from_adjacency(Graph* graph);
 void Graph_destroy(Graph* graph);
 
+// processo de destino de uma aresta na distribuição do grafo
+typedef int (*EdgeOwnerFunction)(void const* context, Edge const* edge);
+// dono da linha edge->from; context é uma RowPartition
+int Graph_edge_row_owner(void const* rows, Edge const* edge);
+// dono do elemento (from, to); context é uma GridPartition
+int Graph_edge_grid_owner(void const* grid, Edge const* edge);
+// coletiva: a edgelist do processo root é distribuída com MPI_Scatterv (tipo derivado
+// de Edge) e cada processo fica apenas com as arestas que owner lhe atribui, na ordem
+// original; graph->V deve ser conhecido em todos e graph->E passa a ser a contagem local
+int Graph_scatter_edges(Graph* graph, EdgeOwnerFunction owner, void const* context, int root, MPI_Comm comm);
+// coletiva: replica V, E e o CSR do processo root nos demais processos
+int Graph_broadcast_adjacency(Graph* graph, int root, MPI_Comm comm);
+
+// Formato binário (versão GRAPH_BINARY_VERSION): cabeçalho com V, E e uma tabela de
+// seções alinhadas em GRAPH_BINARY_ALIGNMENT bytes, com os três vetores do CSR: offsets
+// (uint64_t[V + 1]), neighbors (uint32_t[E]) e weights (double[E]). Requer a lista de adjacência.
+#define GRAPH_BINARY_VERSION 2
+#define GRAPH_BINARY_ALIGNMENT 64
+int Graph_write_binary(Graph const* graph, char const* filename);
+// 1 se o arquivo começa com a assinatura do formato binário
+int Graph_is_binary_file(char const* filename);
+int Graph_read_binary_header(char const* filename, size_t* V, size_t* E);
+// mapeia o arquivo e aponta os vetores da lista de adjacência para o mapeamento, sem
+// cópia; a edgelist fica vazia e o mapeamento é desfeito em Graph_destroy. Valida os
+// offsets (O(V)), mas não os ids dos vizinhos, que vêm de Graph_write_binary
+int Graph_map_binary(Graph* graph, char const* filename);
+// coletiva em comm: com MPI-IO cada processo lê apenas as arestas das linhas que possui
+// em rows e monta a edgelist delas (graph->E passa a ser o número de arestas locais)
+int Graph_read_binary_rows(Graph* graph, char const* filename, RowPartition const* rows, int part,
+                           MPI_Comm comm);
+
+// Grafos sintéticos (modo benchmark), gerados com a semente seed: Erdős–Rényi G(V, E),
+// R-MAT com as probabilidades rmat[0..3] dos quadrantes e grade com floor(sqrt(V))
+// linhas e arestas nos dois sentidos entre vizinhos (E é ignorado). Pesos uniformes em
+// [min_weight, max_weight]; E = 0 gera GENERATOR_DEFAULT_DEGREE * V arestas.
+typedef enum
+{
+    GENERATOR_ERDOS_RENYI,
+    GENERATOR_RMAT,
+    GENERATOR_GRID,
+} GeneratorKind;
+
+#define GENERATOR_DEFAULT_DEGREE 8
+
+typedef struct
+{
+    GeneratorKind kind;
+    size_t V;
+    size_t E;
+    double min_weight;
+    double max_weight;
+    uint64_t seed;
+    double rmat[4];
+} GeneratorOptions;
+
+void GeneratorOptions_init(GeneratorOptions* options);
+char const* GeneratorKind_name(GeneratorKind kind);
+// preenche a edgelist, V e E como Graph_create_edgelist (sem a lista de adjacência)
+int Graph_generate(Graph* graph, GeneratorOptions const* options);
+
 DECLARE_VECTOR_INTERFACE(double, VecDouble)
 DECLARE_MATRIX_INTERFACE(double, MatrixDouble)
 
+// Caminhos mínimos: no Floyd-Warshall next(i, j) é o vértice seguinte a i no caminho de
+// i até j (ids de 32 bits, como na lista de adjacência); no Dijkstra parent(v) é o vértice
+// anterior a v. PATH_NO_VERTEX marca destinos inalcançáveis.
+#define PATH_NO_VERTEX UINT32_MAX
+DECLARE_VECTOR_INTERFACE(uint32_t, VecUInt32)
+DECLARE_MATRIX_INTERFACE(uint32_t, MatrixUInt32)
+
+// path recebe os vértices de from até to (inclusive); vazio se to for inalcançável
+int path_from_next(MatrixUInt32 const* next, size_t from, size_t to, VecSizeT* path);
+int path_from_parents(VecUInt32 const* parents, size_t source, size_t to, VecSizeT* path);
+
+// Soma compensada (Kahan-Neumaier) de 1/d: cada engine entrega as linhas de distâncias
+// assim que ficam prontas (fonte do Dijkstra, faixa ou bloco do Floyd-Warshall), então a
+// eficiência nunca exige a matriz V×V, só O(V) por thread
+typedef struct
+{
+    double sum;
+    double compensation;
+} EfficiencySum;
+
+void EfficiencySum_init(EfficiencySum* acc);
+void EfficiencySum_add(EfficiencySum* acc, double value);
+// soma 1/d da linha de distâncias da fonte source; a diagonal, 0 e infinito não contam
+void EfficiencySum_add_row(EfficiencySum* acc, double const* distances, size_t V, size_t source);
+void EfficiencySum_add_row_float(EfficiencySum* acc, float const* distances, size_t V, size_t source);
+void EfficiencySum_merge(EfficiencySum* acc, EfficiencySum const* other);
+double EfficiencySum_value(EfficiencySum const* acc);
+// coletiva em comm: combina as somas parciais e devolve em root a eficiência global,
+// normalizada por V(V - 1) (0 nos demais processos)
+double global_efficiency(EfficiencySum const* local, size_t V, int root, MPI_Comm comm);
+
 
 int floyd_warshall(Graph const* graph,MatrixDouble* distances);
+// paralelo sobre as linhas i para cada k, em memória compartilhada
+int floyd_warshall_threaded(Graph const* graph, MatrixDouble* distances, ThreadConfig const* threads);
+// idem, preenchendo também a matriz V×V de próximos vértices
+int floyd_warshall_paths(Graph const* graph, MatrixDouble* distances, MatrixUInt32* next,
+                         ThreadConfig const* threads);
+// tile_size = 0 usa FLOYD_WARSHALL_DEFAULT_TILE_SIZE
+int floyd_warshall_blocked(Graph const* graph, MatrixDouble* distances, size_t tile_size);
+
+// Floyd-Warshall em blocos fora da memória (out-of-core): a matriz fica em um arquivo de
+// tiles tile_size × tile_size contíguos, lidos e gravados com pread/pwrite, e só um cache
+// de tiles de até memory_budget bytes fica em memória. A cada iteração kb a linha e a
+// coluna de tiles do pivô ficam presas no cache; os demais tiles são visitados em
+// sentidos alternados e com a linha e a coluna de kb + 1 por último, para que a próxima
+// iteração comece pelo que acabou de ser usado. Uma thread auxiliar lê os próximos
+// prefetch_depth tiles (e grava os que saem do cache) enquanto o atual é calculado.
+#define OUT_OF_CORE_DEFAULT_MEMORY ((size_t)1 << 30)
+#define OUT_OF_CORE_DEFAULT_PREFETCH 4
+#define OUT_OF_CORE_MAX_TILE_SIZE 1024
+
+typedef struct
+{
+    // 0: o maior múltiplo de FLOYD_WARSHALL_DEFAULT_TILE_SIZE (até OUT_OF_CORE_MAX_TILE_SIZE)
+    // com a linha e a coluna do pivô em metade do cache; tiles maiores leem menos o arquivo
+    size_t tile_size;
+    size_t memory_budget;  // bytes do cache de tiles
+    char const* path;      // arquivo dos tiles, que fica com a matriz final; NULL: temporário em TMPDIR
+    size_t prefetch_depth; // 0: sem thread auxiliar, toda a E/S na thread de cálculo
+} OutOfCoreOptions;
+
+typedef struct
+{
+    size_t tile_size;     // o usado, se escolhido automaticamente
+    size_t cache_tiles;
+    size_t tiles_read;
+    size_t tiles_written; // inclusive a matriz inicial
+    size_t cache_hits;    // tiles pedidos pelo cálculo que já estavam (ou estavam chegando) no cache
+    double io_wait_time;  // tempo da thread de cálculo esperando a E/S
+} OutOfCoreStats;
+
+void OutOfCoreOptions_init(OutOfCoreOptions* options);
+// devolve a eficiência, somada à medida que os tiles ficam prontos na última iteração;
+// stats pode ser NULL
+int floyd_warshall_out_of_core(Graph const* graph, OutOfCoreOptions const* options, double* efficiency,
+                               OutOfCoreStats* stats);
+
+// Atualização incremental: distances (V×V) e efficiency_sum (soma de 1/d de distances)
+// passam a corresponder ao grafo depois de num_updates atualizações. Cada atualização
+// define o peso positivo da aresta from -> to (substituindo arestas paralelas); peso
+// INFINITY a remove. As linhas cujos caminhos mínimos usavam uma aresta que ficou mais
+// cara são recalculadas com Dijkstra; cada aresta que ficou mais barata custa O(V²). A
+// edgelist de graph é atualizada e a lista de adjacência reconstruída.
+int floyd_warshall_update(Graph* graph, MatrixDouble* distances, Edge const* updates, size_t num_updates,
+                          ThreadConfig const* threads, EfficiencySum* efficiency_sum);
+
+// tempo (s) que um processo passou esperando comunicação versus calculando e, depois do
+// cálculo, reunindo a matriz no processo 0 e reduzindo a eficiência
+typedef struct
+{
+    double wait_time;
+    double compute_time;
+    double gather_time;
+    double reduce_time;
+} RankTimings;
+
+// Checkpoint do Floyd-Warshall 1D: a cada intervalo as faixas de todos os processos e a
+// iteração k atual são gravadas com MPI-IO em um arquivo compartilhado, em ordem global de
+// linhas (a retomada independe do número de processos e da partição). O arquivo tem duas
+// áreas usadas alternadamente e o cabeçalho só aponta para uma área depois que ela foi
+// escrita por todos; a gravação parte de uma cópia da faixa e corre durante o cálculo.
+typedef struct
+{
+    char const *path;           // NULL desativa os checkpoints
+    size_t interval_iterations; // 0: sem intervalo em iterações
+    double interval_seconds;    // 0: sem intervalo em segundos
+    int resume;                 // continua do último checkpoint de path, se existir
+} CheckpointOptions;
+
+void CheckpointOptions_init(CheckpointOptions* options);
+
+// estado de um checkpoint aberto por todos os processos de comm
+typedef struct
+{
+    CheckpointOptions options;
+    MPI_Comm comm;
+    int rank;
+    MPI_File file;
+    MPI_Datatype row_type;
+    size_t V;
+    size_t nrows;
+    size_t num_runs;     // sequências de linhas locais consecutivas também no arquivo
+    size_t *run_first;   // primeira linha local de cada sequência
+    size_t *run_row;     // e a linha global correspondente
+    size_t *run_rows;    // linhas de cada sequência
+    double *snapshot;    // cópia da faixa que está sendo gravada
+    MPI_Request *requests;
+    int pending;         // há uma gravação ainda não confirmada no cabeçalho
+    size_t pending_k;
+    int pending_area;
+    int committed_area;  // -1: nenhum checkpoint confirmado
+    size_t last_k;
+    double last_time;
+    size_t num_written;
+    double write_time;   // tempo da thread 0 gasto com os checkpoints
+} Checkpoint;
+
+// coletiva em comm; com options->resume restaura a faixa local (nrows × V, linhas de
+// partition que pertencem a rank) e devolve em first_k a próxima iteração, senão 0
+int Checkpoint_open(Checkpoint* checkpoint, CheckpointOptions const* options, MatrixDouble* strip,
+                    RowPartition const* partition, int rank, MPI_Comm comm, size_t* first_k);
+// coletiva; chamada no início da iteração k, com as iterações 0..k-1 já aplicadas à faixa
+void Checkpoint_step(Checkpoint* checkpoint, MatrixDouble const* strip, size_t k);
+// coletiva: confirma a gravação pendente e fecha o arquivo
+int Checkpoint_close(Checkpoint* checkpoint);
+
+// parâmetros do Floyd-Warshall distribuído em linhas (1D)
+typedef struct
+{
+    PartitionKind partition; // distribuição das linhas entre os processos
+    size_t block_size;       // linhas por bloco em PARTITION_BLOCK_CYCLIC
+    int pipelined;           // sobrepõe o MPI_Ibcast da linha k + 1 com a aplicação da linha k
+    ThreadConfig threads;    // threads por processo (modo híbrido; ignorado com pipelined)
+    CheckpointOptions checkpoint;
+} FloydWarshallOptions;
+
+void FloydWarshallOptions_init(FloydWarshallOptions* options);
+// distances e efficiency podem ser NULL (veja as variantes *_efficiency); timings também
+int floyd_warshall_openmpi_with_options(Graph const* graph, FloydWarshallOptions const* options,
+                                        MatrixDouble* distances, double* efficiency,
+                                        RankTimings* timings);
 int floyd_warshall_openmpi(Graph const* graph, MatrixDouble* distances);
-int dijkstra(Graph const* graph, size_t source, VecDouble* distances);
\ No newline at end of file
+// Variantes *_efficiency: a matriz de distâncias nunca é reunida; cada processo soma
+// 1/d na sua parte e o processo 0 recebe a eficiência global via MPI_Reduce
+int floyd_warshall_openmpi_efficiency(Graph const* graph, double* efficiency);
+
+// sobrepõe o MPI_Ibcast da linha k + 1 com a aplicação da linha k; timings pode ser NULL
+int floyd_warshall_openmpi_pipelined(Graph const* graph, MatrixDouble* distances, RankTimings* timings);
+int floyd_warshall_openmpi_pipelined_efficiency(Graph const* graph, double* efficiency, RankTimings* timings);
+// Floyd-Warshall 1D com caminhos (sem pipeline): cada processo fica com as suas linhas de
+// distâncias e de próximos vértices; nada é reunido. next(i, k) já está na linha local,
+// então o tráfego por iteração continua sendo só a linha k de distâncias.
+typedef struct
+{
+    RowPartition partition;
+    int rank;
+    MatrixDouble local_distances;
+    MatrixUInt32 local_next;
+} DistributedPaths;
+
+int floyd_warshall_openmpi_paths(Graph const* graph, FloydWarshallOptions const* options, DistributedPaths* paths,
+                                 RankTimings* timings);
+// coletiva: todos os processos recebem o caminho de from até to (um MPI_Bcast por vértice)
+int DistributedPaths_extract(DistributedPaths const* paths, size_t from, size_t to, VecSizeT* path,
+                             MPI_Comm comm);
+void DistributedPaths_free(DistributedPaths* paths);
+// fornece a linha k da iteração k; chamada apenas pela thread 0 (que pode usar MPI)
+typedef double const *(*KRowSource)(void* context, size_t k);
+// aplica as linhas k = 0..num_k-1 a todas as linhas de strip, em paralelo sobre as linhas
+int floyd_warshall_relax_strip(MatrixDouble* strip, size_t num_k, KRowSource fetch_k_row, void* context,
+                               ThreadConfig const* threads);
+// idem, atualizando a faixa de próximos vértices next (mesmas dimensões de strip)
+int floyd_warshall_relax_strip_paths(MatrixDouble* strip, MatrixUInt32* next, size_t num_k, KRowSource fetch_k_row,
+                                     void* context, ThreadConfig const* threads);
+// idem para k = first_k..num_k-1 (retomada de um checkpoint)
+int floyd_warshall_relax_strip_from(MatrixDouble* strip, size_t first_k, size_t num_k, KRowSource fetch_k_row,
+                                    void* context, ThreadConfig const* threads);
+// com threads->pinning, toca as páginas de cada bloco de linhas pela primeira vez a partir
+// das threads do nó NUMA que vão relaxá-lo (a mesma divisão de floyd_warshall_relax_strip*),
+// zerando-as; chamada logo depois de alocar a faixa e antes de preenchê-la. Sem fixação
+// não faz nada.
+int floyd_warshall_first_touch(void* data, size_t nrows, size_t row_bytes, ThreadConfig const* threads);
+
+// Variantes em precisão simples (float): metade da memória e do tráfego MPI da matriz de
+// distâncias e o dobro de elementos por instrução SIMD, ao custo de ~7 dígitos
+// significativos nas distâncias. A eficiência continua sendo somada em double.
+DECLARE_VECTOR_INTERFACE(float, VecFloat)
+DECLARE_MATRIX_INTERFACE(float, MatrixFloat)
+
+typedef float const *(*KRowSourceFloat)(void* context, size_t k);
+int floyd_warshall_relax_strip_float(MatrixFloat* strip, size_t num_k, KRowSourceFloat fetch_k_row,
+                                     void* context, ThreadConfig const* threads);
+int floyd_warshall_threaded_float(Graph const* graph, MatrixFloat* distances, ThreadConfig const* threads);
+int floyd_warshall_blocked_float(Graph const* graph, MatrixFloat* distances, size_t tile_size);
+// Floyd-Warshall 1D sem reunir a matriz: o processo 0 recebe apenas a eficiência global.
+// A variante com pipeline (options->pipelined) não tem versão em float.
+int floyd_warshall_openmpi_float_efficiency(Graph const* graph, FloydWarshallOptions const* options,
+                                            double* efficiency, RankTimings* timings);
+
+// grade 2D de processos com distribuição bloco-cíclica de blocos tile_size x tile_size
+// (a mesma devolvida por floyd_warshall_2d_grid para nprocs processos)
+void floyd_warshall_2d_grid(size_t V, size_t tile_size, int nprocs, GridPartition* grid);
+// timings pode ser NULL
+int floyd_warshall_openmpi_2d(Graph const* graph, MatrixDouble* distances, size_t tile_size, RankTimings* timings);
+int floyd_warshall_openmpi_2d_efficiency(Graph const* graph, double* efficiency, size_t tile_size,
+                                         RankTimings* timings);
+int dijkstra(Graph const* graph, size_t source, VecDouble* distances);
+// idem, com o vetor de predecessores (parents[source] = source)
+int dijkstra_paths(Graph const* graph, size_t source, VecDouble* distances, VecUInt32* parents);
+// reutiliza a fila entre chamadas sucessivas (ela é esvaziada no início); os vértices
+// só entram na fila quando alcançados
+int dijkstra_with_queue(Graph const* graph, size_t source, VecDouble* distances, PriorityQueue* queue);
+// Dijkstra com RadixHeap (pesos não negativos); o heap é esvaziado no início
+int radix_heap_dijkstra(Graph const* graph, size_t source, VecDouble* distances, RadixHeap* heap);
+// Δ = peso máximo / grau médio
+double delta_stepping_default_delta(Graph const* graph);
+// delta-stepping com as arestas leves e pesadas relaxadas em paralelo pelas threads;
+// delta <= 0 escolhe Δ automaticamente. Os buckets, fronteiras e marcas da chamada vêm de
+// scratch, que o chamador reinicia entre fontes (NULL: uma arena só desta chamada)
+int delta_stepping(Graph const* graph, size_t source, VecDouble* distances, double delta,
+                   ThreadConfig const* threads, Arena* scratch);
+
+// algoritmo de fonte única usado por sssp() e pelo Dijkstra de todas as fontes
+typedef enum
+{
+    SSSP_DIJKSTRA,       // dijkstra_with_queue com a fila escolhida em queue
+    SSSP_RADIX_HEAP,     // radix_heap_dijkstra
+    SSSP_DELTA_STEPPING, // delta_stepping com delta e threads
+} SsspAlgorithm;
+
+typedef struct
+{
+    SsspAlgorithm algorithm;
+    PriorityQueueKind queue;
+    double delta;
+    ThreadConfig threads;
+} SsspOptions;
+
+void SsspOptions_init(SsspOptions* options);
+// threads que resolvem fontes diferentes ao mesmo tempo com as threads de threads: uma só
+// com SSSP_DELTA_STEPPING, em que as threads trabalham dentro de cada fonte
+size_t SsspOptions_source_threads(SsspOptions const* options, ThreadConfig const* threads);
+
+// filas reaproveitadas entre chamadas sucessivas de sssp(); a arena de rascunho do
+// delta-stepping é reiniciada (e não liberada) a cada fonte
+typedef struct
+{
+    PriorityQueue queue;
+    RadixHeap radix;
+    Arena scratch;
+} SsspWorkspace;
+
+void SsspWorkspace_init(SsspWorkspace* workspace, SsspOptions const* options);
+void SsspWorkspace_free(SsspWorkspace* workspace);
+int sssp(Graph const* graph, size_t source, VecDouble* distances, SsspOptions const* options,
+         SsspWorkspace* workspace);
+// eficiência global via Dijkstra de todas as fontes, distribuídas entre os processos
+// MPI e num_threads threads por processo; requer a lista de adjacência construída.
+// Com SSSP_DELTA_STEPPING as fontes de cada processo são resolvidas uma de cada vez,
+// com as threads dentro de cada fonte. O resultado é válido no processo 0; timings pode
+// ser NULL.
+int dijkstra_apsp_efficiency(Graph const* graph, ThreadConfig const* threads, SsspOptions const* sssp,
+                             double* efficiency, RankTimings* timings);
+
+// Eficiência estimada a partir de um subconjunto aleatório de fontes: com r_s a soma de
+// 1/d(s, t) da fonte s, a eficiência é média(r_s) / (V - 1), e o intervalo de confiança
+// vem da variância amostral (com correção de população finita).
+typedef enum
+{
+    SAMPLING_UNIFORM, // fontes sorteadas sem reposição entre todos os vértices
+    SAMPLING_DEGREE,  // estratificada: vértices ordenados pelo grau de saída em num_strata
+                      // faixas de mesmo tamanho, com alocação proporcional das fontes
+} SamplingKind;
+
+typedef struct
+{
+    SamplingKind kind;
+    size_t num_sources;           // fontes por lote (com target_relative_error) ou no total
+    double target_relative_error; // > 0: adiciona lotes até meia largura / estimativa <= alvo
+    double confidence;            // nível do intervalo de confiança, em (0, 1)
+    uint64_t seed;                // mesma semente em todos os processos
+    size_t num_strata;            // apenas SAMPLING_DEGREE
+} SamplingOptions;
+
+void SamplingOptions_init(SamplingOptions* options);
+
+typedef struct
+{
+    double efficiency; // estimativa
+    double half_width; // intervalo de confiança: efficiency ± half_width
+    size_t num_sources;
+} EfficiencyEstimate;
+
+// coletiva em MPI_COMM_WORLD: cada lote de fontes é dividido ciclicamente entre os
+// processos e, em cada processo, entre as threads (com sssp()); requer a lista de
+// adjacência construída em todos os processos. O resultado é válido em todos os processos.
+int sampled_efficiency(Graph const* graph, ThreadConfig const* threads, SsspOptions const* sssp,
+                       SamplingOptions const* sampling, EfficiencyEstimate* estimate);
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLOYD_WARSHALL_DEFAULT_TILE_SIZE 64
+
+// dst[j] = min(dst[j], dik + src[j]) para j em [0, n)
+void min_plus_row(double *dst, double const *src, double dik, size_t n);
+// idem, e dst_next[j] = next_ik onde dst[j] diminuiu (próximo vértice do caminho
+// mínimo); kernel separado para que min_plus_row não pague pelo rastreamento
+void min_plus_row_next(double *dst, uint32_t *dst_next, double const *src, double dik, uint32_t next_ik,
+                       size_t n);
+
+// C[i][j] = min(C[i][j], A[i][k] + B[k][j]) com i < m, j < n, k < kk.
+// A e B não podem ser modificados durante a chamada (fase independente),
+// por isso a ordem i-k-j é usada para manter a linha de C no L1.
+void min_plus_block(double *C, size_t ldc,
+                    double const *A, size_t lda,
+                    double const *B, size_t ldb,
+                    size_t m, size_t n, size_t kk);
+
+// Mesma operação, mas com k no laço externo, permitindo que A ou B
+// sejam o próprio bloco C (fases dependentes do Floyd-Warshall em blocos)
+void min_plus_block_dependent(double *C, size_t ldc,
+                              double const *A, size_t lda,
+                              double const *B, size_t ldb,
+                              size_t m, size_t n, size_t kk);
+
+// Variantes em precisão simples: o dobro de elementos por registrador SIMD
+void min_plus_row_float(float *dst, float const *src, float dik, size_t n);
+void min_plus_block_float(float *C, size_t ldc,
+                          float const *A, size_t lda,
+                          float const *B, size_t ldb,
+                          size_t m, size_t n, size_t kk);
+void min_plus_block_dependent_float(float *C, size_t ldc,
+                                    float const *A, size_t lda,
+                                    float const *B, size_t ldb,
+                                    size_t m, size_t n, size_t kk);
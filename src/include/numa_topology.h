@@ -0,0 +1,36 @@
+#pragma once
+#include <stddef.h>
+#include <mpi.h>
+#include "threading.h"
+
+// Topologia NUMA vista pelo processo: as CPUs que ele pode usar (sched_getaffinity)
+// agrupadas pelo nó de /sys/devices/system/node. Sem sysfs tudo fica em um nó só. A
+// variável NUMA_EMULATED_NODES=N divide as CPUs em N nós fictícios consecutivos, para
+// exercitar a distribuição por nó em uma máquina de um nó (com menos CPUs que nós, os
+// nós repetem CPUs).
+typedef struct
+{
+    size_t num_nodes;
+    size_t num_cpus;
+    int *cpus;          // CPUs do nó n em cpus[node_begin[n] .. node_begin[n + 1])
+    size_t *node_begin; // num_nodes + 1 entradas
+    void *allowed;      // cpu_set_t da thread que chamou NumaTopology_detect
+} NumaTopology;
+
+int NumaTopology_detect(NumaTopology *topology);
+void NumaTopology_free(NumaTopology *topology);
+// nó da thread thread_id segundo a política (0 com PIN_NONE); com cpu != NULL devolve
+// também a CPU em que ela deve ficar (-1 com PIN_NONE)
+size_t NumaTopology_thread_node(NumaTopology const *topology, ThreadPinning pinning, size_t thread_id, int *cpu);
+
+// devolve a thread chamadora às CPUs que a thread de NumaTopology_detect podia usar;
+// quem chama pin_current_thread deve restaurá-la ao terminar, senão a próxima detecção
+// (e as threads criadas depois) só veem aquela CPU
+int NumaTopology_restore_affinity(NumaTopology const *topology);
+
+// restringe a thread chamadora à CPU (as threads criadas depois herdam a restrição)
+int pin_current_thread(int cpu);
+// coletiva em comm: os processos de uma mesma máquina dividem as CPUs em blocos
+// contíguos, ordenados por nó (com um processo por nó NUMA, cada um fica no seu), e cada
+// processo é restrito ao seu bloco; chamada antes de criar threads
+int pin_ranks(MPI_Comm comm);
@@ -0,0 +1,45 @@
+#pragma once
+#include <stddef.h>
+
+// Distribuição de n linhas (ou colunas) entre nparts processos
+typedef enum
+{
+    PARTITION_BLOCK,        // faixas contíguas balanceadas (tamanhos diferem no máximo em 1)
+    PARTITION_CYCLIC,       // linha i no processo i mod nparts
+    PARTITION_BLOCK_CYCLIC, // blocos de block_size linhas distribuídos ciclicamente
+} PartitionKind;
+
+typedef struct
+{
+    PartitionKind kind;
+    size_t n;
+    size_t nparts;
+    size_t block_size; // 1 para PARTITION_CYCLIC
+    size_t base;       // PARTITION_BLOCK: linhas por processo sem o resto
+    size_t remainder;  // PARTITION_BLOCK: os primeiros `remainder` processos têm base + 1
+} RowPartition;
+
+void RowPartition_init(RowPartition *partition, PartitionKind kind, size_t n, int nparts, size_t block_size);
+// número de linhas do processo part
+size_t RowPartition_count(RowPartition const *partition, int part);
+// todas as consultas abaixo são O(1)
+int RowPartition_owner(RowPartition const *partition, size_t row);
+size_t RowPartition_local_index(RowPartition const *partition, size_t row);
+size_t RowPartition_global_index(RowPartition const *partition, int part, size_t local);
+// primeira linha global de part (linhas contíguas apenas em PARTITION_BLOCK)
+size_t RowPartition_block_start(RowPartition const *partition, int part);
+
+// Grade grid_rows x grid_cols de processos em ordem de linhas (processo r na posição
+// (r / grid_cols, r mod grid_cols)); as linhas e as colunas da matriz seguem cada uma
+// uma RowPartition bloco-cíclica sobre a dimensão correspondente da grade
+typedef struct
+{
+    RowPartition rows;
+    RowPartition cols;
+    int grid_rows;
+    int grid_cols;
+} GridPartition;
+
+void GridPartition_init(GridPartition *grid, size_t n, int grid_rows, int grid_cols, size_t block_size);
+// processo dono do elemento (row, col)
+int GridPartition_owner(GridPartition const *grid, size_t row, size_t col);
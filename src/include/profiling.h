@@ -0,0 +1,55 @@
+#pragma once
+#include <mpi.h>
+
+// Instrumentação opcional (cmake -DENABLE_PROFILING=ON): as regiões quentes dos engines
+// medem tempo e, com perf_event_open, ciclos, instruções e faltas no último nível de cache
+// de cada thread; as chamadas MPI são interceptadas pela interface PMPI (profiling.c
+// define MPI_Bcast, MPI_Send, ... chamando PMPI_*), sem mudar os pontos de chamada. No
+// fim, PROFILE_REPORT reúne no processo 0 o resumo de cada processo. Sem a opção, as
+// macros não geram código e profiling.c nem é compilado.
+
+typedef enum
+{
+    PROFILE_FW_RELAX,       // floyd_warshall_relax_strip* (fw-1d, fw-threads, float, caminhos)
+    PROFILE_FW_PIPELINED,   // laço do fw-pipelined
+    PROFILE_FW_BLOCKED,     // floyd_warshall_blocked
+    PROFILE_FW_2D,          // laço de faixas do fw-2d
+    PROFILE_FW_OUT_OF_CORE, // iterações do fw-ooc (inclui a espera pela E/S dos tiles)
+    PROFILE_DIJKSTRA,       // dijkstra_apsp_efficiency (só o tempo)
+    PROFILE_REGION_COUNT,
+} ProfileRegion;
+
+#ifdef ENABLE_PROFILING
+
+// contadores de hardware abertos pela própria thread (-1: indisponível)
+typedef struct
+{
+    int fds[3];
+} ProfileCounters;
+
+// tempo de parede e número de chamadas da região; chamadas pela thread que coordena a região
+void Profile_begin(ProfileRegion region);
+void Profile_end(ProfileRegion region);
+// cada thread que executa a região soma os seus contadores aos da região
+void ProfileCounters_start(ProfileCounters* counters);
+void ProfileCounters_stop(ProfileCounters* counters, ProfileRegion region);
+// coletiva em comm
+void Profile_report(MPI_Comm comm);
+
+#define PROFILE_BEGIN(region) Profile_begin(region)
+#define PROFILE_END(region) Profile_end(region)
+#define PROFILE_THREAD_COUNTERS(name) ProfileCounters name
+#define PROFILE_THREAD_BEGIN(name) ProfileCounters_start(&(name))
+#define PROFILE_THREAD_END(name, region) ProfileCounters_stop(&(name), region)
+#define PROFILE_REPORT(comm) Profile_report(comm)
+
+#else
+
+#define PROFILE_BEGIN(region) ((void)0)
+#define PROFILE_END(region) ((void)0)
+#define PROFILE_THREAD_COUNTERS(name)
+#define PROFILE_THREAD_BEGIN(name) ((void)0)
+#define PROFILE_THREAD_END(name, region) ((void)0)
+#define PROFILE_REPORT(comm) ((void)0)
+
+#endif
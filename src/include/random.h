@@ -0,0 +1,17 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Gerador splitmix64: rápido, com 64 bits de estado e sequência determinada pela semente.
+// Usado pela amostragem de fontes e pelos geradores de grafos sintéticos.
+typedef struct
+{
+    uint64_t state;
+} Random;
+
+void Random_init(Random *random, uint64_t seed);
+uint64_t Random_next(Random *random);
+// uniforme em [0, 1) com os 53 bits mais altos
+double Random_uniform(Random *random);
+// Fisher-Yates; o viés do módulo é desprezível para n muito menor que 2^64
+void Random_shuffle(Random *random, size_t *values, size_t n);
@@ -0,0 +1,70 @@
+#pragma once
+#include <stddef.h>
+#include <threads.h>
+
+// Backends de paralelismo em memória compartilhada
+typedef enum
+{
+    THREADS_C11,    // thrd_t; lê C11_THREADS_NUM_THREADS e C11_THREADS_CHUNK_SIZE
+    THREADS_OPENMP, // lê OMP_NUM_THREADS e usa schedule(runtime), ou seja, OMP_SCHEDULE
+} ThreadBackend;
+
+// distribuição de tarefas independentes (as fontes do Dijkstra) entre as threads
+typedef enum
+{
+    SCHEDULE_STATIC,              // um intervalo contíguo de fontes por thread
+    SCHEDULE_DYNAMIC,             // blocos de chunk_size fontes de um contador atômico
+    SCHEDULE_WORK_STEALING,       // deques por thread com roubo de trabalho (work_stealing.h)
+    SCHEDULE_WORK_STEALING_MPI,   // idem, e processos ociosos roubam fontes de outros via MPI one-sided
+} ThreadSchedule;
+
+// CPUs das threads dos laços do Floyd-Warshall (numa_topology.h)
+typedef enum
+{
+    PIN_NONE,    // o sistema operacional escolhe
+    PIN_COMPACT, // thread t na t-ésima CPU do processo, esgotando um nó antes do próximo
+    PIN_SCATTER, // threads alternadas entre os nós NUMA
+} ThreadPinning;
+
+// maior número de threads aceito em --threads e em C11_THREADS_NUM_THREADS
+#define THREADS_MAX_THREADS 1024
+
+typedef struct
+{
+    ThreadBackend backend;
+    size_t num_threads;
+    size_t chunk_size; // apenas C11: tamanho dos blocos do escalonamento dinâmico
+    // com OpenMP, SCHEDULE_STATIC e SCHEDULE_DYNAMIC usam schedule(runtime)
+    ThreadSchedule schedule;
+    // com fixação e mais de um nó, cada nó relaxa um bloco contíguo das linhas e recebe
+    // uma réplica da linha k
+    ThreadPinning pinning;
+} ThreadConfig;
+
+// uma única thread C11 com roubo de trabalho
+void ThreadConfig_init(ThreadConfig *config);
+// lê a configuração do backend a partir das variáveis de ambiente
+void ThreadConfig_from_env(ThreadConfig *config, ThreadBackend backend);
+
+// barreira reutilizável para threads C11
+typedef struct
+{
+    mtx_t mutex;
+    cnd_t condition;
+    size_t num_threads;
+    size_t waiting;
+    size_t generation;
+} Barrier;
+
+int Barrier_init(Barrier *barrier, size_t num_threads);
+// retorna 1 para exatamente uma das threads (a última a chegar) e 0 para as demais
+int Barrier_wait(Barrier *barrier);
+void Barrier_destroy(Barrier *barrier);
+
+// executa fn(arg, thread_id) em num_threads threads do backend de config; a thread
+// chamadora é a thread 0 (única que pode fazer chamadas MPI). Retorna o OU dos retornos
+// de fn. Todas as num_threads threads rodam ao mesmo tempo, então fn pode usar Barrier:
+// se o OpenMP entregar um time menor, são usadas threads C11, e o programa aborta se não
+// conseguir criá-las.
+int run_threads(ThreadConfig const *config, size_t num_threads, int (*fn)(void *arg, size_t thread_id),
+                void *arg);
@@ -0,0 +1,84 @@
+#pragma once
+#include <stddef.h>
+#include <stdatomic.h>
+#include <mpi.h>
+#include "threading.h"
+
+// Escalonador por roubo de trabalho para tarefas independentes (por exemplo, uma
+// fonte de Dijkstra por tarefa). Cada worker tem um deque de Chase-Lev: o dono
+// empilha e desempilha pelo fundo sem travas, os demais roubam do topo com um CAS.
+// Opcionalmente, parte das tarefas de cada processo fica exposta em uma janela MPI
+// e pode ser roubada por outros processos com MPI_Fetch_and_op (one-sided).
+
+// deque de capacidade fixa; os índices crescem monotonicamente
+typedef struct
+{
+    atomic_llong top;
+    atomic_llong bottom;
+    size_t capacity;
+    atomic_size_t *tasks;
+} TaskDeque;
+
+int TaskDeque_init(TaskDeque *deque, size_t capacity);
+// apenas o dono; retorna 1 se o deque estiver cheio
+int TaskDeque_push(TaskDeque *deque, size_t task);
+// apenas o dono; retorna 1 se o deque estiver vazio
+int TaskDeque_pop(TaskDeque *deque, size_t *task);
+
+typedef enum
+{
+    STEAL_SUCCESS,
+    STEAL_EMPTY,
+    STEAL_CONFLICT, // outro worker levou a tarefa; vale tentar de novo
+} StealResult;
+
+// qualquer thread
+StealResult TaskDeque_steal(TaskDeque *deque, size_t *task);
+void TaskDeque_free(TaskDeque *deque);
+
+// executa a tarefa task no worker indicado; retorno diferente de 0 indica erro
+typedef int (*TaskFunction)(void *context, size_t worker, size_t task);
+// converte o índice de uma tarefa compartilhada do processo rank na tarefa em si
+typedef size_t (*RemoteTaskFunction)(void *context, int rank, size_t index);
+
+typedef struct
+{
+    size_t tasks_run;
+    size_t local_steals;
+    size_t remote_claims; // blocos obtidos da janela MPI (do próprio processo ou de outro)
+    size_t remote_steals; // dos quais vieram de outro processo
+} WorkStealingStats;
+
+typedef struct
+{
+    size_t num_workers;
+    TaskDeque *deques;
+    WorkStealingStats *stats;
+    TaskFunction run_task;
+    void *context;
+    atomic_int status;
+
+    // roubo entre processos; só a thread 0 faz chamadas MPI
+    int remote;
+    MPI_Comm comm;
+    MPI_Win window;
+    long long *next_shared; // memória da janela: próximo índice compartilhado livre
+    long long *shared_end;  // fim do intervalo compartilhado de cada processo
+    size_t remote_chunk;
+    RemoteTaskFunction remote_task;
+    atomic_int remote_exhausted;
+} WorkStealing;
+
+// capacity: máximo de tarefas simultâneas no deque de um worker
+int WorkStealing_init(WorkStealing *ws, size_t num_workers, size_t capacity);
+// distribui uma tarefa antes de WorkStealing_run
+int WorkStealing_push(WorkStealing *ws, size_t worker, size_t task);
+// Coletiva em comm; deve ser chamada antes de WorkStealing_push. Os índices
+// [first_shared, num_tasks) deste processo ficam na janela e são obtidos em blocos de
+// chunk por qualquer processo; remote_task os converte em tarefas.
+int WorkStealing_enable_remote(WorkStealing *ws, MPI_Comm comm, size_t first_shared, size_t num_tasks,
+                               size_t chunk, RemoteTaskFunction remote_task);
+// executa todas as tarefas com ws->num_workers threads do backend de threads
+int WorkStealing_run(WorkStealing *ws, ThreadConfig const *threads, TaskFunction run_task, void *context);
+// coletiva se o roubo entre processos estiver habilitado
+void WorkStealing_free(WorkStealing *ws);
@@ -0,0 +1,378 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include "graph_library.h"
+#include "threading.h"
+
+// Reparo incremental da matriz de distâncias. As atualizações são separadas em aumentos
+// (inclui remoções) e reduções do peso efetivo (o menor entre arestas paralelas):
+//  1. com as distâncias antigas, uma linha s é afetada por um aumento em u -> v se a
+//     aresta era justa, d(s, u) + w_antigo = d(s, v);
+//  2. as linhas afetadas são recalculadas com Dijkstra no grafo com os aumentos mas sem
+//     as reduções, e a matriz volta a ser exata (para esse grafo intermediário);
+//  3. cada redução u -> v com peso w é aplicada em O(V²):
+//     d(i, j) = min(d(i, j), d(i, u) + w + d(v, j)), pulando as linhas em que
+//     d(i, u) + w >= d(i, v), que pela desigualdade triangular não mudam.
+// Cada entrada alterada atualiza a soma de 1/d com a diferença entre o novo e o antigo.
+
+// tolerância relativa do teste de aresta justa: na dúvida a linha é recalculada
+#define UPDATE_TIGHT_TOLERANCE 1e-9
+
+typedef enum
+{
+    UPDATE_AFFECTED, // marca as linhas afetadas pelos aumentos
+    UPDATE_RECOMPUTE, // Dijkstra nas linhas afetadas
+    UPDATE_RELAX,    // aplica uma redução
+} UpdatePhase;
+
+typedef struct
+{
+    Edge edge;         // peso novo (INFINITY: removida)
+    double old_weight; // peso efetivo antes da atualização (INFINITY: não existia)
+} WeightChange;
+
+typedef struct
+{
+    Graph const *graph;
+    MatrixDouble *distances;
+    size_t num_threads;
+    UpdatePhase phase;
+    WeightChange const *increases;
+    size_t num_increases;
+    unsigned char *affected; // uma entrada por linha
+    Edge decrease;           // UPDATE_RELAX
+    atomic_size_t next_row;
+    SsspOptions sssp;
+    VecDouble *rows;           // UPDATE_RECOMPUTE: uma por thread
+    SsspWorkspace *workspaces; // UPDATE_RECOMPUTE: um por thread
+    EfficiencySum *deltas;     // variação da soma de 1/d, uma por thread
+    atomic_int failed;
+} UpdateJob;
+
+static int __compare_pair(void const *a, void const *b)
+{
+    Edge const *x = a;
+    Edge const *y = b;
+    if (x->from != y->from)
+    {
+        return (x->from > y->from) - (x->from < y->from);
+    }
+    return (x->to > y->to) - (x->to < y->to);
+}
+
+// ordena por par e, dentro do par, pela ordem no arquivo
+static int __compare_update_order(void const *a, void const *b)
+{
+    int const by_pair = __compare_pair(a, b);
+    if (by_pair != 0)
+    {
+        return by_pair;
+    }
+    double const x = ((Edge const *)a)->weight;
+    double const y = ((Edge const *)b)->weight;
+    return (x > y) - (x < y);
+}
+
+static double __inverse(double distance)
+{
+    return isinf(distance) || distance == 0.0 ? 0.0 : 1.0 / distance;
+}
+
+static void __mark_affected(UpdateJob *job, size_t s)
+{
+    size_t const V = job->distances->ncols;
+    double const *row = job->distances->data + s * V;
+    for (size_t e = 0; e < job->num_increases; e++)
+    {
+        Edge const *edge = &job->increases[e].edge;
+        double const via_edge = row[edge->from] + job->increases[e].old_weight;
+        if (!isinf(row[edge->to]) && via_edge <= row[edge->to] * (1.0 + UPDATE_TIGHT_TOLERANCE))
+        {
+            job->affected[s] = 1;
+            return;
+        }
+    }
+}
+
+static int __recompute_row(UpdateJob *job, size_t thread_id, size_t s)
+{
+    size_t const V = job->distances->ncols;
+    double *row = job->distances->data + s * V;
+    VecDouble *new_row = &job->rows[thread_id];
+    if (sssp(job->graph, s, new_row, &job->sssp, &job->workspaces[thread_id]) != 0)
+    {
+        return 1;
+    }
+    EfficiencySum old_sum;
+    EfficiencySum_init(&old_sum);
+    EfficiencySum_add_row(&old_sum, row, V, s);
+    EfficiencySum_add_row(&job->deltas[thread_id], new_row->data, V, s);
+    EfficiencySum_add(&job->deltas[thread_id], -EfficiencySum_value(&old_sum));
+    memcpy(row, new_row->data, V * sizeof(double));
+    return 0;
+}
+
+// a linha v só mudaria com um ciclo de peso negativo, então pode ser lida enquanto as
+// outras são escritas
+static void __relax_row(UpdateJob *job, size_t thread_id, size_t i)
+{
+    size_t const V = job->distances->ncols;
+    Edge const *edge = &job->decrease;
+    double *row = job->distances->data + i * V;
+    double const *via_row = job->distances->data + edge->to * V;
+    double const to_edge = row[edge->from] + edge->weight;
+    if (!(to_edge < row[edge->to]))
+    {
+        return;
+    }
+    for (size_t j = 0; j < V; j++)
+    {
+        double const candidate = to_edge + via_row[j];
+        if (candidate < row[j])
+        {
+            EfficiencySum_add(&job->deltas[thread_id], __inverse(candidate) - __inverse(row[j]));
+            row[j] = candidate;
+        }
+    }
+}
+
+static int __update_worker(void *arg, size_t thread_id)
+{
+    UpdateJob *job = arg;
+    size_t const V = job->distances->nrows;
+    for (;;)
+    {
+        size_t const i = atomic_fetch_add(&job->next_row, 1);
+        if (i >= V)
+        {
+            return 0;
+        }
+        switch (job->phase)
+        {
+        case UPDATE_AFFECTED:
+            __mark_affected(job, i);
+            break;
+        case UPDATE_RECOMPUTE:
+            if (job->affected[i] && __recompute_row(job, thread_id, i) != 0)
+            {
+                atomic_store(&job->failed, 1);
+                return 1;
+            }
+            break;
+        case UPDATE_RELAX:
+            __relax_row(job, thread_id, i);
+            break;
+        }
+    }
+}
+
+static int __run_update_phase(UpdateJob *job, UpdatePhase phase, ThreadConfig const *threads)
+{
+    job->phase = phase;
+    atomic_store(&job->next_row, 0);
+    run_threads(threads, job->num_threads, __update_worker, job);
+    return atomic_load(&job->failed);
+}
+
+// substitui as arestas dos pares de changes (ordenado por par) pelos pesos novos;
+// com only_increases as reduções ficam para depois, com o peso antigo
+static int __apply_changes(Graph *graph, WeightChange const *changes, Edge const *sorted_pairs,
+                           size_t num_changes, int only_increases)
+{
+    VecEdge edges;
+    VecEdge_init(&edges);
+    if (VecEdge_reserve(&edges, graph->E + num_changes) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da edgelist atualizada\n");
+        return 1;
+    }
+    for (size_t e = 0; e < graph->E; e++)
+    {
+        Edge const *edge = &graph->edge_list.data[e];
+        Edge const *pair = bsearch(edge, sorted_pairs, num_changes, sizeof(Edge), __compare_pair);
+        if (pair == NULL && VecEdge_push_back(&edges, *edge) != 0)
+        {
+            goto clean_up;
+        }
+    }
+    for (size_t c = 0; c < num_changes; c++)
+    {
+        int const decrease = changes[c].edge.weight < changes[c].old_weight;
+        double const weight = only_increases && decrease ? changes[c].old_weight : changes[c].edge.weight;
+        if (!isinf(weight))
+        {
+            Edge edge = changes[c].edge;
+            edge.weight = weight;
+            if (VecEdge_push_back(&edges, edge) != 0)
+            {
+                goto clean_up;
+            }
+        }
+    }
+    VecEdge_free(&graph->edge_list);
+    graph->edge_list = edges;
+    graph->E = edges.size;
+    return 0;
+
+clean_up:
+    fprintf(stderr, "Falha na alocação da edgelist atualizada\n");
+    VecEdge_free(&edges);
+    return 1;
+}
+
+static int __rebuild_adjacency(Graph *graph, ThreadConfig const *threads)
+{
+    if (graph->mapping != NULL)
+    {
+        // o CSR antigo aponta para o arquivo binário mapeado, que deixa de ser usado
+        AdjList_init(&graph->adjacency_list);
+        munmap(graph->mapping, graph->mapping_size);
+        graph->mapping = NULL;
+        graph->mapping_size = 0;
+    }
+    AdjacencyOptions options;
+    AdjacencyOptions_init(&options);
+    options.threads = *threads;
+    return Graph_create_adjacency_list_with_options(graph, &options);
+}
+
+int floyd_warshall_update(Graph *graph, MatrixDouble *distances, Edge const *updates, size_t num_updates,
+                          ThreadConfig const *threads, EfficiencySum *efficiency_sum)
+{
+    size_t const V = graph->V;
+    if (distances->nrows != V || distances->ncols != V)
+    {
+        fprintf(stderr, "A matriz de distâncias não corresponde ao grafo\n");
+        return 1;
+    }
+    if (graph->edge_list.data == NULL && graph->E > 0)
+    {
+        fprintf(stderr, "A edgelist está vazia, não é possível atualizar o grafo\n");
+        return 1;
+    }
+    for (size_t c = 0; c < num_updates; c++)
+    {
+        if (updates[c].from >= V || updates[c].to >= V || !(updates[c].weight > 0.0))
+        {
+            fprintf(stderr, "Atualização inválida: %zu %zu %f\n", updates[c].from, updates[c].to, updates[c].weight);
+            return 1;
+        }
+    }
+
+    int result = 1;
+    size_t const num_threads = threads->num_threads > 0 ? threads->num_threads : 1;
+    UpdateJob job = {.graph = graph, .distances = distances, .num_threads = num_threads,
+                     .affected = calloc(V > 0 ? V : 1, 1),
+                     .rows = calloc(num_threads, sizeof(VecDouble)),
+                     .workspaces = calloc(num_threads, sizeof(SsspWorkspace)),
+                     .deltas = calloc(num_threads, sizeof(EfficiencySum))};
+    atomic_init(&job.next_row, 0);
+    atomic_init(&job.failed, 0);
+    SsspOptions_init(&job.sssp);
+    Edge *pairs = malloc((num_updates > 0 ? num_updates : 1) * sizeof(Edge));
+    WeightChange *changes = malloc((num_updates > 0 ? num_updates : 1) * sizeof(WeightChange));
+    WeightChange *increases = malloc((num_updates > 0 ? num_updates : 1) * sizeof(WeightChange));
+    size_t initialized_threads = 0;
+    if (job.affected == NULL || job.rows == NULL || job.workspaces == NULL || job.deltas == NULL ||
+        pairs == NULL || changes == NULL || increases == NULL)
+    {
+        fprintf(stderr, "Falha na alocação da atualização incremental\n");
+        goto clean_up;
+    }
+    for (; initialized_threads < num_threads; initialized_threads++)
+    {
+        VecDouble_init(&job.rows[initialized_threads]);
+        SsspWorkspace_init(&job.workspaces[initialized_threads], &job.sssp);
+        EfficiencySum_init(&job.deltas[initialized_threads]);
+    }
+
+    // uma atualização por par: a última de cada par prevalece (o peso guarda o índice)
+    for (size_t c = 0; c < num_updates; c++)
+    {
+        pairs[c] = updates[c];
+        pairs[c].weight = (double)c;
+    }
+    qsort(pairs, num_updates, sizeof(Edge), __compare_update_order);
+    size_t num_changes = 0;
+    for (size_t c = 0; c < num_updates; c++)
+    {
+        if (c + 1 < num_updates && __compare_pair(&pairs[c], &pairs[c + 1]) == 0)
+        {
+            continue;
+        }
+        changes[num_changes].edge = updates[(size_t)pairs[c].weight];
+        changes[num_changes].old_weight = INFINITY;
+        pairs[num_changes++] = pairs[c];
+    }
+    for (size_t e = 0; e < graph->E; e++)
+    {
+        Edge const *edge = &graph->edge_list.data[e];
+        Edge const *pair = bsearch(edge, pairs, num_changes, sizeof(Edge), __compare_pair);
+        if (pair != NULL && edge->weight < changes[pair - pairs].old_weight)
+        {
+            changes[pair - pairs].old_weight = edge->weight;
+        }
+    }
+    for (size_t c = 0; c < num_changes; c++)
+    {
+        if (changes[c].edge.weight > changes[c].old_weight)
+        {
+            increases[job.num_increases++] = changes[c];
+        }
+    }
+    job.increases = increases;
+
+    // 1 e 2: aumentos, com o grafo intermediário
+    if (job.num_increases > 0)
+    {
+        __run_update_phase(&job, UPDATE_AFFECTED, threads);
+        if (__apply_changes(graph, changes, pairs, num_changes, 1) != 0 ||
+            __rebuild_adjacency(graph, threads) != 0)
+        {
+            goto clean_up;
+        }
+        if (__run_update_phase(&job, UPDATE_RECOMPUTE, threads) != 0)
+        {
+            fprintf(stderr, "Falha no recálculo das linhas afetadas\n");
+            goto clean_up;
+        }
+    }
+    // 3: reduções, uma de cada vez sobre a matriz já exata
+    for (size_t c = 0; c < num_changes; c++)
+    {
+        if (changes[c].edge.weight < changes[c].old_weight)
+        {
+            job.decrease = changes[c].edge;
+            __run_update_phase(&job, UPDATE_RELAX, threads);
+        }
+    }
+    if (__apply_changes(graph, changes, pairs, num_changes, 0) != 0 || __rebuild_adjacency(graph, threads) != 0)
+    {
+        goto clean_up;
+    }
+    for (size_t t = 0; t < num_threads; t++)
+    {
+        EfficiencySum_merge(efficiency_sum, &job.deltas[t]);
+    }
+    result = 0;
+
+clean_up:
+    for (size_t t = 0; t < initialized_threads; t++)
+    {
+        VecDouble_free(&job.rows[t]);
+        SsspWorkspace_free(&job.workspaces[t]);
+    }
+    free(job.affected);
+    free(job.rows);
+    free(job.workspaces);
+    free(job.deltas);
+    free(pairs);
+    free(changes);
+    free(increases);
+    return result;
+}
@@ -1,90 +1,1505 @@
+#include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <time.h>
 #include "data_structures.h"
 #include "graph_library.h"
+#include "min_plus.h"
+#include "benchmark.h"
+#include "numa_topology.h"
+#include "profiling.h"
 #include <string.h>
 #include <threads.h>
 #include <stdlib.h>
 #include <mpi.h>
+#include <math.h>
+#include <float.h>
 
 #ifdef COMPARE_WITH_IGRAPH
     #include <igraph.h>
 #endif
 
-int main(int argc, char **argv)
+typedef enum
+{
+    ENGINE_AUTO,
+    ENGINE_DIJKSTRA,
+    ENGINE_FW_1D,
+    ENGINE_FW_BLOCKED,
+    ENGINE_FW_2D,
+    ENGINE_FW_PIPELINED,
+    ENGINE_FW_THREADS,
+    ENGINE_FW_OUT_OF_CORE,
+} Engine;
+
+static char const *const ENGINE_NAMES[] = {"auto", "dijkstra", "fw-1d", "fw-blocked", "fw-2d", "fw-pipelined",
+                                           "fw-threads", "fw-ooc"};
+
+typedef enum
+{
+    BACKEND_C11,
+    BACKEND_OPENMP,
+    BACKEND_COMPARE, // executa com OpenMP e depois com threads C11, reportando os dois tempos
+} BackendChoice;
+
+typedef enum
+{
+    PRECISION_DOUBLE,
+    PRECISION_FLOAT,
+    PRECISION_COMPARE, // executa em double e depois em float, reportando o erro relativo
+} PrecisionChoice;
+
+// maior erro relativo aceito entre as eficiências em float e em double
+#define FLOAT_EFFICIENCY_TOLERANCE 1e-5
+
+typedef struct
+{
+    char const *graph_file;
+    Engine engine;
+    size_t tile_size;
+    int gather; // reúne a matriz V×V no processo 0 antes de somar 1/d (fw-1d, fw-2d, fw-pipelined)
+    PartitionKind partition;
+    size_t num_threads; // 0: lido das variáveis de ambiente do backend
+    BackendChoice backend;
+    ThreadSchedule schedule; // distribuição das fontes do Dijkstra entre as threads
+    ThreadPinning pinning;   // CPUs dos processos e das threads do Floyd-Warshall
+    PriorityQueueKind queue; // fila de prioridade do Dijkstra
+    SsspAlgorithm sssp;      // algoritmo de fonte única do engine dijkstra
+    double delta;            // Δ do delta-stepping; 0 escolhe automaticamente
+    PrecisionChoice precision; // tipo da matriz de distâncias dos engines Floyd-Warshall
+    int sampled;               // estima a eficiência com um subconjunto das fontes
+    SamplingOptions sampling;
+    char const *updates_file; // atualizações de arestas aplicadas depois do cálculo (fw-threads, fw-blocked)
+    CheckpointOptions checkpoint; // fw-1d e fw-pipelined
+    OutOfCoreOptions out_of_core; // fw-ooc (o tile_size vem de --tile-size)
+    int out_of_core_given;        // alguma opção --ooc-*, que implica o fw-ooc
+    int path_requested;           // imprime um caminho mínimo (dijkstra, fw-threads, fw-1d)
+    size_t path_from;
+    size_t path_to;
+    int benchmark;              // main_cli bench
+    int generated;              // grafo sintético em vez de graph_file (apenas no benchmark)
+    GeneratorOptions generator;
+    BenchmarkOptions bench;
+} CliOptions;
+
+// maior --tile-size aceito; o fw-ooc aloca tiles de MAX_CLI_TILE_SIZE² elementos
+#define MAX_CLI_TILE_SIZE 65536
+
+// inteiro sem sinal no início de text: recusa sinal, espaços e estouro; end aponta para o resto
+static int parse_unsigned(char const *text, char **end, unsigned long long *value)
+{
+    if (*text < '0' || *text > '9')
+    {
+        return 1;
+    }
+    errno = 0;
+    *value = strtoull(text, end, 10);
+    return errno == ERANGE;
+}
+
+static int parse_size(char const *option, char const *text, size_t min, size_t max, size_t *value)
+{
+    char *end;
+    unsigned long long parsed;
+    if (parse_unsigned(text, &end, &parsed) != 0 || *end != '\0' || parsed < min || parsed > max)
+    {
+        if (max == SIZE_MAX)
+        {
+            fprintf(stderr, "Erro: %s deve ser um inteiro maior ou igual a %zu\n", option, min);
+        }
+        else
+        {
+            fprintf(stderr, "Erro: %s deve ser um inteiro entre %zu e %zu\n", option, min, max);
+        }
+        return 1;
+    }
+    *value = (size_t)parsed;
+    return 0;
+}
+
+// real finito em [min, max]
+static int parse_double(char const *option, char const *text, double min, double max, double *value)
+{
+    char *end;
+    errno = 0;
+    double const parsed = strtod(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !isfinite(parsed) || parsed < min || parsed > max)
+    {
+        fprintf(stderr, "Erro: valor inválido para %s: '%s'\n", option, text);
+        return 1;
+    }
+    *value = parsed;
+    return 0;
+}
+
+// com benchmark, argv[0] é "bench" e o grafo pode vir de --generator em vez de um arquivo
+static int parse_options(int argc, char **argv, int benchmark, CliOptions *options)
+{
+    options->graph_file = NULL;
+    options->engine = ENGINE_AUTO;
+    options->tile_size = 0;
+    options->gather = 0;
+    options->partition = PARTITION_BLOCK;
+    options->num_threads = 0;
+    options->backend = BACKEND_C11;
+    options->schedule = SCHEDULE_WORK_STEALING;
+    options->pinning = PIN_NONE;
+    options->queue = PRIORITY_QUEUE_DEFAULT;
+    options->sssp = SSSP_DIJKSTRA;
+    options->delta = 0.0;
+    options->precision = PRECISION_DOUBLE;
+    options->sampled = 0;
+    SamplingOptions_init(&options->sampling);
+    options->updates_file = NULL;
+    CheckpointOptions_init(&options->checkpoint);
+    int checkpoint_seconds_given = 0;
+    OutOfCoreOptions_init(&options->out_of_core);
+    options->out_of_core_given = 0;
+    options->path_requested = 0;
+    options->benchmark = benchmark;
+    options->generated = 0;
+    GeneratorOptions_init(&options->generator);
+    BenchmarkOptions_init(&options->bench);
+    int format_given = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        char const *arg = argv[i];
+        if (strncmp(arg, "--engine=", 9) == 0)
+        {
+            char const *value = arg + 9;
+            if (strcmp(value, "auto") == 0)
+            {
+                options->engine = ENGINE_AUTO;
+            }
+            else if (strcmp(value, "dijkstra") == 0)
+            {
+                options->engine = ENGINE_DIJKSTRA;
+            }
+            else if (strcmp(value, "fw-1d") == 0)
+            {
+                options->engine = ENGINE_FW_1D;
+            }
+            else if (strcmp(value, "fw-blocked") == 0)
+            {
+                options->engine = ENGINE_FW_BLOCKED;
+            }
+            else if (strcmp(value, "fw-2d") == 0)
+            {
+                options->engine = ENGINE_FW_2D;
+            }
+            else if (strcmp(value, "fw-threads") == 0)
+            {
+                options->engine = ENGINE_FW_THREADS;
+            }
+            else if (strcmp(value, "fw-pipelined") == 0)
+            {
+                options->engine = ENGINE_FW_PIPELINED;
+            }
+            else if (strcmp(value, "fw-ooc") == 0)
+            {
+                options->engine = ENGINE_FW_OUT_OF_CORE;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: engine desconhecida '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--tile-size=", 12) == 0)
+        {
+            if (parse_size("--tile-size", arg + 12, 1, MAX_CLI_TILE_SIZE, &options->tile_size) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--partition=", 12) == 0)
+        {
+            char const *value = arg + 12;
+            if (strcmp(value, "block") == 0)
+            {
+                options->partition = PARTITION_BLOCK;
+            }
+            else if (strcmp(value, "cyclic") == 0)
+            {
+                options->partition = PARTITION_CYCLIC;
+            }
+            else if (strcmp(value, "block-cyclic") == 0)
+            {
+                options->partition = PARTITION_BLOCK_CYCLIC;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: partição desconhecida '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--threads=", 10) == 0)
+        {
+            if (parse_size("--threads", arg + 10, 1, THREADS_MAX_THREADS, &options->num_threads) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--threads-backend=", 18) == 0)
+        {
+            char const *value = arg + 18;
+            if (strcmp(value, "c11") == 0)
+            {
+                options->backend = BACKEND_C11;
+            }
+            else if (strcmp(value, "openmp") == 0)
+            {
+                options->backend = BACKEND_OPENMP;
+            }
+            else if (strcmp(value, "compare") == 0)
+            {
+                options->backend = BACKEND_COMPARE;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: backend de threads desconhecido '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--schedule=", 11) == 0)
+        {
+            char const *value = arg + 11;
+            if (strcmp(value, "static") == 0)
+            {
+                options->schedule = SCHEDULE_STATIC;
+            }
+            else if (strcmp(value, "dynamic") == 0)
+            {
+                options->schedule = SCHEDULE_DYNAMIC;
+            }
+            else if (strcmp(value, "work-stealing") == 0)
+            {
+                options->schedule = SCHEDULE_WORK_STEALING;
+            }
+            else if (strcmp(value, "work-stealing-mpi") == 0)
+            {
+                options->schedule = SCHEDULE_WORK_STEALING_MPI;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: escalonamento desconhecido '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--pin=", 6) == 0)
+        {
+            char const *value = arg + 6;
+            if (strcmp(value, "none") == 0)
+            {
+                options->pinning = PIN_NONE;
+            }
+            else if (strcmp(value, "compact") == 0)
+            {
+                options->pinning = PIN_COMPACT;
+            }
+            else if (strcmp(value, "scatter") == 0)
+            {
+                options->pinning = PIN_SCATTER;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: fixação desconhecida '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--queue=", 8) == 0)
+        {
+            char const *value = arg + 8;
+            if (strcmp(value, "binary") == 0)
+            {
+                options->queue = PRIORITY_QUEUE_BINARY;
+            }
+            else if (strcmp(value, "4-ary") == 0)
+            {
+                options->queue = PRIORITY_QUEUE_4ARY;
+            }
+            else if (strcmp(value, "8-ary") == 0)
+            {
+                options->queue = PRIORITY_QUEUE_8ARY;
+            }
+            else if (strcmp(value, "lazy") == 0)
+            {
+                options->queue = PRIORITY_QUEUE_LAZY;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: fila de prioridade desconhecida '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--sssp=", 7) == 0)
+        {
+            char const *value = arg + 7;
+            if (strcmp(value, "dijkstra") == 0)
+            {
+                options->sssp = SSSP_DIJKSTRA;
+            }
+            else if (strcmp(value, "radix-heap") == 0)
+            {
+                options->sssp = SSSP_RADIX_HEAP;
+            }
+            else if (strcmp(value, "delta-stepping") == 0)
+            {
+                options->sssp = SSSP_DELTA_STEPPING;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: algoritmo de fonte única desconhecido '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--delta=", 8) == 0)
+        {
+            if (parse_double("--delta", arg + 8, 0.0, DBL_MAX, &options->delta) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--precision=", 12) == 0)
+        {
+            char const *value = arg + 12;
+            if (strcmp(value, "double") == 0)
+            {
+                options->precision = PRECISION_DOUBLE;
+            }
+            else if (strcmp(value, "float") == 0)
+            {
+                options->precision = PRECISION_FLOAT;
+            }
+            else if (strcmp(value, "compare") == 0)
+            {
+                options->precision = PRECISION_COMPARE;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: precisão desconhecida '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--sample=", 9) == 0)
+        {
+            options->sampled = 1;
+            if (parse_size("--sample", arg + 9, 1, SIZE_MAX, &options->sampling.num_sources) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--sample-strategy=", 18) == 0)
+        {
+            char const *value = arg + 18;
+            if (strcmp(value, "uniform") == 0)
+            {
+                options->sampling.kind = SAMPLING_UNIFORM;
+            }
+            else if (strcmp(value, "degree") == 0)
+            {
+                options->sampling.kind = SAMPLING_DEGREE;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: estratégia de amostragem desconhecida '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--target-error=", 15) == 0)
+        {
+            options->sampled = 1;
+            if (parse_double("--target-error", arg + 15, DBL_MIN, 1.0, &options->sampling.target_relative_error) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--confidence=", 13) == 0)
+        {
+            if (parse_double("--confidence", arg + 13, DBL_MIN, 1.0 - DBL_EPSILON, &options->sampling.confidence) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--strata=", 9) == 0)
+        {
+            if (parse_size("--strata", arg + 9, 1, SIZE_MAX, &options->sampling.num_strata) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (strncmp(arg, "--seed=", 7) == 0)
+        {
+            // semente da amostragem e do gerador de grafos
+            char *end;
+            unsigned long long seed;
+            if (parse_unsigned(arg + 7, &end, &seed) != 0 || *end != '\0')
+            {
+                fprintf(stderr, "Erro: --seed deve ser um inteiro sem sinal\n");
+                return 1;
+            }
+            options->sampling.seed = seed;
+            options->generator.seed = options->sampling.seed;
+        }
+        else if (strncmp(arg, "--updates=", 10) == 0)
+        {
+            options->updates_file = arg + 10;
+        }
+        else if (strncmp(arg, "--checkpoint=", 13) == 0)
+        {
+            options->checkpoint.path = arg + 13;
+        }
+        else if (strncmp(arg, "--checkpoint-every=", 19) == 0)
+        {
+            // só o intervalo em iterações, a menos que --checkpoint-seconds também seja dado
+            if (parse_size("--checkpoint-every", arg + 19, 1, SIZE_MAX, &options->checkpoint.interval_iterations) != 0)
+            {
+                return 1;
+            }
+            if (!checkpoint_seconds_given)
+            {
+                options->checkpoint.interval_seconds = 0.0;
+            }
+        }
+        else if (strncmp(arg, "--checkpoint-seconds=", 21) == 0)
+        {
+            if (parse_double("--checkpoint-seconds", arg + 21, 0.0, DBL_MAX, &options->checkpoint.interval_seconds) != 0)
+            {
+                return 1;
+            }
+            checkpoint_seconds_given = 1;
+        }
+        else if (strcmp(arg, "--resume") == 0)
+        {
+            options->checkpoint.resume = 1;
+        }
+        else if (strncmp(arg, "--ooc-file=", 11) == 0)
+        {
+            options->out_of_core.path = arg + 11;
+            options->out_of_core_given = 1;
+        }
+        else if (strncmp(arg, "--ooc-memory=", 13) == 0)
+        {
+            // em MB; o limite evita o estouro do << 20
+            size_t megabytes;
+            if (parse_size("--ooc-memory", arg + 13, 1, SIZE_MAX >> 20, &megabytes) != 0)
+            {
+                return 1;
+            }
+            options->out_of_core.memory_budget = megabytes << 20;
+            options->out_of_core_given = 1;
+        }
+        else if (strncmp(arg, "--ooc-prefetch=", 15) == 0)
+        {
+            if (parse_size("--ooc-prefetch", arg + 15, 0, SIZE_MAX, &options->out_of_core.prefetch_depth) != 0)
+            {
+                return 1;
+            }
+            options->out_of_core_given = 1;
+        }
+        else if (strncmp(arg, "--path=", 7) == 0)
+        {
+            char *end;
+            unsigned long long from;
+            unsigned long long to;
+            if (parse_unsigned(arg + 7, &end, &from) != 0 || *end != ',' ||
+                parse_unsigned(end + 1, &end, &to) != 0 || *end != '\0' || from > SIZE_MAX || to > SIZE_MAX)
+            {
+                fprintf(stderr, "Erro: use --path=ORIGEM,DESTINO\n");
+                return 1;
+            }
+            options->path_from = (size_t)from;
+            options->path_to = (size_t)to;
+            options->path_requested = 1;
+        }
+        else if (benchmark && strncmp(arg, "--generator=", 12) == 0)
+        {
+            char const *value = arg + 12;
+            options->generated = 1;
+            if (strcmp(value, "er") == 0)
+            {
+                options->generator.kind = GENERATOR_ERDOS_RENYI;
+            }
+            else if (strcmp(value, "rmat") == 0)
+            {
+                options->generator.kind = GENERATOR_RMAT;
+            }
+            else if (strcmp(value, "grid") == 0)
+            {
+                options->generator.kind = GENERATOR_GRID;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: gerador desconhecido '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (benchmark && strncmp(arg, "--vertices=", 11) == 0)
+        {
+            if (parse_size("--vertices", arg + 11, 1, UINT32_MAX, &options->generator.V) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (benchmark && strncmp(arg, "--edges=", 8) == 0)
+        {
+            if (parse_size("--edges", arg + 8, 0, SIZE_MAX, &options->generator.E) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (benchmark && strncmp(arg, "--max-weight=", 13) == 0)
+        {
+            if (parse_double("--max-weight", arg + 13, DBL_MIN, DBL_MAX, &options->generator.max_weight) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (benchmark && strncmp(arg, "--warmup=", 9) == 0)
+        {
+            if (parse_size("--warmup", arg + 9, 0, SIZE_MAX, &options->bench.warmup) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (benchmark && strncmp(arg, "--repetitions=", 14) == 0)
+        {
+            if (parse_size("--repetitions", arg + 14, 1, SIZE_MAX, &options->bench.repetitions) != 0)
+            {
+                return 1;
+            }
+        }
+        else if (benchmark && strncmp(arg, "--output=", 9) == 0)
+        {
+            options->bench.output = arg + 9;
+        }
+        else if (benchmark && strncmp(arg, "--format=", 9) == 0)
+        {
+            char const *value = arg + 9;
+            format_given = 1;
+            if (strcmp(value, "json") == 0)
+            {
+                options->bench.format = BENCHMARK_JSON;
+            }
+            else if (strcmp(value, "csv") == 0)
+            {
+                options->bench.format = BENCHMARK_CSV;
+            }
+            else
+            {
+                fprintf(stderr, "Erro: formato desconhecido '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (strcmp(arg, "--gather") == 0)
+        {
+            options->gather = 1;
+        }
+        else if (strcmp(arg, "--no-gather") == 0)
+        {
+            options->gather = 0;
+        }
+        else if (strncmp(arg, "--", 2) == 0)
+        {
+            fprintf(stderr, "Erro: opção desconhecida '%s'\n", arg);
+            return 1;
+        }
+        else if (options->graph_file == NULL)
+        {
+            options->graph_file = arg;
+        }
+        else
+        {
+            return 1;
+        }
+    }
+    if (options->out_of_core_given && options->engine != ENGINE_AUTO && options->engine != ENGINE_FW_OUT_OF_CORE)
+    {
+        fprintf(stderr, "Erro: as opções --ooc-* só valem para o engine fw-ooc\n");
+        return 1;
+    }
+    if (options->out_of_core_given)
+    {
+        // as demais restrições abaixo valem como se o engine tivesse sido dado
+        options->engine = ENGINE_FW_OUT_OF_CORE;
+    }
+    if (options->engine == ENGINE_FW_OUT_OF_CORE && options->precision != PRECISION_DOUBLE)
+    {
+        fprintf(stderr, "Erro: o engine fw-ooc só existe em double\n");
+        return 1;
+    }
+    if (options->sampled && ((options->engine != ENGINE_AUTO && options->engine != ENGINE_DIJKSTRA) ||
+                             options->precision != PRECISION_DOUBLE))
+    {
+        fprintf(stderr, "Erro: a amostragem de fontes só está disponível no engine dijkstra, em double\n");
+        return 1;
+    }
+    if (options->updates_file != NULL &&
+        ((options->engine != ENGINE_AUTO && options->engine != ENGINE_FW_THREADS &&
+          options->engine != ENGINE_FW_BLOCKED) ||
+         options->sampled || options->precision != PRECISION_DOUBLE))
+    {
+        fprintf(stderr, "Erro: as atualizações incrementais precisam da matriz completa em double "
+                        "(engines fw-threads e fw-blocked)\n");
+        return 1;
+    }
+    if (options->checkpoint.resume && options->checkpoint.path == NULL)
+    {
+        fprintf(stderr, "Erro: --resume precisa de --checkpoint=FILE\n");
+        return 1;
+    }
+    if (options->checkpoint.path != NULL &&
+        ((options->engine != ENGINE_AUTO && options->engine != ENGINE_FW_1D &&
+          options->engine != ENGINE_FW_PIPELINED) ||
+         options->sampled || options->precision != PRECISION_DOUBLE || options->updates_file != NULL))
+    {
+        fprintf(stderr, "Erro: os checkpoints só estão disponíveis nos engines fw-1d e fw-pipelined, em double\n");
+        return 1;
+    }
+    if (options->path_requested &&
+        ((options->engine != ENGINE_AUTO && options->engine != ENGINE_DIJKSTRA &&
+          options->engine != ENGINE_FW_THREADS && options->engine != ENGINE_FW_1D) ||
+         options->precision != PRECISION_DOUBLE || options->updates_file != NULL ||
+         options->checkpoint.path != NULL))
+    {
+        fprintf(stderr, "Erro: --path só está disponível nos engines dijkstra, fw-threads e fw-1d, em double, "
+                        "sem --updates e sem checkpoints\n");
+        return 1;
+    }
+    if (benchmark)
+    {
+        if (options->updates_file != NULL || options->checkpoint.path != NULL || options->path_requested ||
+            options->backend == BACKEND_COMPARE || options->precision == PRECISION_COMPARE)
+        {
+            fprintf(stderr, "Erro: o benchmark mede só o cálculo da eficiência (sem --updates, checkpoints, "
+                            "--path e comparações)\n");
+            return 1;
+        }
+        if (options->generated == (options->graph_file != NULL))
+        {
+            fprintf(stderr, "Erro: o benchmark precisa de um arquivo de grafo ou de --generator (não ambos)\n");
+            return 1;
+        }
+        size_t const length = options->bench.output != NULL ? strlen(options->bench.output) : 0;
+        if (!format_given && length >= 4 && strcmp(options->bench.output + length - 4, ".csv") == 0)
+        {
+            options->bench.format = BENCHMARK_CSV;
+        }
+        return 0;
+    }
+    return options->graph_file == NULL;
+}
+
+static void thread_config_from_options(CliOptions const *options, ThreadBackend backend,
+                                       ThreadConfig *threads)
 {
-    MPI_Init(&argc, &argv);
-    int nprocs;
-    int rank;
+    ThreadConfig_from_env(threads, backend);
+    threads->schedule = options->schedule;
+    threads->pinning = options->pinning;
+    if (options->num_threads != 0)
+    {
+        threads->num_threads = options->num_threads;
+    }
+}
+
+// Dijkstra de todas as fontes custa ~ V (E + V) log V, contra V^3 do Floyd-Warshall
+// (cujo laço interno vetorizado processa ~8 elementos por instrução)
+static int prefers_dijkstra(size_t num_vertices, size_t num_edges)
+{
+    double const V = (double)num_vertices;
+    double const E = (double)num_edges;
+    double const log_v = V > 2 ? log2(V) : 1.0;
+    return (E + V) * log_v < V * V / 8.0;
+}
+
+// o Dijkstra só existe em double: com --precision=float|compare o engine automático é o
+// fw-1d; a amostragem de fontes sempre usa o Dijkstra, as atualizações incrementais o
+// fw-threads, que mantém a matriz inteira no processo 0, e os checkpoints o fw-1d
+static void resolve_auto_engine(CliOptions *options, size_t V, size_t E)
+{
+    if (options->engine == ENGINE_AUTO && options->updates_file != NULL)
+    {
+        options->engine = ENGINE_FW_THREADS;
+    }
+    else if (options->engine == ENGINE_AUTO && options->checkpoint.path != NULL)
+    {
+        options->engine = ENGINE_FW_1D;
+    }
+    else if (options->engine == ENGINE_AUTO)
+    {
+        options->engine = options->sampled || (options->precision == PRECISION_DOUBLE && prefers_dijkstra(V, E))
+                              ? ENGINE_DIJKSTRA
+                              : ENGINE_FW_1D;
+    }
+}
+
+static double efficiency_from_matrix(MatrixDouble const *distances)
+{
+    size_t const V = distances->nrows;
+    EfficiencySum sum;
+    EfficiencySum_init(&sum);
+    for (size_t i = 0; i < V; i++)
+    {
+        EfficiencySum_add_row(&sum, distances->data + i * V, V, i);
+    }
+    return V > 1 ? EfficiencySum_value(&sum) / ((double)V * (double)(V - 1)) : 0.0;
+}
+
+static double efficiency_from_matrix_float(MatrixFloat const *distances)
+{
+    size_t const V = distances->nrows;
+    EfficiencySum sum;
+    EfficiencySum_init(&sum);
+    for (size_t i = 0; i < V; i++)
+    {
+        EfficiencySum_add_row_float(&sum, distances->data + i * V, V, i);
+    }
+    return V > 1 ? EfficiencySum_value(&sum) / ((double)V * (double)(V - 1)) : 0.0;
+}
+
+static void print_rank_timings(RankTimings const *timings)
+{
+    int rank, nprocs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    double local_timings[2] = {timings->wait_time, timings->compute_time};
+    double *all_timings = rank == 0 ? malloc(2 * nprocs * sizeof(double)) : NULL;
+    MPI_Gather(local_timings, 2, MPI_DOUBLE, all_timings, 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank == 0)
+    {
+        for (int p = 0; p < nprocs; p++)
+        {
+            fprintf(stderr, "Processo %d: espera %.6f s, computação %.6f s\n",
+                    p, all_timings[2 * p], all_timings[2 * p + 1]);
+        }
+        free(all_timings);
+    }
+}
+
+// fw-1d com a matriz de próximos vértices distribuída; a eficiência é sempre reduzida
+// sem reunir a matriz e o caminho é extraído com a participação de todos os processos
+static int fw_1d_paths_efficiency(CliOptions const *options, ThreadConfig const *threads, Graph const *graph,
+                                  double *efficiency, VecSizeT *path)
+{
+    FloydWarshallOptions fw_options;
+    FloydWarshallOptions_init(&fw_options);
+    fw_options.partition = options->partition;
+    fw_options.threads = *threads;
+    if (options->tile_size != 0)
+    {
+        fw_options.block_size = options->tile_size;
+    }
+    DistributedPaths paths;
+    if (floyd_warshall_openmpi_paths(graph, &fw_options, &paths, NULL) != 0)
+    {
+        return 1;
+    }
+    size_t const V = paths.local_distances.ncols;
+    EfficiencySum partial_sum;
+    EfficiencySum_init(&partial_sum);
+    for (size_t i = 0; i < paths.local_distances.nrows; i++)
+    {
+        EfficiencySum_add_row(&partial_sum, paths.local_distances.data + i * V, V,
+                              RowPartition_global_index(&paths.partition, paths.rank, i));
+    }
+    *efficiency = global_efficiency(&partial_sum, V, 0, MPI_COMM_WORLD);
+    int const status = DistributedPaths_extract(&paths, options->path_from, options->path_to, path, MPI_COMM_WORLD);
+    DistributedPaths_free(&paths);
+    return status;
+}
+
+// executa a engine escolhida; o resultado só é válido no processo 0. Com amostragem,
+// estimate (se não for NULL) recebe também o intervalo de confiança; com fw-threads e
+// fw-blocked, distances_out (se não for NULL) fica com a matriz no processo 0; path (se
+// não for NULL) recebe no processo 0 o caminho de --path; timings (se não for NULL) os
+// tempos deste processo que o engine separa
+static int compute_global_efficiency(CliOptions const *options, ThreadConfig const *threads,
+                                     Graph const *graph, double *global_efficiency,
+                                     EfficiencyEstimate *estimate, MatrixDouble *distances_out, VecSizeT *path,
+                                     RankTimings *timings)
+{
+    int rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    
+    int status = 0;
+    RankTimings local_timings = {0.0, 0.0, 0.0, 0.0};
+    MatrixDouble distances;
+    MatrixDouble_init(&distances, 0, 0);
+    // sem --gather a matriz completa nunca existe: a eficiência é reduzida entre os processos
+    MatrixDouble *output = options->gather ? &distances : NULL;
+    double *efficiency_output = options->gather ? NULL : global_efficiency;
+
+    switch (options->engine)
+    {
+    case ENGINE_AUTO:
+    case ENGINE_DIJKSTRA:
+    {
+        output = NULL;
+        SsspOptions sssp;
+        SsspOptions_init(&sssp);
+        sssp.algorithm = options->sssp;
+        sssp.queue = options->queue;
+        sssp.delta = options->delta;
+        if (options->sampled)
+        {
+            EfficiencyEstimate sampled;
+            status = sampled_efficiency(graph, threads, &sssp, &options->sampling, &sampled);
+            *global_efficiency = sampled.efficiency;
+            if (estimate != NULL)
+            {
+                *estimate = sampled;
+            }
+            break;
+        }
+        status = dijkstra_apsp_efficiency(graph, threads, &sssp, global_efficiency, &local_timings);
+        if (status == 0 && path != NULL && rank == 0)
+        {
+            // um Dijkstra a mais, só da origem do caminho
+            VecDouble source_distances;
+            VecUInt32 parents;
+            VecDouble_init(&source_distances);
+            VecUInt32_init(&parents);
+            status = dijkstra_paths(graph, options->path_from, &source_distances, &parents) != 0 ||
+                     path_from_parents(&parents, options->path_from, options->path_to, path) != 0;
+            VecDouble_free(&source_distances);
+            VecUInt32_free(&parents);
+        }
+        break;
+    }
+    case ENGINE_FW_THREADS:
+        // memória compartilhada: apenas o processo 0 calcula
+        if (rank == 0)
+        {
+            output = &distances;
+            if (path == NULL)
+            {
+                status = floyd_warshall_threaded(graph, &distances, threads);
+                break;
+            }
+            MatrixUInt32 next;
+            status = floyd_warshall_paths(graph, &distances, &next, threads) != 0 ||
+                     path_from_next(&next, options->path_from, options->path_to, path) != 0;
+            MatrixUInt32_free(&next);
+        }
+        break;
+    case ENGINE_FW_BLOCKED:
+        // versão sequencial: apenas o processo 0 calcula
+        if (rank == 0)
+        {
+            output = &distances;
+            status = floyd_warshall_blocked(graph, &distances, options->tile_size);
+        }
+        break;
+    case ENGINE_FW_OUT_OF_CORE:
+        // como o fw-blocked só o processo 0 calcula, mas com a matriz no arquivo de tiles;
+        // a eficiência é somada pelo próprio engine
+        output = NULL;
+        if (rank == 0)
+        {
+            OutOfCoreOptions out_of_core = options->out_of_core;
+            out_of_core.tile_size = options->tile_size;
+            OutOfCoreStats stats;
+            status = floyd_warshall_out_of_core(graph, &out_of_core, global_efficiency, &stats);
+            if (status == 0 && !options->benchmark)
+            {
+                fprintf(stderr,
+                        "fw-ooc: tiles de %zu, cache de %zu tiles, %zu lidos, %zu gravados, %zu acertos no "
+                        "cache, espera pela E/S %.6f s\n",
+                        stats.tile_size, stats.cache_tiles, stats.tiles_read, stats.tiles_written,
+                        stats.cache_hits, stats.io_wait_time);
+            }
+        }
+        break;
+    case ENGINE_FW_2D:
+        status = output != NULL
+                     ? floyd_warshall_openmpi_2d(graph, output, options->tile_size, &local_timings)
+                     : floyd_warshall_openmpi_2d_efficiency(graph, efficiency_output, options->tile_size,
+                                                            &local_timings);
+        break;
+    case ENGINE_FW_PIPELINED:
+    case ENGINE_FW_1D:
+    {
+        if (path != NULL)
+        {
+            output = NULL;
+            status = fw_1d_paths_efficiency(options, threads, graph, global_efficiency, path);
+            break;
+        }
+        FloydWarshallOptions fw_options;
+        FloydWarshallOptions_init(&fw_options);
+        fw_options.partition = options->partition;
+        fw_options.pipelined = options->engine == ENGINE_FW_PIPELINED;
+        fw_options.threads = *threads;
+        fw_options.checkpoint = options->checkpoint;
+        if (options->tile_size != 0)
+        {
+            fw_options.block_size = options->tile_size;
+        }
+        status = floyd_warshall_openmpi_with_options(graph, &fw_options, output,
+                                                     efficiency_output, &local_timings);
+        if (status == 0 && fw_options.pipelined && !options->benchmark)
+        {
+            print_rank_timings(&local_timings);
+        }
+        break;
+    }
+    }
+
+    if (status != 0)
+    {
+        fprintf(stderr, "Erro executando o cálculo das distâncias no processo %d\n", rank);
+    }
+    else if (rank == 0 && output != NULL)
+    {
+        double const reduce_start = MPI_Wtime();
+        *global_efficiency = efficiency_from_matrix(&distances);
+        local_timings.reduce_time += MPI_Wtime() - reduce_start;
+    }
+    if (timings != NULL)
+    {
+        *timings = local_timings;
+    }
+    if (status == 0 && distances_out != NULL)
+    {
+        *distances_out = distances;
+        return status;
+    }
+    MatrixDouble_free(&distances);
+    return status;
+}
+
+// engines Floyd-Warshall com a matriz de distâncias em float; a eficiência é sempre
+// reduzida sem reunir a matriz
+static int compute_global_efficiency_float(CliOptions const *options, ThreadConfig const *threads,
+                                           Graph const *graph, double *global_efficiency, RankTimings *timings)
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    int status = 0;
+    RankTimings local_timings = {0.0, 0.0, 0.0, 0.0};
+    MatrixFloat distances;
+    MatrixFloat_init(&distances, 0, 0);
+
+    switch (options->engine)
+    {
+    case ENGINE_FW_THREADS:
+        if (rank == 0)
+        {
+            status = floyd_warshall_threaded_float(graph, &distances, threads);
+        }
+        break;
+    case ENGINE_FW_BLOCKED:
+        if (rank == 0)
+        {
+            status = floyd_warshall_blocked_float(graph, &distances, options->tile_size);
+        }
+        break;
+    case ENGINE_FW_1D:
+    {
+        FloydWarshallOptions fw_options;
+        FloydWarshallOptions_init(&fw_options);
+        fw_options.partition = options->partition;
+        fw_options.threads = *threads;
+        if (options->tile_size != 0)
+        {
+            fw_options.block_size = options->tile_size;
+        }
+        status = floyd_warshall_openmpi_float_efficiency(graph, &fw_options, global_efficiency, &local_timings);
+        break;
+    }
+    default:
+        if (rank == 0)
+        {
+            fprintf(stderr, "Erro: apenas os engines fw-1d, fw-threads e fw-blocked têm variante em float\n");
+        }
+        status = 1;
+        break;
+    }
+
+    if (status != 0)
+    {
+        fprintf(stderr, "Erro executando o cálculo das distâncias em float no processo %d\n", rank);
+    }
+    else if (rank == 0 && distances.data != NULL)
+    {
+        double const reduce_start = MPI_Wtime();
+        *global_efficiency = efficiency_from_matrix_float(&distances);
+        local_timings.reduce_time += MPI_Wtime() - reduce_start;
+    }
+    if (timings != NULL)
+    {
+        *timings = local_timings;
+    }
+    MatrixFloat_free(&distances);
+    return status;
+}
+
+// main_cli convert <edgelist> <saída>: grava o grafo no formato binário
+static int convert_to_binary(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        fprintf(stderr, "uso: %s convert <grafo edgelist> <arquivo binário>\n", argv[0]);
+        return 1;
+    }
+    ThreadConfig threads;
+    ThreadConfig_from_env(&threads, THREADS_C11);
     Graph graph;
     Graph_init(&graph);
-    struct timespec start_time;
-    if (rank == 0)
+    AdjacencyOptions adjacency;
+    AdjacencyOptions_init(&adjacency);
+    adjacency.free_edge_list = 1;
+    adjacency.threads = threads;
+    int status = Graph_create_edgelist_threaded(&graph, argv[2], &threads);
+    if (status == 0)
     {
-        timespec_get(&start_time, TIME_UTC);
-        if (argc != 2)
+        status = Graph_create_adjacency_list_with_options(&graph, &adjacency);
+    }
+    if (status == 0)
+    {
+        status = Graph_write_binary(&graph, argv[3]);
+    }
+    Graph_destroy(&graph);
+    return status;
+}
+
+// a mesma partição das linhas usada por floyd_warshall_openmpi_with_options
+static void fw_row_partition(CliOptions const *options, size_t V, int nprocs, RowPartition *rows)
+{
+    RowPartition_init(rows, options->partition, V, nprocs,
+                      options->tile_size != 0 ? options->tile_size : FLOYD_WARSHALL_DEFAULT_TILE_SIZE);
+}
+
+static int build_adjacency_list(CliOptions const *options, Graph *graph, PhaseTimes *phases)
+{
+    double const start = MPI_Wtime();
+    AdjacencyOptions adjacency;
+    AdjacencyOptions_init(&adjacency);
+    thread_config_from_options(options, options->backend == BACKEND_C11 ? THREADS_C11 : THREADS_OPENMP,
+                               &adjacency.threads);
+#ifndef COMPARE_WITH_IGRAPH
+    // o Dijkstra só usa o CSR; a comparação com o igraph ainda precisa da edgelist
+    adjacency.free_edge_list = 1;
+#endif
+    int const status = Graph_create_adjacency_list_with_options(graph, &adjacency);
+    phases->seconds[PHASE_CSR] += MPI_Wtime() - start;
+    return status;
+}
+
+// Grafo em texto lido pelo processo 0: cada processo recebe apenas o que o engine usa.
+// O Dijkstra precisa do grafo inteiro, que é replicado já em CSR; os engines 1D e 2D
+// recebem via MPI_Scatterv só as arestas dos seus elementos da matriz; fw-threads,
+// fw-blocked e fw-ooc calculam apenas no processo 0.
+static int distribute_graph(CliOptions *options, Graph *graph, int rank, int nprocs, PhaseTimes *phases)
+{
+    uint64_t sizes[2] = {graph->V, graph->E};
+    MPI_Bcast(sizes, 2, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    graph->V = sizes[0];
+    graph->E = sizes[1];
+    resolve_auto_engine(options, graph->V, graph->E);
+
+#ifdef COMPARE_WITH_IGRAPH
+    (void)nprocs;
+    // a comparação com o igraph usa a edgelist completa: ela é replicada em todos
+    if (rank != 0 && VecEdge_resize(&graph->edge_list, graph->E) != 0)
+    {
+        fprintf(stderr, "Falha na alocação da edge list no processo %d\n", rank);
+        return 1;
+    }
+    MPI_Bcast(graph->edge_list.data, graph->E * sizeof(Edge), MPI_BYTE, 0, MPI_COMM_WORLD);
+    return options->engine == ENGINE_DIJKSTRA ? build_adjacency_list(options, graph, phases) : 0;
+#else
+    switch (options->engine)
+    {
+    case ENGINE_DIJKSTRA:
+    {
+        int status = rank == 0 ? build_adjacency_list(options, graph, phases) : 0;
+        MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        return status != 0 || Graph_broadcast_adjacency(graph, 0, MPI_COMM_WORLD) != 0;
+    }
+    case ENGINE_FW_1D:
+    case ENGINE_FW_PIPELINED:
+    {
+        RowPartition rows;
+        fw_row_partition(options, graph->V, nprocs, &rows);
+        return Graph_scatter_edges(graph, Graph_edge_row_owner, &rows, 0, MPI_COMM_WORLD);
+    }
+    case ENGINE_FW_2D:
+    {
+        GridPartition grid;
+        floyd_warshall_2d_grid(graph->V, options->tile_size, nprocs, &grid);
+        return Graph_scatter_edges(graph, Graph_edge_grid_owner, &grid, 0, MPI_COMM_WORLD);
+    }
+    default:
+        return 0;
+    }
+#endif
+}
+
+// Grafo no formato binário: nenhum processo depende do processo 0. Os engines 1D leem
+// com MPI-IO apenas as arestas das suas linhas; os demais mapeiam o arquivo inteiro.
+static int load_binary_graph(CliOptions *options, Graph *graph, int rank, int nprocs, PhaseTimes *phases,
+                             size_t *num_edges)
+{
+    size_t V;
+    if (Graph_read_binary_header(options->graph_file, &V, num_edges) != 0)
+    {
+        return 1;
+    }
+    resolve_auto_engine(options, V, *num_edges);
+#ifdef COMPARE_WITH_IGRAPH
+    (void)rank;
+    (void)nprocs;
+#else
+    // a comparação com o igraph precisa de todas as arestas no processo 0
+    if (options->engine == ENGINE_FW_1D || options->engine == ENGINE_FW_PIPELINED)
+    {
+        RowPartition rows;
+        fw_row_partition(options, V, nprocs, &rows);
+        return Graph_read_binary_rows(graph, options->graph_file, &rows, rank, MPI_COMM_WORLD);
+    }
+#endif
+    if (Graph_map_binary(graph, options->graph_file) != 0)
+    {
+        return 1;
+    }
+#ifndef COMPARE_WITH_IGRAPH
+    if (options->engine == ENGINE_DIJKSTRA)
+    {
+        return 0;
+    }
+#endif
+    double const start = MPI_Wtime();
+    int const status = Graph_create_edgelist_from_adjacency(graph);
+    phases->seconds[PHASE_CSR] += MPI_Wtime() - start;
+    return status;
+}
+
+// Lê (ou gera) o grafo e o distribui como o engine precisa, separando em phases os tempos
+// de leitura, construção do CSR e distribuição deste processo; num_edges recebe no
+// processo 0 o número total de arestas. Erros encerram todos os processos.
+static void load_graph(CliOptions *options, Graph *graph, int rank, int nprocs, PhaseTimes *phases,
+                       size_t *num_edges)
+{
+    double const load_start = MPI_Wtime();
+    int const binary = !options->generated && Graph_is_binary_file(options->graph_file);
+    if (binary)
+    {
+        // com MPI-IO a leitura já é a distribuição
+        double const csr_before = phases->seconds[PHASE_CSR];
+        if (load_binary_graph(options, graph, rank, nprocs, phases, num_edges) != 0)
         {
-            fprintf(stderr, "Erro: um arquivo de um grafo no formato "
-                            "de edgelist deve ser fornecido \n");
+            fprintf(stderr, "Erro lendo o arquivo binário no processo %d\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        phases->seconds[PHASE_LOAD] += MPI_Wtime() - load_start - (phases->seconds[PHASE_CSR] - csr_before);
+        return;
+    }
+    if (rank == 0 && options->generated)
+    {
+        if (Graph_generate(graph, &options->generator) != 0)
+        {
+            fprintf(stderr, "Erro gerando o grafo sintético \n");
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
-        if (Graph_create_edgelist(&graph, argv[1]) != 0)
+    }
+    else if (rank == 0)
+    {
+        ThreadConfig load_threads;
+        thread_config_from_options(options, options->backend == BACKEND_C11 ? THREADS_C11 : THREADS_OPENMP,
+                                   &load_threads);
+        if (Graph_create_edgelist_threaded(graph, options->graph_file, &load_threads) != 0)
         {
             fprintf(stderr, "Erro lendo o arquivo edgelist \n");
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
     }
+    *num_edges = graph->E;
+    double const distribute_start = MPI_Wtime();
+    phases->seconds[PHASE_LOAD] += distribute_start - load_start;
+
+    double const csr_before = phases->seconds[PHASE_CSR];
+    if (distribute_graph(options, graph, rank, nprocs, phases) != 0)
+    {
+        fprintf(stderr, "Erro distribuindo o grafo no processo %d\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    phases->seconds[PHASE_DISTRIBUTE] += MPI_Wtime() - distribute_start - (phases->seconds[PHASE_CSR] - csr_before);
+}
 
-    MPI_Bcast(&graph.V, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
-    MPI_Bcast(&graph.E, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+// separa o tempo total do cálculo nas fases de cálculo, reunião e redução
+static void record_compute_phases(PhaseTimes *phases, double elapsed, RankTimings const *timings)
+{
+    phases->seconds[PHASE_COMPUTE] += elapsed - timings->gather_time - timings->reduce_time;
+    phases->seconds[PHASE_WAIT] += timings->wait_time;
+    phases->seconds[PHASE_GATHER] += timings->gather_time;
+    phases->seconds[PHASE_REDUCE] += timings->reduce_time;
+}
 
-    if (rank != 0)
+// main_cli bench: warmup + repetitions execuções do pipeline inteiro, cada uma com o
+// grafo lido (ou gerado) de novo; o processo 0 grava os tempos de todos os processos
+static void run_benchmark(CliOptions *options, int rank, int nprocs)
+{
+    BenchmarkReport report;
+    if (BenchmarkReport_init(&report, options->bench.repetitions, MPI_COMM_WORLD) != 0)
+    {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    ThreadConfig threads;
+    thread_config_from_options(options, options->backend == BACKEND_C11 ? THREADS_C11 : THREADS_OPENMP,
+                               &threads);
+    Engine const requested_engine = options->engine;
+    BenchmarkInfo info = {.graph = options->generated ? GeneratorKind_name(options->generator.kind)
+                                                      : options->graph_file,
+                          .seed = options->generated ? options->generator.seed : 0,
+                          .backend = threads.backend == THREADS_C11 ? "c11" : "openmp",
+                          .num_threads = threads.num_threads,
+                          .nprocs = nprocs};
+    for (size_t r = 0; r < options->bench.warmup + options->bench.repetitions; r++)
     {
-        if (VecEdge_reserve(&graph.edge_list, graph.E) != 0)
+        // o engine automático é resolvido de novo (com o mesmo resultado) a cada leitura
+        options->engine = requested_engine;
+        Graph graph;
+        Graph_init(&graph);
+        PhaseTimes phases;
+        PhaseTimes_init(&phases);
+        MPI_Barrier(MPI_COMM_WORLD);
+        load_graph(options, &graph, rank, nprocs, &phases, &info.E);
+        info.V = graph.V;
+
+        double efficiency = 0.0;
+        RankTimings timings;
+        double const start = MPI_Wtime();
+        int const status = options->precision == PRECISION_FLOAT
+                               ? compute_global_efficiency_float(options, &threads, &graph, &efficiency, &timings)
+                               : compute_global_efficiency(options, &threads, &graph, &efficiency, NULL, NULL, NULL,
+                                                           &timings);
+        if (status != 0)
         {
-            fprintf(stderr, "Falha na alocação da edge list no processo %d\n", rank);
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
-        VecEdge_resize(&graph.edge_list, graph.E);
+        record_compute_phases(&phases, MPI_Wtime() - start, &timings);
+        Graph_destroy(&graph);
+        if (r >= options->bench.warmup)
+        {
+            BenchmarkReport_record(&report, &phases, efficiency, MPI_COMM_WORLD);
+        }
+    }
+    info.engine = ENGINE_NAMES[options->engine];
+    if (rank == 0 && BenchmarkReport_write(&report, &info, &options->bench) != 0)
+    {
+        MPI_Abort(MPI_COMM_WORLD, 1);
     }
+    BenchmarkReport_free(&report);
+}
 
-    MPI_Bcast(graph.edge_list.data, graph.E * sizeof(Edge), MPI_BYTE, 0, MPI_COMM_WORLD);
+int main(int argc, char **argv)
+{
+    // apenas a thread principal faz chamadas MPI
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int nprocs;
+    int rank;
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-    MatrixDouble distances;
-    MatrixDouble_init(&distances, 0,0);
+    if (argc > 1 && strcmp(argv[1], "convert") == 0)
+    {
+        int const status = rank == 0 ? convert_to_binary(argc, argv) : 0;
+        MPI_Finalize();
+        return status;
+    }
+    
+    // main_cli bench <grafo | --generator=...> [opções]
+    int const benchmark = argc > 1 && strcmp(argv[1], "bench") == 0;
+    CliOptions options;
+    int const invalid_options = parse_options(argc - benchmark, argv + benchmark, benchmark, &options);
+    Graph graph;
+    Graph_init(&graph);
+    struct timespec start_time;
+    if (rank == 0)
+    {
+        timespec_get(&start_time, TIME_UTC);
+        if (invalid_options)
+        {
+            fprintf(stderr, "Erro: um arquivo de um grafo no formato "
+                            "de edgelist deve ser fornecido \n"
+                            "uso: %s <grafo> "
+                            "[--engine=auto|dijkstra|fw-1d|fw-2d|fw-pipelined|fw-threads|fw-blocked|fw-ooc] "
+                            "[--tile-size=N] [--gather|--no-gather] "
+                            "[--partition=block|cyclic|block-cyclic] [--threads=N] "
+                            "[--threads-backend=c11|openmp|compare] "
+                            "[--schedule=static|dynamic|work-stealing|work-stealing-mpi] [--pin=none|compact|scatter] "
+                            "[--queue=binary|4-ary|8-ary|lazy] "
+                            "[--sssp=dijkstra|radix-heap|delta-stepping] [--delta=D] "
+                            "[--precision=double|float|compare] "
+                            "[--sample=K] [--target-error=E] [--sample-strategy=uniform|degree] "
+                            "[--strata=H] [--confidence=C] [--seed=N] [--updates=FILE] "
+                            "[--checkpoint=FILE] [--checkpoint-every=N] [--checkpoint-seconds=S] [--resume] "
+                            "[--ooc-file=FILE] [--ooc-memory=MB] [--ooc-prefetch=N] "
+                            "[--path=ORIGEM,DESTINO]\n"
+                            "     %s convert <grafo> <arquivo binário>\n"
+                            "     %s bench [<grafo> | --generator=er|rmat|grid --vertices=V [--edges=E] "
+                            "[--max-weight=W] [--seed=N]] [--warmup=N] [--repetitions=N] "
+                            "[--output=ARQUIVO] [--format=json|csv] [opções do cálculo]\n",
+                            argv[0], argv[0], argv[0]);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    if (invalid_options)
+    {
+        // o processo 0 já imprimiu o uso e encerra todos os processos
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+    if (options.pinning != PIN_NONE)
+    {
+        // antes de qualquer thread: as threads dos engines herdam as CPUs do processo
+        pin_ranks(MPI_COMM_WORLD);
+    }
+    if (benchmark)
+    {
+        run_benchmark(&options, rank, nprocs);
+        PROFILE_REPORT(MPI_COMM_WORLD);
+        MPI_Finalize();
+        return 0;
+    }
+    PhaseTimes phases;
+    PhaseTimes_init(&phases);
+    size_t num_edges;
+    load_graph(&options, &graph, rank, nprocs, &phases, &num_edges);
 
-    if (floyd_warshall_openmpi(&graph, &distances) != 0)
+    struct timespec compute_start_time;
+    timespec_get(&compute_start_time, TIME_UTC);
+    ThreadConfig threads;
+    thread_config_from_options(&options, options.backend == BACKEND_C11 ? THREADS_C11 : THREADS_OPENMP,
+                               &threads);
+    double global_efficiency = 0.0;
+    EfficiencyEstimate estimate;
+    MatrixDouble distances;
+    MatrixDouble_init(&distances, 0, 0);
+    VecSizeT path;
+    VecSizeT_init(&path);
+    int const status = options.precision == PRECISION_FLOAT
+                           ? compute_global_efficiency_float(&options, &threads, &graph, &global_efficiency, NULL)
+                           : compute_global_efficiency(&options, &threads, &graph, &global_efficiency, &estimate,
+                                                       options.updates_file != NULL ? &distances : NULL,
+                                                       options.path_requested ? &path : NULL, NULL);
+    if (status != 0)
     {
-        fprintf(stderr, "Erro executando Floyd-Warshall paralelo no processo %d\n", rank);
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
     if (rank == 0)
     {
-        double global_efficiency = 0.0;
-        for (size_t i = 0; i < graph.V; i++)
-        {
-            for (size_t j = 0; j < graph.V; j++)
-            {
-                if (i != j)
-                {
-                    double dist = MatrixDouble_get(&distances, i, j);
-                    if (!isinf(dist) && dist != 0.0)
-                    {
-                        global_efficiency += 1.0 / dist;
-                    }
-                }
-            }
-        }
-        global_efficiency /= (graph.V * (graph.V - 1));
         printf("Efficiency: %.8f \n", global_efficiency);
         
         struct timespec end_time;
         timespec_get(&end_time, TIME_UTC);
         printf("MyCode(time): %.8f s \n", (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+        if (options.sampled)
+        {
+            printf("Confidence interval (%.0f%%): [%.8f, %.8f] \n", 100.0 * options.sampling.confidence,
+                   estimate.efficiency - estimate.half_width, estimate.efficiency + estimate.half_width);
+            printf("Sampled sources: %zu of %zu \n", estimate.num_sources, graph.V);
+        }
+        if (options.path_requested)
+        {
+            printf("Path %zu -> %zu:", options.path_from, options.path_to);
+            for (size_t i = 0; i < path.size; i++)
+            {
+                printf(" %zu", path.data[i]);
+            }
+            printf(path.size == 0 ? " unreachable \n" : " \n");
+        }
+    }
+
+    if (options.backend == BACKEND_COMPARE)
+    {
+        // o tempo de leitura e distribuição do grafo é contado nos dois backends
+        struct timespec c11_start_time;
+        timespec_get(&c11_start_time, TIME_UTC);
+        thread_config_from_options(&options, THREADS_C11, &threads);
+        double c11_efficiency = 0.0;
+        if (compute_global_efficiency(&options, &threads, &graph, &c11_efficiency, NULL, NULL, NULL, NULL) != 0)
+        {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        struct timespec c11_end_time;
+        timespec_get(&c11_end_time, TIME_UTC);
+        if (rank == 0)
+        {
+            if (fabs(c11_efficiency - global_efficiency) > 1e-9 * fabs(global_efficiency))
+            {
+                fprintf(stderr, "Erro: a eficiência com threads C11 (%.8f) difere da obtida com OpenMP (%.8f)\n",
+                        c11_efficiency, global_efficiency);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            printf("C11 threads(time): %.8f s \n",
+                   (compute_start_time.tv_sec - start_time.tv_sec) + (compute_start_time.tv_nsec - start_time.tv_nsec) / 1e9 +
+                       (c11_end_time.tv_sec - c11_start_time.tv_sec) + (c11_end_time.tv_nsec - c11_start_time.tv_nsec) / 1e9);
+        }
+    }
+
+    if (options.precision == PRECISION_COMPARE)
+    {
+        struct timespec float_start_time;
+        timespec_get(&float_start_time, TIME_UTC);
+        double float_efficiency = 0.0;
+        if (compute_global_efficiency_float(&options, &threads, &graph, &float_efficiency, NULL) != 0)
+        {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        struct timespec float_end_time;
+        timespec_get(&float_end_time, TIME_UTC);
+        if (rank == 0)
+        {
+            double const relative_error = global_efficiency != 0.0
+                                              ? fabs(float_efficiency - global_efficiency) / fabs(global_efficiency)
+                                              : fabs(float_efficiency);
+            printf("Float(time): %.8f s \n",
+                   (compute_start_time.tv_sec - start_time.tv_sec) + (compute_start_time.tv_nsec - start_time.tv_nsec) / 1e9 +
+                       (float_end_time.tv_sec - float_start_time.tv_sec) + (float_end_time.tv_nsec - float_start_time.tv_nsec) / 1e9);
+            printf("Float(relative error): %.3e \n", relative_error);
+            if (relative_error > FLOAT_EFFICIENCY_TOLERANCE)
+            {
+                fprintf(stderr, "Erro: a eficiência em float (%.8f) difere da obtida em double (%.8f)\n",
+                        float_efficiency, global_efficiency);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+    }
+
+    if (options.updates_file != NULL && rank == 0)
+    {
+        // a partir daqui a eficiência (e a do igraph, se comparada) é a do grafo atualizado
+        struct timespec update_start_time;
+        timespec_get(&update_start_time, TIME_UTC);
+        VecEdge updates;
+        VecEdge_init(&updates);
+        EfficiencySum efficiency_sum;
+        EfficiencySum_init(&efficiency_sum);
+        for (size_t i = 0; i < distances.nrows; i++)
+        {
+            EfficiencySum_add_row(&efficiency_sum, distances.data + i * distances.ncols, distances.ncols, i);
+        }
+        if (Graph_read_edge_updates(options.updates_file, graph.V, &updates) != 0 ||
+            floyd_warshall_update(&graph, &distances, updates.data, updates.size, &threads, &efficiency_sum) != 0)
+        {
+            fprintf(stderr, "Erro aplicando as atualizações de '%s'\n", options.updates_file);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        global_efficiency = graph.V > 1 ? EfficiencySum_value(&efficiency_sum) / ((double)graph.V * (double)(graph.V - 1))
+                                        : 0.0;
+        struct timespec update_end_time;
+        timespec_get(&update_end_time, TIME_UTC);
+        printf("Updated efficiency: %.8f \n", global_efficiency);
+        printf("Update(time): %.8f s \n", (update_end_time.tv_sec - update_start_time.tv_sec) +
+                                               (update_end_time.tv_nsec - update_start_time.tv_nsec) / 1e9);
+        VecEdge_free(&updates);
+    }
+    MatrixDouble_free(&distances);
+    VecSizeT_free(&path);
+
+    if (rank == 0)
+    {
 
 #ifdef COMPARE_WITH_IGRAPH
         igraph_t ig_graph;
@@ -120,16 +1535,16 @@ int main(int argc, char **argv)
         igraph_vector_destroy(&weights);
         igraph_destroy(&ig_graph);
 #endif
-        char *output_file_name = malloc(strlen(argv[1]) + strlen(".eff") + 1);
-        strcpy(output_file_name, argv[1]);
+        char *output_file_name = malloc(strlen(options.graph_file) + strlen(".eff") + 1);
+        strcpy(output_file_name, options.graph_file);
         strcat(output_file_name, ".eff");
         FILE *output_file = fopen(output_file_name, "w");
         fprintf(output_file, "%.8f", global_efficiency);
         fclose(output_file);
         free(output_file_name);
     }
-    MatrixDouble_free(&distances);
     Graph_destroy(&graph);
+    PROFILE_REPORT(MPI_COMM_WORLD);
     MPI_Finalize();
     return 0;
 }
\ No newline at end of file
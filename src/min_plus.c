@@ -0,0 +1,156 @@
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+#include "min_plus.h"
+
+void min_plus_row(double *dst, double const *src, double dik, size_t n)
+{
+    if (isinf(dik)) // nenhuma distância pode melhorar passando por k
+    {
+        return;
+    }
+    size_t j = 0;
+#if defined(__AVX512F__)
+    __m512d const vdik = _mm512_set1_pd(dik);
+    for (; j + 8 <= n; j += 8)
+    {
+        __m512d const candidate = _mm512_add_pd(vdik, _mm512_loadu_pd(src + j));
+        _mm512_storeu_pd(dst + j, _mm512_min_pd(_mm512_loadu_pd(dst + j), candidate));
+    }
+#elif defined(__AVX__)
+    __m256d const vdik = _mm256_set1_pd(dik);
+    for (; j + 4 <= n; j += 4)
+    {
+        __m256d const candidate = _mm256_add_pd(vdik, _mm256_loadu_pd(src + j));
+        _mm256_storeu_pd(dst + j, _mm256_min_pd(_mm256_loadu_pd(dst + j), candidate));
+    }
+#endif
+    for (; j < n; j++)
+    {
+        double const candidate = dik + src[j];
+        dst[j] = candidate < dst[j] ? candidate : dst[j];
+    }
+}
+
+void min_plus_row_next(double *dst, uint32_t *dst_next, double const *src, double dik, uint32_t next_ik,
+                       size_t n)
+{
+    if (isinf(dik))
+    {
+        return;
+    }
+    size_t j = 0;
+#if defined(__AVX512F__)
+    __m512d const vdik = _mm512_set1_pd(dik);
+    __m512i const vnext = _mm512_set1_epi32((int)next_ik);
+    for (; j + 8 <= n; j += 8)
+    {
+        __m512d const candidate = _mm512_add_pd(vdik, _mm512_loadu_pd(src + j));
+        __mmask8 const improved = _mm512_cmp_pd_mask(candidate, _mm512_loadu_pd(dst + j), _CMP_LT_OQ);
+        _mm512_mask_storeu_pd(dst + j, improved, candidate);
+        // só as 8 primeiras das 16 posições de 32 bits podem estar na máscara
+        _mm512_mask_storeu_epi32(dst_next + j, (__mmask16)improved, vnext);
+    }
+#elif defined(__AVX__)
+    __m256d const vdik = _mm256_set1_pd(dik);
+    for (; j + 4 <= n; j += 4)
+    {
+        __m256d const current = _mm256_loadu_pd(dst + j);
+        __m256d const candidate = _mm256_add_pd(vdik, _mm256_loadu_pd(src + j));
+        int const improved = _mm256_movemask_pd(_mm256_cmp_pd(candidate, current, _CMP_LT_OQ));
+        if (improved != 0)
+        {
+            _mm256_storeu_pd(dst + j, _mm256_min_pd(current, candidate));
+            for (int lane = 0; lane < 4; lane++)
+            {
+                if (improved & (1 << lane))
+                {
+                    dst_next[j + (size_t)lane] = next_ik;
+                }
+            }
+        }
+    }
+#endif
+    for (; j < n; j++)
+    {
+        double const candidate = dik + src[j];
+        if (candidate < dst[j])
+        {
+            dst[j] = candidate;
+            dst_next[j] = next_ik;
+        }
+    }
+}
+
+void min_plus_row_float(float *dst, float const *src, float dik, size_t n)
+{
+    if (isinf(dik))
+    {
+        return;
+    }
+    size_t j = 0;
+#if defined(__AVX512F__)
+    __m512 const vdik = _mm512_set1_ps(dik);
+    for (; j + 16 <= n; j += 16)
+    {
+        __m512 const candidate = _mm512_add_ps(vdik, _mm512_loadu_ps(src + j));
+        _mm512_storeu_ps(dst + j, _mm512_min_ps(_mm512_loadu_ps(dst + j), candidate));
+    }
+#elif defined(__AVX__)
+    __m256 const vdik = _mm256_set1_ps(dik);
+    for (; j + 8 <= n; j += 8)
+    {
+        __m256 const candidate = _mm256_add_ps(vdik, _mm256_loadu_ps(src + j));
+        _mm256_storeu_ps(dst + j, _mm256_min_ps(_mm256_loadu_ps(dst + j), candidate));
+    }
+#endif
+    for (; j < n; j++)
+    {
+        float const candidate = dik + src[j];
+        dst[j] = candidate < dst[j] ? candidate : dst[j];
+    }
+}
+
+// os laços em blocos são os mesmos para as duas precisões; só o kernel de linha muda
+#define IMPLEMENT_MIN_PLUS_BLOCKS(T, block, block_dependent, row)              \
+    void block(T *C, size_t ldc,                                               \
+               T const *A, size_t lda,                                         \
+               T const *B, size_t ldb,                                         \
+               size_t m, size_t n, size_t kk)                                  \
+    {                                                                          \
+        for (size_t i = 0; i < m; i++)                                         \
+        {                                                                      \
+            T *c_row = C + i * ldc;                                            \
+            T const *a_row = A + i * lda;                                      \
+            for (size_t k = 0; k < kk; k++)                                    \
+            {                                                                  \
+                row(c_row, B + k * ldb, a_row[k], n);                          \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    void block_dependent(T *C, size_t ldc,                                     \
+                         T const *A, size_t lda,                               \
+                         T const *B, size_t ldb,                               \
+                         size_t m, size_t n, size_t kk)                        \
+    {                                                                          \
+        for (size_t k = 0; k < kk; k++)                                        \
+        {                                                                      \
+            T const *b_row = B + k * ldb;                                      \
+            for (size_t i = 0; i < m; i++)                                     \
+            {                                                                  \
+                T *c_row = C + i * ldc;                                        \
+                if (c_row == b_row) /* a linha k não muda passando por ela */ \
+                {                                                              \
+                    continue;                                                  \
+                }                                                              \
+                row(c_row, b_row, A[i * lda + k], n);                          \
+            }                                                                  \
+        }                                                                      \
+    }
+
+IMPLEMENT_MIN_PLUS_BLOCKS(double, min_plus_block, min_plus_block_dependent, min_plus_row)
+IMPLEMENT_MIN_PLUS_BLOCKS(float, min_plus_block_float, min_plus_block_dependent_float, min_plus_row_float)
@@ -0,0 +1,237 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include <mpi.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "graph_library.h"
+#include "partition.h"
+#include "profiling.h"
+#include "threading.h"
+#include "work_stealing.h"
+
+// As fontes são distribuídas ciclicamente entre os processos MPI e, dentro de
+// cada processo, entre as threads segundo ThreadConfig.schedule: intervalos fixos,
+// blocos de C11_THREADS_CHUNK_SIZE fontes de um contador atômico (ou o
+// schedule(runtime) do OpenMP) ou o escalonador por roubo de trabalho. Cada
+// thread reutiliza a mesma fila de prioridade e o mesmo vetor de distâncias para todas as suas
+// fontes, e cada linha de distâncias é somada à eficiência assim que calculada.
+
+typedef struct
+{
+    VecDouble distances;
+    SsspWorkspace sssp;
+    EfficiencySum partial_sum;
+} DijkstraWorkspace;
+
+typedef struct
+{
+    Graph const *graph;
+    SsspOptions const *sssp;
+    RowPartition const *sources;
+    int rank;
+    size_t num_threads;
+    size_t chunk_size;
+    ThreadSchedule schedule;
+    atomic_size_t next_source;
+    DijkstraWorkspace *workspaces; // uma entrada por thread
+} DijkstraJob;
+
+static int __run_source(DijkstraJob *job, size_t thread_id, size_t source)
+{
+    DijkstraWorkspace *workspace = &job->workspaces[thread_id];
+    if (sssp(job->graph, source, &workspace->distances, job->sssp, &workspace->sssp) != 0)
+    {
+        return 1;
+    }
+    EfficiencySum_add_row(&workspace->partial_sum, workspace->distances.data, job->graph->V, source);
+    return 0;
+}
+
+static int __dijkstra_worker(void *arg, size_t thread_id)
+{
+    DijkstraJob *job = arg;
+    size_t const num_sources = RowPartition_count(job->sources, job->rank);
+    int status = 0;
+    if (job->schedule == SCHEDULE_STATIC)
+    {
+        size_t const begin = thread_id * num_sources / job->num_threads;
+        size_t const end = (thread_id + 1) * num_sources / job->num_threads;
+        for (size_t local = begin; local < end && status == 0; local++)
+        {
+            status = __run_source(job, thread_id, RowPartition_global_index(job->sources, job->rank, local));
+        }
+        return status;
+    }
+    for (;;)
+    {
+        size_t const begin = atomic_fetch_add(&job->next_source, job->chunk_size);
+        if (begin >= num_sources)
+        {
+            break;
+        }
+        size_t const end = begin + job->chunk_size < num_sources ? begin + job->chunk_size : num_sources;
+        for (size_t local = begin; local < end && status == 0; local++)
+        {
+            status = __run_source(job, thread_id, RowPartition_global_index(job->sources, job->rank, local));
+        }
+    }
+    return status;
+}
+
+#ifdef _OPENMP
+static int __dijkstra_openmp(DijkstraJob *job)
+{
+    size_t const num_sources = RowPartition_count(job->sources, job->rank);
+    int status = 0;
+#pragma omp parallel num_threads(job->num_threads) reduction(| : status)
+    {
+        size_t const thread_id = (size_t)omp_get_thread_num();
+#pragma omp for schedule(runtime)
+        for (size_t local = 0; local < num_sources; local++)
+        {
+            if (__run_source(job, thread_id, RowPartition_global_index(job->sources, job->rank, local)) != 0)
+            {
+                status = 1;
+            }
+        }
+    }
+    return status;
+}
+#endif
+
+static int __dijkstra_task(void *context, size_t worker, size_t source)
+{
+    return __run_source(context, worker, source);
+}
+
+static size_t __shared_source(void *context, int rank, size_t index)
+{
+    DijkstraJob const *job = context;
+    return RowPartition_global_index(job->sources, rank, index);
+}
+
+// Cada thread recebe um intervalo contíguo das fontes do processo e as ociosas roubam
+// das demais. Com SCHEDULE_WORK_STEALING_MPI só a primeira metade das fontes vai para
+// os deques; a outra metade fica na janela MPI, de onde é obtida em blocos tanto pelo
+// próprio processo quanto por processos que terminaram antes.
+static int __dijkstra_work_stealing(DijkstraJob *job, ThreadConfig const *threads)
+{
+    int const remote = job->schedule == SCHEDULE_WORK_STEALING_MPI;
+    size_t const num_sources = RowPartition_count(job->sources, job->rank);
+    size_t const num_local = remote ? (num_sources + 1) / 2 : num_sources;
+    size_t const T = job->num_threads;
+
+    WorkStealing ws;
+    if (WorkStealing_init(&ws, T, (num_local + T - 1) / T) != 0)
+    {
+        if (remote)
+        {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        return 1;
+    }
+    if (remote && WorkStealing_enable_remote(&ws, MPI_COMM_WORLD, num_local, num_sources,
+                                             job->chunk_size * T, __shared_source) != 0)
+    {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    int status = 0;
+    for (size_t local = 0; local < num_local && status == 0; local++)
+    {
+        status = WorkStealing_push(&ws, local * T / num_local,
+                                   RowPartition_global_index(job->sources, job->rank, local));
+    }
+    if (status == 0)
+    {
+        status = WorkStealing_run(&ws, threads, __dijkstra_task, job);
+    }
+    WorkStealing_free(&ws);
+    return status;
+}
+
+int dijkstra_apsp_efficiency(Graph const *graph, ThreadConfig const *threads, SsspOptions const *sssp,
+                             double *efficiency, RankTimings *timings)
+{
+    int rank, nprocs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    size_t const V = graph->V;
+    SsspOptions options = *sssp;
+    options.threads = *threads;
+    size_t const num_threads = SsspOptions_source_threads(sssp, threads);
+
+    RowPartition sources;
+    RowPartition_init(&sources, PARTITION_CYCLIC, graph->E > 0 ? V : 0, nprocs, 1);
+    DijkstraJob job = {.graph = graph, .sssp = &options, .sources = &sources, .rank = rank, .num_threads = num_threads,
+                       .chunk_size = threads->chunk_size > 0 ? threads->chunk_size : 1,
+                       .schedule = threads->schedule,
+                       .workspaces = calloc(num_threads, sizeof(DijkstraWorkspace))};
+    atomic_init(&job.next_source, 0);
+
+    int status = 0;
+    double const start = MPI_Wtime();
+    PROFILE_BEGIN(PROFILE_DIJKSTRA);
+    if (job.workspaces == NULL)
+    {
+        fprintf(stderr, "Falha na alocação das threads no processo %d\n", rank);
+        if (job.schedule == SCHEDULE_WORK_STEALING_MPI)
+        {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        status = 1;
+    }
+    else
+    {
+        for (size_t t = 0; t < num_threads; t++)
+        {
+            VecDouble_init(&job.workspaces[t].distances);
+            EfficiencySum_init(&job.workspaces[t].partial_sum);
+            SsspWorkspace_init(&job.workspaces[t].sssp, sssp);
+        }
+        if (sssp->algorithm == SSSP_DELTA_STEPPING)
+        {
+            job.schedule = SCHEDULE_STATIC;
+            status = __dijkstra_worker(&job, 0);
+        }
+        else if (job.schedule == SCHEDULE_WORK_STEALING || job.schedule == SCHEDULE_WORK_STEALING_MPI)
+        {
+            status = __dijkstra_work_stealing(&job, threads);
+        }
+#ifdef _OPENMP
+        else if (threads->backend == THREADS_OPENMP)
+        {
+            status = __dijkstra_openmp(&job);
+        }
+#endif
+        else
+        {
+            status = run_threads(threads, num_threads, __dijkstra_worker, &job);
+        }
+    }
+
+    PROFILE_END(PROFILE_DIJKSTRA);
+    double const reduce_start = MPI_Wtime();
+    EfficiencySum partial_sum;
+    EfficiencySum_init(&partial_sum);
+    for (size_t t = 0; job.workspaces != NULL && t < num_threads; t++)
+    {
+        EfficiencySum_merge(&partial_sum, &job.workspaces[t].partial_sum);
+        VecDouble_free(&job.workspaces[t].distances);
+        SsspWorkspace_free(&job.workspaces[t].sssp);
+    }
+    free(job.workspaces);
+
+    *efficiency = global_efficiency(&partial_sum, V, 0, MPI_COMM_WORLD);
+    if (timings != NULL)
+    {
+        // sem separar a espera: no roubo de trabalho via MPI ela se confunde com o cálculo
+        *timings = (RankTimings){.compute_time = reduce_start - start, .reduce_time = MPI_Wtime() - reduce_start};
+    }
+    return status;
+}
@@ -0,0 +1,349 @@
+#define _GNU_SOURCE // sched_getaffinity, sched_setaffinity e as macros CPU_*
+#include <sched.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <mpi.h>
+#include "numa_topology.h"
+
+#define NUMA_SYSFS_NODES "/sys/devices/system/node"
+
+static int __compare_ints(void const *a, void const *b)
+{
+    int const x = *(int const *)a;
+    int const y = *(int const *)b;
+    return (x > y) - (x < y);
+}
+
+// ids dos nós em ordem crescente; 0 se não há sysfs
+static size_t __sysfs_nodes(int **nodes)
+{
+    *nodes = NULL;
+    DIR *directory = opendir(NUMA_SYSFS_NODES);
+    if (directory == NULL)
+    {
+        return 0;
+    }
+    size_t count = 0;
+    size_t capacity = 0;
+    struct dirent *entry;
+    while ((entry = readdir(directory)) != NULL)
+    {
+        char *end;
+        if (strncmp(entry->d_name, "node", 4) != 0 || entry->d_name[4] == '\0')
+        {
+            continue;
+        }
+        long const id = strtol(entry->d_name + 4, &end, 10);
+        if (*end != '\0' || id < 0)
+        {
+            continue;
+        }
+        if (count == capacity)
+        {
+            capacity = capacity > 0 ? 2 * capacity : 8;
+            int *grown = realloc(*nodes, capacity * sizeof(int));
+            if (grown == NULL)
+            {
+                break;
+            }
+            *nodes = grown;
+        }
+        (*nodes)[count++] = (int)id;
+    }
+    closedir(directory);
+    qsort(*nodes, count, sizeof(int), __compare_ints);
+    return count;
+}
+
+// marca em cpus as CPUs da lista do sysfs ("0-3,8-11") que também estão em allowed
+static void __read_cpulist(int node, cpu_set_t const *allowed, cpu_set_t *cpus)
+{
+    char path[64];
+    snprintf(path, sizeof(path), NUMA_SYSFS_NODES "/node%d/cpulist", node);
+    CPU_ZERO(cpus);
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return;
+    }
+    char line[4096];
+    if (fgets(line, sizeof(line), file) != NULL)
+    {
+        char *cursor = line;
+        while (*cursor != '\0' && *cursor != '\n')
+        {
+            char *end;
+            long const first = strtol(cursor, &end, 10);
+            if (end == cursor)
+            {
+                break;
+            }
+            long last = first;
+            if (*end == '-')
+            {
+                cursor = end + 1;
+                last = strtol(cursor, &end, 10);
+            }
+            for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+            {
+                if (CPU_ISSET((int)cpu, allowed))
+                {
+                    CPU_SET((int)cpu, cpus);
+                }
+            }
+            cursor = *end == ',' ? end + 1 : end;
+        }
+    }
+    fclose(file);
+}
+
+static int __allocate(NumaTopology *topology, size_t num_nodes, size_t num_cpus)
+{
+    topology->num_nodes = 0;
+    topology->num_cpus = 0;
+    topology->allowed = NULL;
+    topology->cpus = malloc((num_cpus > 0 ? num_cpus : 1) * sizeof(int));
+    topology->node_begin = calloc(num_nodes + 1, sizeof(size_t));
+    if (topology->cpus == NULL || topology->node_begin == NULL)
+    {
+        fprintf(stderr, "Falha na alocação da topologia NUMA\n");
+        NumaTopology_free(topology);
+        return 1;
+    }
+    return 0;
+}
+
+// NUMA_EMULATED_NODES: as CPUs permitidas, em ordem, divididas em blocos consecutivos
+static int __emulate(NumaTopology *topology, cpu_set_t const *allowed, size_t num_nodes)
+{
+    int cpus[CPU_SETSIZE];
+    size_t num_allowed = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, allowed))
+        {
+            cpus[num_allowed++] = cpu;
+        }
+    }
+    if (num_allowed == 0)
+    {
+        cpus[num_allowed++] = 0;
+    }
+    size_t const num_cpus = num_allowed >= num_nodes ? num_allowed : num_nodes;
+    if (__allocate(topology, num_nodes, num_cpus) != 0)
+    {
+        return 1;
+    }
+    for (size_t n = 0; n < num_nodes; n++)
+    {
+        topology->node_begin[n] = topology->num_cpus;
+        if (num_allowed >= num_nodes)
+        {
+            for (size_t c = n * num_allowed / num_nodes; c < (n + 1) * num_allowed / num_nodes; c++)
+            {
+                topology->cpus[topology->num_cpus++] = cpus[c];
+            }
+        }
+        else
+        {
+            topology->cpus[topology->num_cpus++] = cpus[n % num_allowed];
+        }
+    }
+    topology->node_begin[num_nodes] = topology->num_cpus;
+    topology->num_nodes = num_nodes;
+    return 0;
+}
+
+// guarda a máscara da thread chamadora para NumaTopology_restore_affinity
+static int __save_allowed(NumaTopology *topology, cpu_set_t const *allowed)
+{
+    topology->allowed = malloc(sizeof(cpu_set_t));
+    if (topology->allowed == NULL)
+    {
+        fprintf(stderr, "Falha na alocação da topologia NUMA\n");
+        NumaTopology_free(topology);
+        return 1;
+    }
+    memcpy(topology->allowed, allowed, sizeof(cpu_set_t));
+    return 0;
+}
+
+int NumaTopology_detect(NumaTopology *topology)
+{
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    {
+        CPU_ZERO(&allowed);
+        CPU_SET(0, &allowed);
+    }
+    char const *emulated = getenv("NUMA_EMULATED_NODES");
+    size_t const emulated_nodes = emulated != NULL ? strtoull(emulated, NULL, 10) : 0;
+    if (emulated_nodes > 0)
+    {
+        if (__emulate(topology, &allowed, emulated_nodes) != 0)
+        {
+            return 1;
+        }
+        return __save_allowed(topology, &allowed);
+    }
+
+    int *nodes;
+    size_t const num_nodes = __sysfs_nodes(&nodes);
+    // um nó a mais para as CPUs que o sysfs não lista (ou todas, sem sysfs)
+    if (__allocate(topology, num_nodes + 1, (size_t)CPU_COUNT(&allowed)) != 0)
+    {
+        free(nodes);
+        return 1;
+    }
+    cpu_set_t assigned;
+    CPU_ZERO(&assigned);
+    for (size_t n = 0; n < num_nodes; n++)
+    {
+        cpu_set_t node_cpus;
+        __read_cpulist(nodes[n], &allowed, &node_cpus);
+        if (CPU_COUNT(&node_cpus) == 0) // nó sem CPUs do processo (ou só com memória)
+        {
+            continue;
+        }
+        topology->node_begin[topology->num_nodes++] = topology->num_cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &node_cpus) && !CPU_ISSET(cpu, &assigned))
+            {
+                CPU_SET(cpu, &assigned);
+                topology->cpus[topology->num_cpus++] = cpu;
+            }
+        }
+    }
+    free(nodes);
+    size_t const listed = topology->num_cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &allowed) && !CPU_ISSET(cpu, &assigned))
+        {
+            topology->cpus[topology->num_cpus++] = cpu;
+        }
+    }
+    if (topology->num_cpus > listed)
+    {
+        topology->node_begin[topology->num_nodes++] = listed;
+    }
+    topology->node_begin[topology->num_nodes] = topology->num_cpus;
+    return __save_allowed(topology, &allowed);
+}
+
+void NumaTopology_free(NumaTopology *topology)
+{
+    free(topology->cpus);
+    free(topology->node_begin);
+    free(topology->allowed);
+    topology->cpus = NULL;
+    topology->node_begin = NULL;
+    topology->allowed = NULL;
+    topology->num_nodes = 0;
+    topology->num_cpus = 0;
+}
+
+static size_t __node_of(NumaTopology const *topology, size_t index)
+{
+    size_t node = 0;
+    while (node + 1 < topology->num_nodes && topology->node_begin[node + 1] <= index)
+    {
+        node++;
+    }
+    return node;
+}
+
+size_t NumaTopology_thread_node(NumaTopology const *topology, ThreadPinning pinning, size_t thread_id, int *cpu)
+{
+    if (cpu != NULL)
+    {
+        *cpu = -1;
+    }
+    if (pinning == PIN_NONE || topology->num_cpus == 0)
+    {
+        return 0;
+    }
+    size_t node;
+    size_t index;
+    if (pinning == PIN_SCATTER)
+    {
+        // uma thread por nó em rodízio, depois a próxima CPU de cada nó
+        node = thread_id % topology->num_nodes;
+        size_t const node_size = topology->node_begin[node + 1] - topology->node_begin[node];
+        index = topology->node_begin[node] + (thread_id / topology->num_nodes) % node_size;
+    }
+    else
+    {
+        index = thread_id % topology->num_cpus;
+        node = __node_of(topology, index);
+    }
+    if (cpu != NULL)
+    {
+        *cpu = topology->cpus[index];
+    }
+    return node;
+}
+
+int NumaTopology_restore_affinity(NumaTopology const *topology)
+{
+    if (topology->allowed == NULL)
+    {
+        return 1;
+    }
+    return sched_setaffinity(0, sizeof(cpu_set_t), topology->allowed) != 0;
+}
+
+int pin_current_thread(int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+        return 1;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) != 0;
+}
+
+int pin_ranks(MPI_Comm comm)
+{
+    MPI_Comm local;
+    int local_rank, local_size;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &local);
+    MPI_Comm_rank(local, &local_rank);
+    MPI_Comm_size(local, &local_size);
+    MPI_Comm_free(&local);
+
+    NumaTopology topology;
+    if (NumaTopology_detect(&topology) != 0)
+    {
+        return 1;
+    }
+    size_t const C = topology.num_cpus;
+    size_t const L = (size_t)local_size;
+    size_t const r = (size_t)local_rank;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (L <= C)
+    {
+        for (size_t c = r * C / L; c < (r + 1) * C / L; c++)
+        {
+            CPU_SET(topology.cpus[c], &set);
+        }
+    }
+    else
+    {
+        CPU_SET(topology.cpus[r % C], &set);
+    }
+    NumaTopology_free(&topology);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    {
+        fprintf(stderr, "Aviso: não foi possível fixar o processo %zu da máquina nas suas CPUs\n", r);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <stddef.h>
+#include "partition.h"
+
+void RowPartition_init(RowPartition *partition, PartitionKind kind, size_t n, int nparts, size_t block_size)
+{
+    partition->kind = kind;
+    partition->n = n;
+    partition->nparts = nparts > 0 ? (size_t)nparts : 1;
+    partition->block_size = 1;
+    if (kind == PARTITION_BLOCK_CYCLIC && block_size > 0)
+    {
+        partition->block_size = block_size;
+    }
+    partition->base = n / partition->nparts;
+    partition->remainder = n % partition->nparts;
+}
+
+size_t RowPartition_block_start(RowPartition const *partition, int part)
+{
+    size_t const p = (size_t)part;
+    return p * partition->base + (p < partition->remainder ? p : partition->remainder);
+}
+
+size_t RowPartition_count(RowPartition const *partition, int part)
+{
+    size_t const p = (size_t)part;
+    if (partition->kind == PARTITION_BLOCK)
+    {
+        return partition->base + (p < partition->remainder ? 1 : 0);
+    }
+    size_t const b = partition->block_size;
+    size_t const num_blocks = (partition->n + b - 1) / b;
+    size_t const owned_blocks = num_blocks / partition->nparts +
+                                (p < num_blocks % partition->nparts ? 1 : 0);
+    size_t count = owned_blocks * b;
+    // o último bloco pode estar incompleto
+    if (owned_blocks > 0 && (num_blocks - 1) % partition->nparts == p && partition->n % b != 0)
+    {
+        count -= b - partition->n % b;
+    }
+    return count;
+}
+
+int RowPartition_owner(RowPartition const *partition, size_t row)
+{
+    if (partition->kind == PARTITION_BLOCK)
+    {
+        size_t const big_rows = partition->remainder * (partition->base + 1);
+        if (row < big_rows)
+        {
+            return (int)(row / (partition->base + 1));
+        }
+        return (int)(partition->remainder + (row - big_rows) / partition->base);
+    }
+    return (int)((row / partition->block_size) % partition->nparts);
+}
+
+size_t RowPartition_local_index(RowPartition const *partition, size_t row)
+{
+    if (partition->kind == PARTITION_BLOCK)
+    {
+        return row - RowPartition_block_start(partition, RowPartition_owner(partition, row));
+    }
+    size_t const b = partition->block_size;
+    return (row / b / partition->nparts) * b + row % b;
+}
+
+size_t RowPartition_global_index(RowPartition const *partition, int part, size_t local)
+{
+    if (partition->kind == PARTITION_BLOCK)
+    {
+        return RowPartition_block_start(partition, part) + local;
+    }
+    size_t const b = partition->block_size;
+    return ((local / b) * partition->nparts + (size_t)part) * b + local % b;
+}
+
+void GridPartition_init(GridPartition *grid, size_t n, int grid_rows, int grid_cols, size_t block_size)
+{
+    grid->grid_rows = grid_rows;
+    grid->grid_cols = grid_cols;
+    RowPartition_init(&grid->rows, PARTITION_BLOCK_CYCLIC, n, grid_rows, block_size);
+    RowPartition_init(&grid->cols, PARTITION_BLOCK_CYCLIC, n, grid_cols, block_size);
+}
+
+int GridPartition_owner(GridPartition const *grid, size_t row, size_t col)
+{
+    return RowPartition_owner(&grid->rows, row) * grid->grid_cols + RowPartition_owner(&grid->cols, col);
+}
@@ -0,0 +1,136 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include "graph_library.h"
+
+// Extração de caminhos a partir das matrizes de próximos vértices (Floyd-Warshall) e dos
+// vetores de predecessores (Dijkstra). Um caminho mínimo tem no máximo V vértices; um
+// passo a mais indica uma matriz inconsistente e é tratado como erro.
+
+IMPLEMENT_VECTOR_INTERFACE(uint32_t, VecUInt32)
+IMPLEMENT_MATRIX_INTERFACE(uint32_t, MatrixUInt32)
+
+static int __push_vertex(VecSizeT *path, size_t vertex, size_t V)
+{
+    if (path->size >= V)
+    {
+        fprintf(stderr, "Caminho com mais de %zu vértices: matriz de caminhos inconsistente\n", V);
+        return 1;
+    }
+    VecSizeT_push_back(path, vertex);
+    return 0;
+}
+
+int path_from_next(MatrixUInt32 const *next, size_t from, size_t to, VecSizeT *path)
+{
+    size_t const V = next->ncols;
+    path->size = 0;
+    if (from >= V || to >= V)
+    {
+        fprintf(stderr, "Vértice inválido no caminho de %zu até %zu\n", from, to);
+        return 1;
+    }
+    if (MatrixUInt32_get(next, from, to) == PATH_NO_VERTEX)
+    {
+        return 0;
+    }
+    size_t current = from;
+    if (__push_vertex(path, current, V) != 0)
+    {
+        return 1;
+    }
+    while (current != to)
+    {
+        current = MatrixUInt32_get(next, current, to);
+        if (current == PATH_NO_VERTEX || __push_vertex(path, current, V) != 0)
+        {
+            path->size = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int path_from_parents(VecUInt32 const *parents, size_t source, size_t to, VecSizeT *path)
+{
+    size_t const V = parents->size;
+    path->size = 0;
+    if (source >= V || to >= V)
+    {
+        fprintf(stderr, "Vértice inválido no caminho de %zu até %zu\n", source, to);
+        return 1;
+    }
+    if (parents->data[to] == PATH_NO_VERTEX)
+    {
+        return 0;
+    }
+    // do destino até a fonte, depois invertido
+    for (size_t current = to;; current = parents->data[current])
+    {
+        if (__push_vertex(path, current, V) != 0)
+        {
+            path->size = 0;
+            return 1;
+        }
+        if (current == source)
+        {
+            break;
+        }
+    }
+    for (size_t i = 0, j = path->size - 1; i < j; i++, j--)
+    {
+        size_t const vertex = path->data[i];
+        path->data[i] = path->data[j];
+        path->data[j] = vertex;
+    }
+    return 0;
+}
+
+int DistributedPaths_extract(DistributedPaths const *paths, size_t from, size_t to, VecSizeT *path,
+                             MPI_Comm comm)
+{
+    size_t const V = paths->local_next.ncols;
+    path->size = 0;
+    if (from >= V || to >= V)
+    {
+        fprintf(stderr, "Vértice inválido no caminho de %zu até %zu\n", from, to);
+        return 1;
+    }
+    // o dono da linha do vértice atual transmite o próximo passo
+    uint32_t current = (uint32_t)from;
+    for (;;)
+    {
+        int const owner = RowPartition_owner(&paths->partition, current);
+        uint32_t next = PATH_NO_VERTEX;
+        if (owner == paths->rank)
+        {
+            next = MatrixUInt32_get(&paths->local_next, RowPartition_local_index(&paths->partition, current), to);
+        }
+        MPI_Bcast(&next, 1, MPI_UINT32_T, owner, comm);
+        if (next == PATH_NO_VERTEX)
+        {
+            // só a fonte pode não ter próximo passo (destino inalcançável)
+            int const unreachable = path->size == 0;
+            path->size = 0;
+            return unreachable ? 0 : 1;
+        }
+        if (__push_vertex(path, current, V) != 0)
+        {
+            path->size = 0;
+            return 1;
+        }
+        if (current == to)
+        {
+            return 0;
+        }
+        current = next;
+    }
+}
+
+void DistributedPaths_free(DistributedPaths *paths)
+{
+    MatrixDouble_free(&paths->local_distances);
+    MatrixUInt32_free(&paths->local_next);
+}
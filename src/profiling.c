@@ -0,0 +1,349 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <mpi.h>
+#include "profiling.h"
+
+// Compilado apenas com ENABLE_PROFILING. As regiões e as chamadas MPI são registradas pela
+// thread 0 de cada processo (MPI_THREAD_FUNNELED), então só os contadores de hardware,
+// somados por todas as threads, precisam de operações atômicas.
+
+typedef enum
+{
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_LLC_MISSES,
+    COUNTER_COUNT,
+} ProfileCounter;
+
+static uint64_t const COUNTER_CONFIGS[COUNTER_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                       PERF_COUNT_HW_CACHE_MISSES};
+
+static char const *const REGION_NAMES[PROFILE_REGION_COUNT] = {"fw-relax", "fw-pipelined", "fw-blocked", "fw-2d",
+                                                               "fw-ooc", "dijkstra"};
+
+typedef enum
+{
+    CALL_BCAST,
+    CALL_IBCAST,
+    CALL_SEND,
+    CALL_RECV,
+    CALL_IRECV,
+    CALL_WAIT,
+    CALL_WAITALL,
+    CALL_GATHER,
+    CALL_GATHERV,
+    CALL_SCATTERV,
+    CALL_ALLREDUCE,
+    CALL_BARRIER,
+    TRACED_CALL_COUNT,
+} TracedCall;
+
+static char const *const TRACED_CALL_NAMES[TRACED_CALL_COUNT] = {
+    "MPI_Bcast", "MPI_Ibcast", "MPI_Send", "MPI_Recv", "MPI_Irecv", "MPI_Wait",
+    "MPI_Waitall", "MPI_Gather", "MPI_Gatherv", "MPI_Scatterv", "MPI_Allreduce", "MPI_Barrier"};
+
+static struct
+{
+    size_t calls;
+    double seconds;
+    double started;
+    atomic_uint_fast64_t counters[COUNTER_COUNT];
+    atomic_size_t counted_threads; // threads cujos contadores abriram
+} regions[PROFILE_REGION_COUNT];
+
+static struct
+{
+    size_t calls;
+    double seconds;
+    double bytes;
+} traced_calls[TRACED_CALL_COUNT];
+
+// 0: ainda não testado, 1: disponível, -1: perf_event_open falhou (paranoid, contêiner...)
+static atomic_int counters_available;
+
+void Profile_begin(ProfileRegion region)
+{
+    regions[region].started = PMPI_Wtime();
+}
+
+void Profile_end(ProfileRegion region)
+{
+    regions[region].seconds += PMPI_Wtime() - regions[region].started;
+    regions[region].calls++;
+}
+
+static int __perf_event_open(uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // com multiplexação o valor é corrigido pela fração do tempo em que o contador rodou
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+void ProfileCounters_start(ProfileCounters *counters)
+{
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        counters->fds[c] = -1;
+    }
+    if (atomic_load(&counters_available) < 0)
+    {
+        return;
+    }
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        counters->fds[c] = __perf_event_open(COUNTER_CONFIGS[c]);
+        if (counters->fds[c] < 0)
+        {
+            atomic_store(&counters_available, -1);
+            for (int open = 0; open < c; open++)
+            {
+                close(counters->fds[open]);
+                counters->fds[open] = -1;
+            }
+            return;
+        }
+    }
+    atomic_store(&counters_available, 1);
+}
+
+void ProfileCounters_stop(ProfileCounters *counters, ProfileRegion region)
+{
+    if (counters->fds[0] < 0)
+    {
+        return;
+    }
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        uint64_t values[3]; // valor, tempo habilitado, tempo rodando
+        if (read(counters->fds[c], values, sizeof(values)) == (ssize_t)sizeof(values) && values[2] > 0)
+        {
+            double const scaled = (double)values[0] * ((double)values[1] / (double)values[2]);
+            atomic_fetch_add(&regions[region].counters[c], (uint_fast64_t)scaled);
+        }
+        close(counters->fds[c]);
+        counters->fds[c] = -1;
+    }
+    atomic_fetch_add(&regions[region].counted_threads, 1);
+}
+
+static double __type_bytes(int count, MPI_Datatype datatype)
+{
+    int size;
+    PMPI_Type_size(datatype, &size);
+    return (double)count * (double)size;
+}
+
+static void __record(TracedCall call, double start, double bytes)
+{
+    traced_calls[call].calls++;
+    traced_calls[call].seconds += PMPI_Wtime() - start;
+    traced_calls[call].bytes += bytes;
+}
+
+// Wrappers PMPI: bytes é o volume de dados deste processo na chamada (enviado ou recebido)
+
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Bcast(buffer, count, datatype, root, comm);
+    __record(CALL_BCAST, start, __type_bytes(count, datatype));
+    return result;
+}
+
+int MPI_Ibcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm, MPI_Request *request)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Ibcast(buffer, count, datatype, root, comm, request);
+    __record(CALL_IBCAST, start, __type_bytes(count, datatype));
+    return result;
+}
+
+int MPI_Send(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Send(buf, count, datatype, dest, tag, comm);
+    __record(CALL_SEND, start, __type_bytes(count, datatype));
+    return result;
+}
+
+int MPI_Recv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status *status)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Recv(buf, count, datatype, source, tag, comm, status);
+    __record(CALL_RECV, start, __type_bytes(count, datatype));
+    return result;
+}
+
+int MPI_Irecv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm,
+              MPI_Request *request)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Irecv(buf, count, datatype, source, tag, comm, request);
+    __record(CALL_IRECV, start, __type_bytes(count, datatype));
+    return result;
+}
+
+int MPI_Wait(MPI_Request *request, MPI_Status *status)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Wait(request, status);
+    __record(CALL_WAIT, start, 0.0);
+    return result;
+}
+
+int MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status *array_of_statuses)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Waitall(count, array_of_requests, array_of_statuses);
+    __record(CALL_WAITALL, start, 0.0);
+    return result;
+}
+
+int MPI_Gather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+               MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+    __record(CALL_GATHER, start, __type_bytes(sendcount, sendtype));
+    return result;
+}
+
+int MPI_Gatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                const int displs[], MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Gatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm);
+    __record(CALL_GATHERV, start, __type_bytes(sendcount, sendtype));
+    return result;
+}
+
+int MPI_Scatterv(const void *sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype,
+                 void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Scatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm);
+    __record(CALL_SCATTERV, start, __type_bytes(recvcount, recvtype));
+    return result;
+}
+
+int MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+    __record(CALL_ALLREDUCE, start, __type_bytes(count, datatype));
+    return result;
+}
+
+int MPI_Barrier(MPI_Comm comm)
+{
+    double const start = PMPI_Wtime();
+    int const result = PMPI_Barrier(comm);
+    __record(CALL_BARRIER, start, 0.0);
+    return result;
+}
+
+// por região: chamadas, segundos, threads com contadores e os contadores; por chamada
+// MPI: chamadas, segundos e bytes
+#define REGION_FIELDS (3 + COUNTER_COUNT)
+#define MPI_FIELDS 3
+#define PROFILE_FIELDS (PROFILE_REGION_COUNT * REGION_FIELDS + TRACED_CALL_COUNT * MPI_FIELDS)
+
+static void __print_rank(int rank, double const *values)
+{
+    fprintf(stderr, "Perfil do processo %d:\n", rank);
+    for (int r = 0; r < PROFILE_REGION_COUNT; r++)
+    {
+        double const *region = values + r * REGION_FIELDS;
+        if (region[0] == 0.0)
+        {
+            continue;
+        }
+        fprintf(stderr, "  %-14s %8.0f chamadas %12.6f s", REGION_NAMES[r], region[0], region[1]);
+        double const cycles = region[3 + COUNTER_CYCLES];
+        double const instructions = region[3 + COUNTER_INSTRUCTIONS];
+        double const misses = region[3 + COUNTER_LLC_MISSES];
+        if (region[2] > 0.0 && cycles > 0.0)
+        {
+            // cada falta no LLC traz uma linha de 64 bytes da memória: uma estimativa por
+            // baixo da banda de DRAM (não conta prefetch nem escritas de volta)
+            fprintf(stderr, "  %.0f threads, %.3e ciclos, IPC %.2f, %.3e faltas LLC (%.2f por mil instruções, "
+                            "~%.2f GB/s)",
+                    region[2], cycles, instructions / cycles, misses,
+                    instructions > 0.0 ? 1000.0 * misses / instructions : 0.0,
+                    region[1] > 0.0 ? 64.0 * misses / region[1] / 1e9 : 0.0);
+        }
+        fprintf(stderr, "\n");
+    }
+    for (int c = 0; c < TRACED_CALL_COUNT; c++)
+    {
+        double const *call = values + PROFILE_REGION_COUNT * REGION_FIELDS + c * MPI_FIELDS;
+        if (call[0] > 0.0)
+        {
+            fprintf(stderr, "  %-14s %8.0f chamadas %12.6f s %12.3f MB\n", TRACED_CALL_NAMES[c], call[0], call[1],
+                    call[2] / 1e6);
+        }
+    }
+}
+
+void Profile_report(MPI_Comm comm)
+{
+    int rank, nprocs;
+    PMPI_Comm_rank(comm, &rank);
+    PMPI_Comm_size(comm, &nprocs);
+    double local[PROFILE_FIELDS];
+    for (int r = 0; r < PROFILE_REGION_COUNT; r++)
+    {
+        double *region = local + r * REGION_FIELDS;
+        region[0] = (double)regions[r].calls;
+        region[1] = regions[r].seconds;
+        region[2] = (double)atomic_load(&regions[r].counted_threads);
+        for (int c = 0; c < COUNTER_COUNT; c++)
+        {
+            region[3 + c] = (double)atomic_load(&regions[r].counters[c]);
+        }
+    }
+    for (int c = 0; c < TRACED_CALL_COUNT; c++)
+    {
+        double *call = local + PROFILE_REGION_COUNT * REGION_FIELDS + c * MPI_FIELDS;
+        call[0] = (double)traced_calls[c].calls;
+        call[1] = traced_calls[c].seconds;
+        call[2] = traced_calls[c].bytes;
+    }
+
+    double *all = rank == 0 ? malloc((size_t)nprocs * PROFILE_FIELDS * sizeof(double)) : NULL;
+    if (rank == 0 && all == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do resumo do perfil\n");
+        PMPI_Abort(comm, 1);
+    }
+    // PMPI_Gather: a própria coleta não entra nas estatísticas
+    PMPI_Gather(local, PROFILE_FIELDS, MPI_DOUBLE, all, PROFILE_FIELDS, MPI_DOUBLE, 0, comm);
+    if (rank != 0)
+    {
+        return;
+    }
+    if (atomic_load(&counters_available) < 0)
+    {
+        fprintf(stderr, "Aviso: perf_event_open indisponível no processo 0 (veja "
+                        "/proc/sys/kernel/perf_event_paranoid); só os tempos são reportados\n");
+    }
+    for (int p = 0; p < nprocs; p++)
+    {
+        __print_rank(p, all + (size_t)p * PROFILE_FIELDS);
+    }
+    free(all);
+}
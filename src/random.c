@@ -0,0 +1,32 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "random.h"
+
+void Random_init(Random *random, uint64_t seed)
+{
+    random->state = seed;
+}
+
+uint64_t Random_next(Random *random)
+{
+    uint64_t z = (random->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double Random_uniform(Random *random)
+{
+    return (double)(Random_next(random) >> 11) * 0x1.0p-53;
+}
+
+void Random_shuffle(Random *random, size_t *values, size_t n)
+{
+    for (size_t i = n; i > 1; i--)
+    {
+        size_t const j = (size_t)(Random_next(random) % i);
+        size_t const tmp = values[i - 1];
+        values[i - 1] = values[j];
+        values[j] = tmp;
+    }
+}
@@ -0,0 +1,320 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <mpi.h>
+#include "graph_library.h"
+#include "threading.h"
+#include "random.h"
+
+// Estimativa da eficiência global por amostragem de fontes. Todos os processos sorteiam
+// a mesma permutação de cada estrato (mesma semente), então cada lote é conhecido por
+// todos sem comunicação; cada processo resolve as fontes i ≡ rank (mod nprocs) do lote e
+// um MPI_Allreduce junta os r_s. Como todos os processos ficam com as mesmas amostras,
+// a decisão de parar no modo adaptativo é idêntica em todos.
+
+#define SAMPLING_DEFAULT_BATCH 64
+
+void SamplingOptions_init(SamplingOptions *options)
+{
+    options->kind = SAMPLING_UNIFORM;
+    options->num_sources = 0;
+    options->target_relative_error = 0.0;
+    options->confidence = 0.95;
+    options->seed = 1;
+    options->num_strata = 4;
+}
+
+typedef struct
+{
+    size_t *vertices; // permutação aleatória dos vértices do estrato
+    size_t population;
+    size_t next; // próximo vértice ainda não sorteado
+    VecDouble samples; // r_s das fontes já resolvidas
+} Stratum;
+
+typedef struct
+{
+    Graph const *graph;
+    SsspOptions const *sssp;
+    size_t const *sources; // fontes do lote
+    double *row_sums;      // r_s de cada fonte do lote
+    size_t num_sources;
+    size_t first;  // primeira fonte deste processo no lote
+    size_t stride; // número de processos
+    atomic_size_t next;
+    VecDouble *distances;      // um por thread
+    SsspWorkspace *workspaces; // um por thread
+} SampleBatch;
+
+// quantil da normal padrão para p em (0, 0.5] (Abramowitz e Stegun 26.2.23, erro < 4.5e-4)
+static double __normal_quantile_upper(double p)
+{
+    double const t = sqrt(-2.0 * log(p));
+    return t - (2.515517 + 0.802853 * t + 0.010328 * t * t) /
+                   (1.0 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+}
+
+typedef struct
+{
+    uint64_t degree;
+    size_t vertex;
+} VertexDegree;
+
+static int __compare_vertex_degree(void const *a, void const *b)
+{
+    VertexDegree const *x = a;
+    VertexDegree const *y = b;
+    if (x->degree != y->degree)
+    {
+        return (x->degree > y->degree) - (x->degree < y->degree);
+    }
+    return (x->vertex > y->vertex) - (x->vertex < y->vertex);
+}
+
+// divide os vértices em estratos e sorteia a ordem das fontes de cada um
+static int __init_strata(Graph const *graph, SamplingOptions const *options, Stratum *strata,
+                         size_t num_strata, size_t *order)
+{
+    size_t const V = graph->V;
+    for (size_t v = 0; v < V; v++)
+    {
+        order[v] = v;
+    }
+    if (options->kind == SAMPLING_DEGREE)
+    {
+        uint64_t const *offsets = graph->adjacency_list.offsets;
+        VertexDegree *degrees = malloc(V * sizeof(VertexDegree));
+        if (degrees == NULL)
+        {
+            return 1;
+        }
+        for (size_t v = 0; v < V; v++)
+        {
+            degrees[v].degree = offsets[v + 1] - offsets[v];
+            degrees[v].vertex = v;
+        }
+        qsort(degrees, V, sizeof(VertexDegree), __compare_vertex_degree);
+        for (size_t v = 0; v < V; v++)
+        {
+            order[v] = degrees[v].vertex;
+        }
+        free(degrees);
+    }
+    Random random;
+    Random_init(&random, options->seed);
+    for (size_t h = 0; h < num_strata; h++)
+    {
+        size_t const begin = h * V / num_strata;
+        size_t const end = (h + 1) * V / num_strata;
+        strata[h].vertices = order + begin;
+        strata[h].population = end - begin;
+        strata[h].next = 0;
+        VecDouble_init(&strata[h].samples);
+        if (VecDouble_reserve(&strata[h].samples, 16) != 0)
+        {
+            return 1;
+        }
+        Random_shuffle(&random, strata[h].vertices, strata[h].population);
+    }
+    return 0;
+}
+
+static int __sample_worker(void *arg, size_t thread_id)
+{
+    SampleBatch *job = arg;
+    for (;;)
+    {
+        size_t const i = job->first + atomic_fetch_add(&job->next, 1) * job->stride;
+        if (i >= job->num_sources)
+        {
+            return 0;
+        }
+        VecDouble *distances = &job->distances[thread_id];
+        if (sssp(job->graph, job->sources[i], distances, job->sssp, &job->workspaces[thread_id]) != 0)
+        {
+            return 1;
+        }
+        EfficiencySum row_sum;
+        EfficiencySum_init(&row_sum);
+        EfficiencySum_add_row(&row_sum, distances->data, job->graph->V, job->sources[i]);
+        job->row_sums[i] = EfficiencySum_value(&row_sum);
+    }
+}
+
+static int __run_sample_batch(SampleBatch *job, ThreadConfig const *threads, size_t num_threads)
+{
+    atomic_store(&job->next, 0);
+    return run_threads(threads, num_threads, __sample_worker, job);
+}
+
+// estimador estratificado: média = Σ W_h ȳ_h e var = Σ W_h² (1 - n_h/N_h) s_h² / n_h;
+// um estrato com uma só amostra (e ainda não esgotado) deixa a variância infinita
+static void __estimate(Stratum const *strata, size_t num_strata, size_t V, double z,
+                       EfficiencyEstimate *estimate)
+{
+    double mean = 0.0;
+    double variance = 0.0;
+    size_t num_sources = 0;
+    for (size_t h = 0; h < num_strata; h++)
+    {
+        size_t const n = strata[h].samples.size;
+        size_t const N = strata[h].population;
+        if (N == 0)
+        {
+            continue;
+        }
+        double const weight = (double)N / (double)V;
+        double sum = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            sum += strata[h].samples.data[i];
+        }
+        double const stratum_mean = n > 0 ? sum / (double)n : 0.0;
+        double squares = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            double const deviation = strata[h].samples.data[i] - stratum_mean;
+            squares += deviation * deviation;
+        }
+        mean += weight * stratum_mean;
+        if (n < N)
+        {
+            variance += n > 1 ? weight * weight * (1.0 - (double)n / (double)N) * squares / (double)(n - 1) / (double)n
+                              : INFINITY;
+        }
+        num_sources += n;
+    }
+    estimate->efficiency = mean / (double)(V - 1);
+    estimate->half_width = z * sqrt(variance) / (double)(V - 1);
+    estimate->num_sources = num_sources;
+}
+
+int sampled_efficiency(Graph const *graph, ThreadConfig const *threads, SsspOptions const *sssp,
+                       SamplingOptions const *sampling, EfficiencyEstimate *estimate)
+{
+    int rank, nprocs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    size_t const V = graph->V;
+    estimate->efficiency = 0.0;
+    estimate->half_width = 0.0;
+    estimate->num_sources = 0;
+    if (V < 2 || graph->E == 0)
+    {
+        return 0;
+    }
+    if (sampling->confidence <= 0.0 || sampling->confidence >= 1.0)
+    {
+        fprintf(stderr, "O nível de confiança deve estar entre 0 e 1\n");
+        return 1;
+    }
+    double const z = __normal_quantile_upper((1.0 - sampling->confidence) / 2.0);
+    int const adaptive = sampling->target_relative_error > 0.0;
+    size_t const batch_size = sampling->num_sources > 0 ? sampling->num_sources : SAMPLING_DEFAULT_BATCH;
+    size_t const num_strata = sampling->kind == SAMPLING_DEGREE && sampling->num_strata > 0
+                                  ? (sampling->num_strata < V ? sampling->num_strata : V)
+                                  : 1;
+    SsspOptions options = *sssp;
+    options.threads = *threads;
+    size_t const num_threads = SsspOptions_source_threads(sssp, threads);
+
+    int status = 1;
+    size_t initialized_threads = 0;
+    size_t *order = malloc(V * sizeof(size_t));
+    Stratum *strata = calloc(num_strata, sizeof(Stratum));
+    SampleBatch job = {.graph = graph, .sssp = &options, .first = (size_t)rank, .stride = (size_t)nprocs,
+                       .sources = NULL, .row_sums = NULL,
+                       .distances = calloc(num_threads, sizeof(VecDouble)),
+                       .workspaces = calloc(num_threads, sizeof(SsspWorkspace))};
+    size_t *sources = malloc((batch_size + 2 * num_strata) * sizeof(size_t));
+    size_t *source_strata = malloc((batch_size + 2 * num_strata) * sizeof(size_t));
+    double *row_sums = malloc((batch_size + 2 * num_strata) * sizeof(double));
+    int local_status = order == NULL || strata == NULL || job.distances == NULL || job.workspaces == NULL ||
+                       sources == NULL || source_strata == NULL || row_sums == NULL;
+    for (; local_status == 0 && initialized_threads < num_threads; initialized_threads++)
+    {
+        VecDouble_init(&job.distances[initialized_threads]);
+        SsspWorkspace_init(&job.workspaces[initialized_threads], sssp);
+    }
+    local_status = local_status || __init_strata(graph, sampling, strata, num_strata, order) != 0;
+    if (local_status != 0)
+    {
+        fprintf(stderr, "Falha na alocação da amostragem no processo %d\n", rank);
+    }
+    // os lotes são coletivos: ou todos os processos seguem, ou nenhum
+    MPI_Allreduce(MPI_IN_PLACE, &local_status, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (local_status != 0)
+    {
+        goto clean_up;
+    }
+
+    for (;;)
+    {
+        // alocação proporcional ao tamanho do estrato, com ao menos duas fontes por
+        // estrato para que a variância de cada um possa ser estimada
+        size_t num_sources = 0;
+        for (size_t h = 0; h < num_strata; h++)
+        {
+            Stratum *stratum = &strata[h];
+            size_t wanted = (batch_size * stratum->population + V - 1) / V;
+            wanted = wanted < 2 ? 2 : wanted;
+            size_t const remaining = stratum->population - stratum->next;
+            for (size_t i = 0; i < wanted && i < remaining; i++)
+            {
+                sources[num_sources] = stratum->vertices[stratum->next++];
+                source_strata[num_sources++] = h;
+            }
+        }
+        if (num_sources == 0)
+        {
+            break; // todas as fontes já foram resolvidas: o resultado é exato
+        }
+
+        memset(row_sums, 0, num_sources * sizeof(double));
+        job.sources = sources;
+        job.row_sums = row_sums;
+        job.num_sources = num_sources;
+        local_status = __run_sample_batch(&job, threads, num_threads);
+        MPI_Allreduce(MPI_IN_PLACE, &local_status, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        if (local_status != 0)
+        {
+            goto clean_up;
+        }
+        // cada posição é preenchida por um único processo: a soma apenas as reúne
+        MPI_Allreduce(MPI_IN_PLACE, row_sums, (int)num_sources, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        for (size_t i = 0; i < num_sources; i++)
+        {
+            VecDouble_push_back(&strata[source_strata[i]].samples, row_sums[i]);
+        }
+
+        __estimate(strata, num_strata, V, z, estimate);
+        if (!adaptive || estimate->half_width <= sampling->target_relative_error * estimate->efficiency)
+        {
+            break;
+        }
+    }
+    status = 0;
+
+clean_up:
+    for (size_t t = 0; t < initialized_threads; t++)
+    {
+        VecDouble_free(&job.distances[t]);
+        SsspWorkspace_free(&job.workspaces[t]);
+    }
+    for (size_t h = 0; strata != NULL && h < num_strata; h++)
+    {
+        VecDouble_free(&strata[h].samples);
+    }
+    free(job.distances);
+    free(job.workspaces);
+    free(strata);
+    free(order);
+    free(sources);
+    free(source_strata);
+    free(row_sums);
+    return status;
+}
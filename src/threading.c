@@ -0,0 +1,184 @@
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "threading.h"
+
+void ThreadConfig_init(ThreadConfig *config)
+{
+    config->backend = THREADS_C11;
+    config->num_threads = 1;
+    config->chunk_size = 1;
+    config->schedule = SCHEDULE_WORK_STEALING;
+    config->pinning = PIN_NONE;
+}
+
+// valores negativos, com texto sobrando ou fora de [1, max] são ignorados
+static size_t __env_size(char const *name, size_t max, size_t fallback)
+{
+    char const *value = getenv(name);
+    if (value == NULL)
+    {
+        return fallback;
+    }
+    char *end;
+    errno = 0;
+    unsigned long long const parsed = strtoull(value, &end, 10);
+    if (*value < '0' || *value > '9' || *end != '\0' || errno == ERANGE || parsed == 0 || parsed > max)
+    {
+        fprintf(stderr, "Aviso: valor inválido em %s, usando %zu\n", name, fallback);
+        return fallback;
+    }
+    return (size_t)parsed;
+}
+
+void ThreadConfig_from_env(ThreadConfig *config, ThreadBackend backend)
+{
+    ThreadConfig_init(config);
+    config->backend = backend;
+    if (backend == THREADS_C11)
+    {
+        config->num_threads = __env_size("C11_THREADS_NUM_THREADS", THREADS_MAX_THREADS, 1);
+        config->chunk_size = __env_size("C11_THREADS_CHUNK_SIZE", SIZE_MAX, 1);
+    }
+    else
+    {
+#ifdef _OPENMP
+        config->num_threads = (size_t)omp_get_max_threads();
+#else
+        fprintf(stderr, "Aviso: compilado sem OpenMP, usando uma thread\n");
+#endif
+    }
+}
+
+int Barrier_init(Barrier *barrier, size_t num_threads)
+{
+    barrier->num_threads = num_threads;
+    barrier->waiting = 0;
+    barrier->generation = 0;
+    if (mtx_init(&barrier->mutex, mtx_plain) != thrd_success)
+    {
+        return 1;
+    }
+    if (cnd_init(&barrier->condition) != thrd_success)
+    {
+        mtx_destroy(&barrier->mutex);
+        return 1;
+    }
+    return 0;
+}
+
+int Barrier_wait(Barrier *barrier)
+{
+    mtx_lock(&barrier->mutex);
+    size_t const generation = barrier->generation;
+    int last = 0;
+    if (++barrier->waiting == barrier->num_threads)
+    {
+        barrier->waiting = 0;
+        barrier->generation++;
+        cnd_broadcast(&barrier->condition);
+        last = 1;
+    }
+    else
+    {
+        while (generation == barrier->generation)
+        {
+            cnd_wait(&barrier->condition, &barrier->mutex);
+        }
+    }
+    mtx_unlock(&barrier->mutex);
+    return last;
+}
+
+void Barrier_destroy(Barrier *barrier)
+{
+    cnd_destroy(&barrier->condition);
+    mtx_destroy(&barrier->mutex);
+}
+
+typedef struct
+{
+    int (*fn)(void *arg, size_t thread_id);
+    void *arg;
+    size_t thread_id;
+} ThreadStart;
+
+static int __thread_start(void *arg)
+{
+    ThreadStart const *start = arg;
+    return start->fn(start->arg, start->thread_id);
+}
+
+static int __run_c11_threads(size_t num_threads, int (*fn)(void *arg, size_t thread_id), void *arg)
+{
+    if (num_threads <= 1)
+    {
+        return fn(arg, 0);
+    }
+    // todas as threads precisam existir: as barreiras contam com num_threads participantes,
+    // então sem alguma delas não há como continuar
+    thrd_t *threads = malloc(num_threads * sizeof(thrd_t));
+    ThreadStart *starts = malloc(num_threads * sizeof(ThreadStart));
+    if (threads == NULL || starts == NULL)
+    {
+        fprintf(stderr, "Falha na alocação das threads\n");
+        abort();
+    }
+    for (size_t t = 1; t < num_threads; t++)
+    {
+        starts[t] = (ThreadStart){.fn = fn, .arg = arg, .thread_id = t};
+        if (thrd_create(&threads[t], __thread_start, &starts[t]) != thrd_success)
+        {
+            fprintf(stderr, "Falha ao criar a thread %zu\n", t);
+            abort();
+        }
+    }
+    int status = fn(arg, 0);
+    for (size_t t = 1; t < num_threads; t++)
+    {
+        int thread_status = 0;
+        thrd_join(threads[t], &thread_status);
+        status |= thread_status;
+    }
+    free(threads);
+    free(starts);
+    return status;
+}
+
+int run_threads(ThreadConfig const *config, size_t num_threads, int (*fn)(void *arg, size_t thread_id), void *arg)
+{
+    if (num_threads <= 1)
+    {
+        return fn(arg, 0);
+    }
+    if (config->backend == THREADS_OPENMP)
+    {
+#ifdef _OPENMP
+        size_t team_size = 0;
+        int status = 0;
+#pragma omp parallel num_threads(num_threads) reduction(| : status)
+        {
+#pragma omp single
+            team_size = (size_t)omp_get_num_threads();
+            if (team_size == num_threads)
+            {
+                status = fn(arg, (size_t)omp_get_thread_num());
+            }
+        }
+        if (team_size == num_threads)
+        {
+            return status;
+        }
+        fprintf(stderr, "Aviso: o OpenMP criou %zu de %zu threads, usando threads C11\n", team_size, num_threads);
+#else
+        fprintf(stderr, "Aviso: compilado sem OpenMP, usando threads C11\n");
+#endif
+    }
+    return __run_c11_threads(num_threads, fn, arg);
+}
@@ -0,0 +1,331 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include <mpi.h>
+#include "work_stealing.h"
+#include "threading.h"
+
+int TaskDeque_init(TaskDeque *deque, size_t capacity)
+{
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    deque->capacity = capacity > 0 ? capacity : 1;
+    deque->tasks = malloc(deque->capacity * sizeof(atomic_size_t));
+    if (deque->tasks == NULL)
+    {
+        return 1;
+    }
+    for (size_t i = 0; i < deque->capacity; i++)
+    {
+        atomic_init(&deque->tasks[i], 0);
+    }
+    return 0;
+}
+
+int TaskDeque_push(TaskDeque *deque, size_t task)
+{
+    long long const bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long long const top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if ((size_t)(bottom - top) >= deque->capacity)
+    {
+        return 1;
+    }
+    atomic_store_explicit(&deque->tasks[(size_t)bottom % deque->capacity], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return 0;
+}
+
+int TaskDeque_pop(TaskDeque *deque, size_t *task)
+{
+    long long const bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    if (top > bottom)
+    {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return 1;
+    }
+    *task = atomic_load_explicit(&deque->tasks[(size_t)bottom % deque->capacity], memory_order_relaxed);
+    if (top < bottom)
+    {
+        return 0;
+    }
+    // última tarefa: disputa com os ladrões pelo topo
+    int const won = atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                            memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return won ? 0 : 1;
+}
+
+StealResult TaskDeque_steal(TaskDeque *deque, size_t *task)
+{
+    long long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long const bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom)
+    {
+        return STEAL_EMPTY;
+    }
+    *task = atomic_load_explicit(&deque->tasks[(size_t)top % deque->capacity], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed))
+    {
+        return STEAL_CONFLICT;
+    }
+    return STEAL_SUCCESS;
+}
+
+void TaskDeque_free(TaskDeque *deque)
+{
+    free(deque->tasks);
+    deque->tasks = NULL;
+    deque->capacity = 0;
+}
+
+int WorkStealing_init(WorkStealing *ws, size_t num_workers, size_t capacity)
+{
+    ws->num_workers = num_workers > 0 ? num_workers : 1;
+    ws->run_task = NULL;
+    ws->context = NULL;
+    atomic_init(&ws->status, 0);
+    ws->remote = 0;
+    ws->comm = MPI_COMM_NULL;
+    ws->window = MPI_WIN_NULL;
+    ws->next_shared = NULL;
+    ws->shared_end = NULL;
+    ws->remote_chunk = 1;
+    ws->remote_task = NULL;
+    atomic_init(&ws->remote_exhausted, 0);
+    ws->deques = calloc(ws->num_workers, sizeof(TaskDeque));
+    ws->stats = calloc(ws->num_workers, sizeof(WorkStealingStats));
+    if (ws->deques == NULL || ws->stats == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do escalonador\n");
+        free(ws->deques);
+        free(ws->stats);
+        ws->deques = NULL;
+        ws->stats = NULL;
+        return 1;
+    }
+    for (size_t w = 0; w < ws->num_workers; w++)
+    {
+        if (TaskDeque_init(&ws->deques[w], capacity) != 0)
+        {
+            fprintf(stderr, "Falha na alocação do deque do worker %zu\n", w);
+            for (size_t i = 0; i < w; i++)
+            {
+                TaskDeque_free(&ws->deques[i]);
+            }
+            free(ws->deques);
+            free(ws->stats);
+            ws->deques = NULL;
+            ws->stats = NULL;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int WorkStealing_push(WorkStealing *ws, size_t worker, size_t task)
+{
+    if (TaskDeque_push(&ws->deques[worker % ws->num_workers], task) != 0)
+    {
+        fprintf(stderr, "Erro: deque do worker %zu cheio\n", worker % ws->num_workers);
+        return 1;
+    }
+    return 0;
+}
+
+int WorkStealing_enable_remote(WorkStealing *ws, MPI_Comm comm, size_t first_shared, size_t num_tasks,
+                               size_t chunk, RemoteTaskFunction remote_task)
+{
+    int nprocs;
+    MPI_Comm_size(comm, &nprocs);
+    ws->comm = comm;
+    ws->remote_chunk = chunk > 0 ? chunk : 1;
+    ws->remote_task = remote_task;
+    if (ws->remote_chunk + 1 > ws->deques[0].capacity)
+    {
+        // os blocos obtidos da janela vão para o deque da thread 0 quando lhe resta no
+        // máximo uma tarefa
+        TaskDeque_free(&ws->deques[0]);
+        if (TaskDeque_init(&ws->deques[0], ws->remote_chunk + 1) != 0)
+        {
+            fprintf(stderr, "Falha na alocação do deque do worker 0\n");
+            return 1;
+        }
+    }
+    ws->shared_end = malloc(nprocs * sizeof(long long));
+    if (ws->shared_end == NULL)
+    {
+        fprintf(stderr, "Falha na alocação do escalonador\n");
+        return 1;
+    }
+    long long const end = (long long)num_tasks;
+    MPI_Allgather(&end, 1, MPI_LONG_LONG, ws->shared_end, 1, MPI_LONG_LONG, comm);
+
+    MPI_Win_allocate(sizeof(long long), sizeof(long long), MPI_INFO_NULL, comm, &ws->next_shared, &ws->window);
+    *ws->next_shared = (long long)(first_shared < num_tasks ? first_shared : num_tasks);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, ws->window);
+    MPI_Barrier(comm);
+    ws->remote = 1;
+    return 0;
+}
+
+// xorshift; escolhe a primeira vítima de cada rodada de roubo
+static size_t __next_random(uint32_t *seed)
+{
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+// retorna 1 se roubou uma tarefa e 0 se todos os outros deques estavam vazios
+static int __steal_local(WorkStealing *ws, size_t worker, size_t *task, uint32_t *seed)
+{
+    size_t const n = ws->num_workers;
+    if (n == 1)
+    {
+        return 0;
+    }
+    int conflict;
+    do
+    {
+        conflict = 0;
+        size_t const first = __next_random(seed) % n;
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t const victim = (first + i) % n;
+            if (victim == worker)
+            {
+                continue;
+            }
+            StealResult const result = TaskDeque_steal(&ws->deques[victim], task);
+            if (result == STEAL_SUCCESS)
+            {
+                ws->stats[worker].local_steals++;
+                return 1;
+            }
+            conflict |= result == STEAL_CONFLICT;
+        }
+    } while (conflict);
+    return 0;
+}
+
+// Thread 0: obtém um bloco de índices compartilhados, primeiro do próprio processo e
+// depois dos demais. shared_end[p] = 0 marca o processo p como esgotado.
+static int __claim_remote(WorkStealing *ws)
+{
+    int rank, nprocs;
+    MPI_Comm_rank(ws->comm, &rank);
+    MPI_Comm_size(ws->comm, &nprocs);
+    long long const chunk = (long long)ws->remote_chunk;
+    for (int i = 0; i < nprocs; i++)
+    {
+        int const victim = (rank + i) % nprocs;
+        if (ws->shared_end[victim] == 0)
+        {
+            continue;
+        }
+        long long begin;
+        MPI_Fetch_and_op(&chunk, &begin, MPI_LONG_LONG, victim, 0, MPI_SUM, ws->window);
+        MPI_Win_flush(victim, ws->window);
+        if (begin >= ws->shared_end[victim])
+        {
+            ws->shared_end[victim] = 0;
+            continue;
+        }
+        long long const end = begin + chunk < ws->shared_end[victim] ? begin + chunk : ws->shared_end[victim];
+        for (long long index = begin; index < end; index++)
+        {
+            // o deque 0 tem no máximo uma tarefa e comporta mais um bloco inteiro
+            TaskDeque_push(&ws->deques[0], ws->remote_task(ws->context, victim, (size_t)index));
+        }
+        ws->stats[0].remote_claims++;
+        ws->stats[0].remote_steals += victim != rank;
+        return 1;
+    }
+    return 0;
+}
+
+// apenas o dono; os ladrões só podem diminuir o valor lido
+static size_t __deque_size(TaskDeque *deque)
+{
+    long long const bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long long const top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    return bottom > top ? (size_t)(bottom - top) : 0;
+}
+
+static int __work_stealing_worker(void *arg, size_t worker)
+{
+    WorkStealing *ws = arg;
+    uint32_t seed = (uint32_t)(worker * 2654435761u) | 1u;
+    size_t task;
+    for (;;)
+    {
+        // A thread 0 reabastece o próprio deque antes de desempilhar a última tarefa, para
+        // que as demais tenham o que roubar enquanto ela executa uma fonte.
+        if (worker == 0 && ws->remote && !atomic_load(&ws->remote_exhausted) &&
+            __deque_size(&ws->deques[0]) <= 1 && !__claim_remote(ws))
+        {
+            atomic_store(&ws->remote_exhausted, 1);
+        }
+        if (TaskDeque_pop(&ws->deques[worker], &task) == 0 || __steal_local(ws, worker, &task, &seed))
+        {
+            // após um erro as tarefas restantes são apenas descartadas
+            if (atomic_load_explicit(&ws->status, memory_order_relaxed) == 0 &&
+                ws->run_task(ws->context, worker, task) != 0)
+            {
+                atomic_store(&ws->status, 1);
+            }
+            ws->stats[worker].tasks_run++;
+            continue;
+        }
+        // tarefas não geram novas tarefas: deques vazios só voltam a receber trabalho da janela
+        if (!ws->remote || atomic_load(&ws->remote_exhausted))
+        {
+            break;
+        }
+        // a thread 0 só chega aqui se o bloco que acabou de obter foi todo roubado
+        thrd_yield();
+    }
+    return 0;
+}
+
+int WorkStealing_run(WorkStealing *ws, ThreadConfig const *threads, TaskFunction run_task, void *context)
+{
+    ws->run_task = run_task;
+    ws->context = context;
+    atomic_store(&ws->status, 0);
+    atomic_store(&ws->remote_exhausted, 0);
+    int const status = run_threads(threads, ws->num_workers, __work_stealing_worker, ws);
+    return status | atomic_load(&ws->status);
+}
+
+void WorkStealing_free(WorkStealing *ws)
+{
+    if (ws->remote)
+    {
+        MPI_Win_unlock_all(ws->window);
+        MPI_Win_free(&ws->window);
+        ws->remote = 0;
+    }
+    for (size_t w = 0; ws->deques != NULL && w < ws->num_workers; w++)
+    {
+        TaskDeque_free(&ws->deques[w]);
+    }
+    free(ws->deques);
+    free(ws->stats);
+    free(ws->shared_end);
+    ws->deques = NULL;
+    ws->stats = NULL;
+    ws->shared_end = NULL;
+}
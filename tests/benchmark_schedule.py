@@ -0,0 +1,89 @@
+from pathlib import Path
+import os
+import random
+import shlex
+import subprocess
+import sys
+import tempfile
+
+# Compara os escalonamentos das fontes do Dijkstra (--schedule) em um grafo assimétrico:
+# as primeiras fontes pertencem a uma grande componente fortemente conexa e as demais
+# param depois de poucos vértices, então uma divisão estática deixa threads ociosas.
+# Uso: benchmark_schedule.py [saída.csv]; sem argumento o CSV vai para um diretório
+# temporário, impresso no final. O mpirun pode ser trocado pela variável MPIRUN.
+
+SCHEDULES = ["static", "dynamic", "work-stealing", "work-stealing-mpi"]
+# só dynamic e work-stealing-mpi usam C11_THREADS_CHUNK_SIZE; os demais rodam uma vez
+CHUNK_SIZES = [1, 4, 16, 64]
+CHUNKED_SCHEDULES = {"dynamic", "work-stealing-mpi"}
+
+
+def write_skewed_graph(path: Path, V: int, core_fraction: float, seed: int):
+    rng = random.Random(seed)
+    core = int(V * core_fraction)
+    edges = {}
+    for i in range(core):  # ciclo + arestas aleatórias: componente fortemente conexa
+        edges[(i, (i + 1) % core)] = rng.uniform(1, 10)
+        for _ in range(8):
+            edges[(i, rng.randrange(core))] = rng.uniform(1, 10)
+    for i in range(core, V):  # cadeias curtas que terminam logo
+        if (i - core) % 4 != 3 and i + 1 < V:
+            edges[(i, i + 1)] = rng.uniform(1, 10)
+    edges = {e: w for e, w in edges.items() if e[0] != e[1]}
+    with open(path, "w") as f:
+        f.write(f"{V} {len(edges)}\n")
+        for (u, v), w in edges.items():
+            f.write(f"{u} {v} {w:.3f}\n")
+
+
+def read_labels(output: str) -> dict:
+    values = {}
+    for line in output.split('\n'):
+        label, separator, value = line.partition(': ')
+        if separator and value.split():
+            values[label.strip()] = float(value.split()[0])
+    return values
+
+
+def run(mpirun: list, c_binary: Path, graph_file: Path, schedule: str, chunk_size: int, num_threads: int,
+        num_procs: int):
+    command = [str(c_binary), str(graph_file), "--engine=dijkstra",
+               f"--threads={num_threads}", f"--schedule={schedule}"]
+    if num_procs > 1:
+        command = mpirun + ["-np", str(num_procs)] + command
+    env = dict(os.environ, C11_THREADS_CHUNK_SIZE=str(chunk_size))
+    result = subprocess.run(command, capture_output=True, text=True, check=True, env=env,
+                            stdin=subprocess.DEVNULL)
+    values = read_labels(result.stdout)
+    return values["MyCode(time)"], values["Efficiency"]
+
+
+def main():
+    c_binary = Path(__file__).parent.parent / "build" / "main_cli"
+    if not os.path.exists(c_binary):
+        c_binary = Path(input("C binary not found. Please provide the path to the compiled C binary: "))
+    mpirun = shlex.split(os.environ.get("MPIRUN", "mpirun --oversubscribe"))
+    if len(sys.argv) > 1:
+        output_file = Path(sys.argv[1])
+    else:
+        output_file = Path(tempfile.mkdtemp(prefix="schedule_benchmark_")) / "schedule_benchmark.csv"
+
+    with tempfile.TemporaryDirectory() as graph_dir, open(output_file, "w") as f:
+        graph_file = Path(graph_dir) / "skewed_20000.net"
+        write_skewed_graph(graph_file, 20000, 0.2, 42)
+        f.write("graph_file,repetition,num_procs,cpu_cores,schedule,chunk_size,execution_time,efficiency\n")
+        for i in range(5):
+            for num_procs in [1, 2]:
+                for num_cores in range(1, os.cpu_count() + 1):
+                    for schedule in SCHEDULES:
+                        for chunk_size in CHUNK_SIZES if schedule in CHUNKED_SCHEDULES else [1]:
+                            time, efficiency = run(mpirun, c_binary, graph_file, schedule, chunk_size,
+                                                   num_cores, num_procs)
+                            f.write(f"{graph_file.name},{i},{num_procs},{num_cores},{schedule},{chunk_size},"
+                                    f"{time},{efficiency}\n")
+                            f.flush()
+    print(f"Resultados em {output_file}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,73 @@
+from pathlib import Path
+import os
+import random
+import shlex
+import subprocess
+import sys
+import tempfile
+
+# Compara a eficiência dos engines 1D com cada --partition contra a execução com um
+# processo, com número de processos que não divide V e com mais processos que vértices
+# (processos sem linhas). O mpirun pode ser trocado pela variável MPIRUN, por exemplo
+# MPIRUN="mpirun --oversubscribe".
+
+VERTEX_COUNTS = [1, 2, 3, 5, 7, 10, 13]
+MAX_PROCESSES = 9
+PARTITIONS = [["--partition=block"], ["--partition=cyclic"]] + \
+             [["--partition=block-cyclic", f"--tile-size={b}"] for b in (1, 2, 3)]
+ENGINES = ["fw-1d", "fw-pipelined"]
+# a eficiência é impressa com 8 casas
+TOLERANCE = 1e-8
+
+
+def write_graph(path: Path, V: int, seed: int):
+    rng = random.Random(seed)
+    edges = []
+    for _ in range(3 * V):
+        a, b = rng.randrange(V), rng.randrange(V)
+        if a != b:
+            edges.append((a, b, round(rng.uniform(0.1, 10), 4)))
+    with open(path, "w") as f:
+        f.write(f"{V} {len(edges)}\n")
+        for a, b, w in edges:
+            f.write(f"{a} {b} {w}\n")
+
+
+def read_efficiency(mpirun: list, c_binary_dir: Path, graph_file: Path, nprocs: int, options: list) -> float:
+    result = subprocess.run(mpirun + ["-np", str(nprocs), c_binary_dir, str(graph_file)] + options,
+                            capture_output=True, text=True, stdin=subprocess.DEVNULL)
+    for line in result.stdout.split('\n'):
+        label, separator, value = line.partition(': ')
+        if separator and label.strip() == "Efficiency":
+            return float(value.split()[0])
+    return float("nan")
+
+
+def main():
+    c_binary_dir = Path(__file__).parent.parent / "build" / "main_cli"
+    if not os.path.exists(c_binary_dir):
+        c_binary_dir = Path(input("C binary not found. Please provide the path to the compiled C binary: "))
+    mpirun = shlex.split(os.environ.get("MPIRUN", "mpirun"))
+
+    failed = False
+    with tempfile.TemporaryDirectory() as graph_dir:
+        for V in VERTEX_COUNTS:
+            graph_file = Path(graph_dir) / f"partition_{V}.net"
+            write_graph(graph_file, V, seed=V)
+            reference = read_efficiency(mpirun, c_binary_dir, graph_file, 1, ["--engine=fw-1d"])
+            for engine in ENGINES:
+                for partition in PARTITIONS:
+                    for nprocs in range(1, MAX_PROCESSES + 1):
+                        efficiency = read_efficiency(mpirun, c_binary_dir, graph_file, nprocs,
+                                                     [f"--engine={engine}"] + partition)
+                        ok = abs(efficiency - reference) <= TOLERANCE
+                        failed = failed or not ok
+                        if not ok:
+                            print(f"FALHOU V={V} np={nprocs} {engine} {' '.join(partition)}: "
+                                  f"{efficiency:.8f} (1 processo: {reference:.8f})")
+            print(f"V={V}: {'ok' if not failed else 'com falhas'}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
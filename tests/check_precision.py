@@ -0,0 +1,35 @@
+from pathlib import Path
+import os
+import subprocess
+import sys
+
+# erro relativo máximo aceito entre as eficiências em float e em double
+TOLERANCE = 1e-5
+
+
+def read_efficiency(c_binary_dir: Path, graph_file: Path, engine: str, precision: str) -> float:
+    subprocess.run([c_binary_dir, str(graph_file), f"--engine={engine}", f"--precision={precision}"],
+                   capture_output=True, text=True, check=True)
+    return float(Path(str(graph_file) + ".eff").read_text())
+
+
+def main():
+    c_binary_dir = Path(__file__).parent.parent / "build" / "main_cli"
+    if not os.path.exists(c_binary_dir):
+        c_binary_dir = Path(input("C binary not found. Please provide the path to the compiled C binary: "))
+
+    graph_tests_dir = Path(sys.argv[1]) if len(sys.argv) > 1 else Path(__file__).parent / "graphs_for_floyd_warshall"
+    failed = False
+    for graph_file in sorted(graph_tests_dir.glob("*.net")):
+        for engine in ["fw-1d", "fw-threads", "fw-blocked"]:
+            double_efficiency = read_efficiency(c_binary_dir, graph_file, engine, "double")
+            float_efficiency = read_efficiency(c_binary_dir, graph_file, engine, "float")
+            error = abs(float_efficiency - double_efficiency) / double_efficiency if double_efficiency else float_efficiency
+            status = "ok" if error <= TOLERANCE else "FALHOU"
+            failed = failed or error > TOLERANCE
+            print(f"{graph_file.name},{engine},{double_efficiency:.8f},{float_efficiency:.8f},{error:.3e},{status}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
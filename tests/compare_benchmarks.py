@@ -0,0 +1,38 @@
+from pathlib import Path
+import json
+import sys
+
+# Compara dois relatórios JSON de "main_cli bench" (por exemplo, de duas versões do código)
+# fase a fase, pela mediana do processo mais lento, e falha se alguma fase ficou mais lenta
+# que a tolerância. Fases abaixo de MIN_SECONDS nas duas versões são ignoradas (ruído).
+
+TOLERANCE = 0.10
+MIN_SECONDS = 1e-3
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(f"uso: {sys.argv[0]} <relatório base.json> <relatório novo.json>")
+        sys.exit(2)
+    base = json.loads(Path(sys.argv[1]).read_text())
+    new = json.loads(Path(sys.argv[2]).read_text())
+    for key in ["graph", "V", "E", "engine", "processes", "threads"]:
+        if base[key] != new[key]:
+            print(f"aviso: {key} difere ({base[key]} vs {new[key]})")
+
+    failed = False
+    print("phase,base_median_s,new_median_s,ratio,status")
+    for phase, base_summary in base["summary"].items():
+        base_median = base_summary["median"]
+        new_median = new["summary"][phase]["median"]
+        if max(base_median, new_median) < MIN_SECONDS:
+            continue
+        ratio = new_median / base_median if base_median > 0 else float("inf")
+        status = "ok" if ratio <= 1 + TOLERANCE else "REGRESSÃO"
+        failed = failed or ratio > 1 + TOLERANCE
+        print(f"{phase},{base_median:.6f},{new_median:.6f},{ratio:.3f},{status}")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -3,23 +3,31 @@ import os
 import subprocess
 from functools import partial 
 
+def parse_output(stdout: str) -> dict:
+    # as linhas "Rótulo: valor [s]" mudam conforme as opções (amostragem, --path, igraph...),
+    # então são lidas pelo rótulo e não pela posição
+    values = {}
+    for line in stdout.strip().split('\n'):
+        label, separator, value = line.partition(': ')
+        if separator:
+            values[label.strip()] = value.split()[0] if value.split() else ''
+    return values
+
+
 def process_single_graph(graph_file: Path, c_binary_dir: Path):
-    result = subprocess.run([c_binary_dir, str(graph_file)], capture_output=True, text=True)
+    result = subprocess.run([c_binary_dir, str(graph_file), "--threads-backend=compare"],
+                            capture_output=True, text=True, check=True)
     print(result.stdout)
-    output_lines = result.stdout.strip().split('\n')
-        
-    efficiency = float(output_lines[0].split(': ')[1])
-    my_code_time = float(output_lines[1].split(': ')[1].split(' ')[0])
-    c11_threads_time = float(output_lines[2].split(': ')[1].split(' ')[0])
-    igraph_time = float(output_lines[3].split(': ')[1].split(' ')[0])
-        
-    speedup = igraph_time / my_code_time 
+    values = parse_output(result.stdout)
+
+    # Igraph(time) só existe quando compilado com COMPARE_WITH_IGRAPH
+    igraph_time = float(values['Igraph(time)']) if 'Igraph(time)' in values else None
     return {
         'graph_file': str(graph_file),
         'igraph_time_s': igraph_time,
-        'my_code_time_s': my_code_time,
-        'c11_threads_time_s': c11_threads_time,
-        'efficiency': efficiency
+        'my_code_time_s': float(values['MyCode(time)']),
+        'c11_threads_time_s': float(values['C11 threads(time)']),
+        'efficiency': float(values['Efficiency'])
     }
 
 